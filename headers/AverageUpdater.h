@@ -0,0 +1,52 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains AverageUpdater class definition.
+ * AverageUpdater computes a copy of an average curve (CurveAverage::update)
+ * in a thread pool, so that resampling and aggregation of the folds do not
+ * block the GUI thread. The owner takes the updated copy when finished
+ * signal is delivered through a queued connection.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QList>
+#include "../headers/CurveAverage.h"
+
+class AverageUpdater : public QObject, public QRunnable
+{
+	Q_OBJECT
+
+public:
+	AverageUpdater(const CurveAverage &_average);
+
+	void run();
+
+	const CurveAverage& getAverage() const;
+	int getError() const;
+
+signals:
+	void finished();
+
+private:
+	CurveAverage average_;
+	int error_;
+};
@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains BatchMetrics class definition.
+ * BatchMetrics measures curve files given on the command line without any
+ * widget, the program only starts QCoreApplication:
+ *
+ *   projekt-zpr --metrics [--format csv|json] [--output file] [--threads n]
+ *     [--list file] [--verify] file|wildcard|directory...
+ *
+ * Directories are searched for curve, score and sketch files with their
+ * subdirectories. Files are loaded by CurveData in the same way as curves of
+ * plots, but without quantization and pyramids, and only their AUC and
+ * operating points are kept. Checksums of binary files are verified only
+ * with --verify. Files are measured on the global thread pool in
+ * chunks; every task holds one file at a time and a chunk is written while
+ * the next one is measured, so results stream out in the order of files.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QFile>
+#include "../headers/Metrics.h"
+
+/**
+ * Measures of one curve, a row of the output
+ */
+struct MetricsRow {
+	QString path;
+	QString curve;						///< "roc" or "pr"
+	quint64 points;
+	double auc;
+	double aucError;
+	OperatingPoints operating;
+	QString error;
+};
+
+/**
+ * Input file with the rows measured from it, score files give both curves
+ */
+struct MetricsTask {
+	QString path;
+	QVector<MetricsRow> rows;
+};
+
+class BatchMetrics {
+
+public:
+	enum Format { CsvFormat = 0, JsonFormat = 1 };
+	enum { FILES_PER_THREAD = 64 };
+
+	static bool isMetricsCommand(int _argc, char *_argv[]);
+	static QString usage();
+
+	BatchMetrics(const QStringList &_arguments);
+	int run();
+
+private:
+	void addFiles(QString _argument);
+	static bool isMeasured(QString _path);
+	void writeHeader();
+	void writeRows(QVector<MetricsTask> &_tasks);
+	void writeRow(const MetricsRow &_row);
+	void writeFooter();
+
+	int format;
+	QStringList files;
+	QFile output;
+	bool firstRow;
+	bool failed;
+};
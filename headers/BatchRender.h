@@ -0,0 +1,96 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains BatchRender class definition.
+ * BatchRender renders plots given on the command line to files, without
+ * showing a window:
+ *
+ *   projekt-zpr --render [--type roc|pr] [--title text] [--xlabel text]
+ *     [--ylabel text] [--grid] [--size WxH] [--format png|svg|pdf|ps|...]
+ *     [--output dir] [--threads n] [--list file] plot...
+ *
+ * Every plot is a comma separated list of files or wildcards, --list reads
+ * one plot from every line of a file. Files are loaded by worker threads.
+ * Qt widgets live only in the GUI thread, so there the plot is laid out and
+ * recorded by QwtPlotRenderer into a QPicture; workers then replay pictures
+ * into their own QImage, QSvgGenerator or QPrinter and write the files.
+ * Plots are processed in chunks, so that loading of a chunk overlaps with
+ * painting of the previous one and memory stays bounded.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QSize>
+#include <QPicture>
+#include <QSharedPointer>
+#include "../headers/CurveData.h"
+
+/**
+ * Options shared by all plots of a batch
+ */
+struct RenderOptions {
+	int type;
+	QString title;
+	QString xLabel;
+	QString yLabel;
+	bool grid;
+	QSize size;
+	QString format;
+	QString directory;
+};
+
+/**
+ * One plot of a batch, from its files to the written image
+ */
+struct RenderJob {
+	QString spec;						///< plot as given on the command line
+	QStringList files;
+	QString output;
+	QList<QSharedPointer<CurveData> > curves;
+	QPicture picture;					///< plot recorded in the GUI thread
+	QStringList errors;
+	bool written;
+	const RenderOptions *options;
+};
+
+class BatchRender {
+
+public:
+	enum { JOBS_PER_THREAD = 2 };
+
+	static bool isRenderCommand(const QStringList &_arguments);
+	static QString usage();
+
+	BatchRender(const QStringList &_arguments);
+	int run();
+
+private:
+	void addPlot(QString _spec);
+	QStringList expand(QString _spec) const;
+	QString outputName(QString _spec);
+	void record(RenderJob &_job) const;
+
+	RenderOptions options;
+	QVector<RenderJob> jobs;
+	QStringList outputs;
+};
@@ -0,0 +1,102 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains the binary curve format (.rocb, .prb).
+ * A file consists of a fixed BinaryCurveHeader followed by x, y pairs
+ * stored as contiguous doubles or floats in native byte order, then by
+ * the operating points of the curve and the levels of its CurvePyramid.
+ * BinaryCurveFile memory maps such a file, MappedFunctionData
+ * gives Qwt access to the mapped samples without any parsing. Everything
+ * computed from the samples is stored at conversion, so opening a file
+ * does not read its samples; the checksum is verified only on demand.
+ */
+
+#pragma once
+
+#include <qwt_series_data.h>
+#include <QFile>
+#include <QString>
+#include <QPointF>
+#include <QRectF>
+#include <QVector>
+#include <QSharedPointer>
+#include "../headers/FunctionData.h"
+#include "../headers/CurvePyramid.h"
+#include "../headers/Metrics.h"
+
+class LoadObserver;
+
+/**
+ * Header of a binary curve file
+ */
+struct BinaryCurveHeader {
+	char magic[4];			///< "ZPRC"
+	quint32 version;		///< format version, currently 2
+	quint32 flags;			///< FloatSamples if samples are stored as floats, MonotoneSamples if x does not decrease
+	quint32 reserved;
+	quint64 count;			///< number of points
+	double left;			///< bounding rect of the points
+	double top;
+	double right;
+	double bottom;
+	double auc;				///< area under the curve
+	quint64 checksum;		///< checksum of everything following the header
+};
+
+class BinaryCurveFile {
+
+public:
+	enum { FloatSamples = 1, MonotoneSamples = 2 };
+	enum { VERSION = 2 };
+
+	BinaryCurveFile(QString _path);
+	~BinaryCurveFile();
+
+	void open();
+	void verify(LoadObserver *_observer = 0) const;
+	size_t size() const;
+	QPointF sample(size_t i) const;
+	QRectF boundingRect() const;
+	double getAUC() const;
+	bool isMonotone() const;
+	OperatingPoints getOperatingPoints() const;
+	void mapPyramid(CurvePyramid &_pyramid) const;
+
+	static void convert(QString _source, QString _target, bool _floatSamples = false);
+	static quint64 checksum(const uchar *_data, qint64 _size, quint64 _seed = Q_UINT64_C(0xcbf29ce484222325));
+
+private:
+	QFile file;
+	const BinaryCurveHeader *header;
+	const double *doubles;
+	const float *floats;
+	const uchar *summary;
+	qint64 summarySize;
+};
+
+class MappedFunctionData: public FunctionData {
+
+public:
+	MappedFunctionData(QSharedPointer<BinaryCurveFile> _file, bool _monotone = false);
+	QPointF sample(size_t i) const;
+	size_t size() const;
+
+private:
+	QSharedPointer<BinaryCurveFile> file;
+};
@@ -0,0 +1,95 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains Bootstrap class definition.
+ * Bootstrap computes confidence intervals of AUC and confidence bands of
+ * a curve built from a score file. Replicates resample positive and negative
+ * examples separately (stratified bootstrap). Examples are sorted once, a
+ * replicate only counts how many times every example was drawn and walks
+ * the sorted examples, so it takes O(n). Replicates run in rounds on the
+ * global thread pool, every replicate draws from its own random stream,
+ * so results do not depend on the number of threads. Intervals computed
+ * from the finished replicates are published after every round.
+ *
+ * Memory: besides a copy of labels, weights and positions of the n examples
+ * (at most 17 bytes per example), every thread keeps one byte of draw counts per example.
+ * Counts which do not fit in a byte are kept aside, so they stay exact.
+ * The number of threads is limited so that draw counts of all threads take at most
+ * COUNTS_BUDGET bytes, one thread is always used, so they take max(n, COUNTS_BUDGET)
+ * bytes at most.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QMutex>
+#include <QVector>
+#include <QSharedPointer>
+#include <qwt_series_data.h>
+#include "../headers/ScoreSet.h"
+
+/**
+ * Confidence intervals computed from the replicates finished so far
+ */
+struct BootstrapResult {
+	int replicates;							///< number of finished replicates
+	double aucLow;							///< confidence interval of AUC
+	double aucHigh;
+	QVector<QwtIntervalSample> band;		///< confidence band of the curve
+};
+
+class Bootstrap : public QObject, public QRunnable
+{
+	Q_OBJECT
+
+public:
+	enum { GRID_POINTS = 201, ROUND_REPLICATES = 64, DEFAULT_REPLICATES = 2000 };
+	enum { COUNTS_BUDGET = 256 * 1024 * 1024 };
+
+	Bootstrap(QSharedPointer<ScoreSet> _scores, int _type, int _replicates = DEFAULT_REPLICATES,
+		double _level = 0.95, quint64 _seed = 1);
+
+	void run();
+	void cancel();
+	BootstrapResult result();
+
+	void setCurveId(int);
+	int getCurveId();
+
+signals:
+	void progressChanged(int, int);
+	void finished();
+
+private:
+	void publish(int _replicates);
+
+	QSharedPointer<ScoreSet> scores_;
+	int type_;
+	int replicates_;
+	double level_;
+	quint64 seed_;
+	int curveId_;
+	QVector<double> aucs_;
+	QVector<double> rows_;
+	QMutex mutex_;
+	BootstrapResult result_;
+	QAtomicInt cancelled_;
+};
@@ -20,7 +20,8 @@
  * This header file contains Curve class definition.
  * Curve class derives from QwtPlotCurve class.
  * It provides an access to some of QwtPlotCurve methods
- * and some other features which are not provided by QwtPlotCurve
+ * and some other features which are not provided by QwtPlotCurve.
+ * Large curves are drawn through the min/max pyramid of their data.
  *
  */
 
@@ -28,6 +29,8 @@
 
 #include <qwt_plot_curve.h>
 #include <QColor>
+#include <QSharedPointer>
+#include "../headers/CurveData.h"
 
 class QwtPlotCurve;
 class QColor;
@@ -35,34 +38,50 @@ class QColor;
 class Curve : QwtPlotCurve {
 
 public:
-	Curve() { ++id_; }
-	Curve(double _auc) : auc_(_auc) { ++id_; }
+	Curve() : auc_(0.0), aucError_(0.0), attached_(false), uid_(++id_) { }
+	Curve(double _auc) : auc_(_auc), aucError_(0.0), attached_(false), uid_(++id_) { }
 	Curve(const QwtText&);
 
 	using QwtPlotCurve::setRenderHint;
 	using QwtPlotCurve::setPen;
     using QwtPlotCurve::attach;
 	using QwtPlotCurve::setData;
+	using QwtPlotCurve::data;
 	using QwtPlotCurve::setVisible;
 	using QwtPlotCurve::title;
 	using QwtPlotCurve::setTitle;
 
 	void init(double, QColor);
+	void setAUCError(double);
+	void setOperatingPoints(const OperatingPoints&);
 	void setAttached(bool);
-	void setIndex(int);
+	void setColor(QColor);
+	void setCurveData(QSharedPointer<CurveData>);
+	QSharedPointer<CurveData> releaseCurveData();
+	QSharedPointer<CurveData> getCurveData();
 
 	double getAUC();
+	double getAUCError();
+	OperatingPoints getOperatingPoints();
 	QColor getColor();
 	QwtText getTitle();
 	bool isAttached();
-	int getIndex();
+	int getId();
+	QwtPlotItem* plotItem();
+	QwtPlotAbstractSeriesItem* seriesItem();
+
+protected:
+	virtual void drawSeries(QPainter*, const QwtScaleMap&, const QwtScaleMap&, const QRectF&, int, int) const;
 
 private:
 
 	static int id_;
 	double auc_;				//pole pod krzyw
+	double aucError_;			//largest error of auc_
+	OperatingPoints operating_;	//operating points found at load time
 	QColor color_;
 	bool attached_;
-	int index_;
+	int uid_;
+	QSharedPointer<CurveData> data_;
 };
 
@@ -0,0 +1,92 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains CurveAverage class definition.
+ * CurveAverage averages curves of cross-validation folds into one mean curve
+ * with a band showing their spread (Fawcett, "An introduction to ROC analysis").
+ * Vertical averaging resamples every fold onto a common x grid with linear
+ * interpolation (Metrics::interpolate). Threshold averaging takes the point
+ * of every fold at common score thresholds and averages both coordinates,
+ * so it needs folds built from score files. Folds are prepared in parallel
+ * when they are added; adding or removing a fold does not touch the others
+ * in vertical averaging. Points of a fold are released once it is prepared.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+#include <qwt_series_data.h>
+#include "../headers/ScoreSet.h"
+
+/**
+ * Fold of the average: its curve, its examples and its values on the common grid
+ */
+struct AverageFold {
+	QVector<QPointF> points;			///< curve of the fold, released once the fold is prepared
+	QSharedPointer<ScoreSet> scores;
+	QVector<float> sorted;				///< scores in descending order
+	QVector<double> hits;				///< weight of positive examples among the first k sorted
+	QVector<double> misses;				///< weight of negative examples among the first k sorted
+	QVector<double> x;					///< fold on the common grid
+	QVector<double> y;
+};
+
+class CurveAverage {
+
+public:
+	enum Mode { VerticalAveraging = 0, ThresholdAveraging = 1 };
+	enum Band { MinMaxBand = 0, DeviationBand = 1 };
+	enum { GRID_POINTS = 201 };
+
+	CurveAverage(int _type);
+
+	void setMode(int _mode, int _band);
+	int getMode() const;
+	void add(int _id, const QVector<QPointF> &_points, QSharedPointer<ScoreSet> _scores);
+	void remove(int _id);
+	void clear();
+	bool contains(int _id) const;
+	int size() const;
+	QList<int> ids() const;
+	void update();
+	const QList<int>& getDropped() const;
+
+	const QVector<QPointF>& getMean() const;
+	const QVector<QwtIntervalSample>& getBand() const;
+	double getAUC() const;
+
+private:
+	void computeThresholds();
+	void aggregate();
+
+	int type;
+	int mode;
+	int band;
+	QHash<int, AverageFold> folds;
+	QHash<int, AverageFold> pending;
+	QList<int> dropped;
+	QVector<double> thresholds;
+	QVector<QPointF> mean;
+	QVector<QwtIntervalSample> spread;
+	double auc;
+};
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains CurveBuilder class definition.
+ * CurveBuilder turns weighted examples given in order of descending score
+ * into ROC and PR curves and the exact area under the ROC curve. It is used
+ * by ScoreSet for score files and by ScoreSketch for histograms of scores.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+#include "../headers/Metrics.h"
+
+class CurveBuilder {
+
+public:
+	CurveBuilder(double _positives, double _negatives, double _tolerance = 0.0);
+
+	void add(float _score, bool _positive, double _weight);
+	double finish();
+
+	QVector<QPointF> roc;
+	QVector<QPointF> pr;
+
+private:
+	///direction of the last segment added to a curve
+	enum { NoRun, VerticalRun, HorizontalRun, DiagonalRun };
+
+	void closeGroup();
+	void appendPoint(QVector<QPointF> &_curve, const QPointF &_point, int &_run, int _direction);
+
+	double positives;
+	double negatives;
+	double tolerance;
+	double tp;
+	double fp;
+	double groupTp;
+	double groupFp;
+	float groupScore;
+	bool group;
+	int rocRun;
+	int prRun;
+	CompensatedSum area;
+};
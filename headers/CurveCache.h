@@ -0,0 +1,68 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains CurveCache class definition.
+ * CurveCache is a process wide cache of loaded curve data keyed by file
+ * identity (canonical path, size and modification time). All plots share
+ * one copy of every file. Data of detached curves is retained on an LRU
+ * basis as long as the total memory stays within a configurable budget.
+ * Examples of a score file are shared by its ROC and PR curves.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QList>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QSharedPointer>
+#include <QWeakPointer>
+#include "../headers/CurveData.h"
+#include "../headers/ScoreSet.h"
+
+class LoadObserver;
+
+class CurveCache {
+
+public:
+	static CurveCache* instance();
+	static QString identity(QString _path);
+
+	QSharedPointer<CurveData> acquire(QString _path, LoadObserver *_observer = 0);
+	void retain(QSharedPointer<CurveData> _data);
+	QSharedPointer<ScoreSet> acquireScores(QString _path, LoadObserver *_observer = 0);
+
+	void setBudget(qint64 _bytes);
+	qint64 getBudget();
+	qint64 memoryUsage();
+
+private:
+	CurveCache();
+	qint64 usage();
+	void evict();
+
+	QMutex mutex;
+	QWaitCondition loaded;
+	QHash<QString, QWeakPointer<CurveData> > entries;
+	QHash<QString, QWeakPointer<ScoreSet> > scoreEntries;
+	QSet<QString> loading;
+	QList<QSharedPointer<CurveData> > retained;
+	qint64 budget;
+};
@@ -0,0 +1,90 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains CurveData class definition.
+ * CurveData holds points of a loaded curve file together with values
+ * computed from them. It is never modified after loading, so one copy
+ * is shared by all curves displaying the same file. A min/max pyramid
+ * of the points is built at load time for drawing large curves.
+ * Points of text files can be kept in a compact, quantized form.
+ * Curves of score files share their points with the ScoreSet they are built from.
+ * Curves of score sketches carry the error bound of their AUC.
+ * Operating points of the curve are found at load time in one pass over its points.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+#include <QString>
+#include <QSharedPointer>
+#include <qwt_series_data.h>
+#include "../headers/BinaryCurve.h"
+#include "../headers/CurvePyramid.h"
+#include "../headers/FunctionData.h"
+#include "../headers/QuantizedPoints.h"
+#include "../headers/ScoreSet.h"
+#include "../headers/Metrics.h"
+
+class LoadObserver;
+
+class CurveData {
+
+public:
+	static QSharedPointer<CurveData> load(QString _path, LoadObserver *_observer = 0, bool _forDisplay = true);
+	static QVector<QSharedPointer<CurveData> > loadScoreCurves(QString _file, LoadObserver *_observer = 0, bool _forDisplay = true);
+	static bool isBinary(QString _path);
+	static void setStorageMode(QuantizedPoints::Mode _mode);
+	static QuantizedPoints::Mode getStorageMode();
+	static void setVerifyChecksums(bool _verify);
+	static bool getVerifyChecksums();
+
+	FunctionData* createSeriesData() const;
+	QVector<QPointF> getPoints() const;
+	const CurvePyramid* getPyramid() const;
+	QSharedPointer<ScoreSet> getScores() const;
+
+	QString getPath() const;
+	size_t size() const;
+	double getAUC() const;
+	double getAUCError() const;
+	const OperatingPoints& getOperatingPoints() const;
+	int getError() const;
+	QuantizedPoints::Mode getMode() const;
+	double getMaxError() const;
+	qint64 memoryUsage() const;
+
+private:
+	CurveData(QString _path);
+	static bool isPrFile(QString _path);
+	void measureScoreCurve(int _type, double _rocAuc, double _positives, double _negatives);
+
+	QString path;
+	QVector<QPointF> points;
+	QuantizedPoints quantized;
+	QSharedPointer<BinaryCurveFile> binary;
+	QSharedPointer<ScoreSet> scores;
+	CurvePyramid pyramid;
+	QRectF rect;
+	bool monotone;
+	double auc;
+	double aucError;
+	OperatingPoints operating;
+	int error;
+};
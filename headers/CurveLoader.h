@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains CurveLoader class definition.
+ * CurveLoader loads a curve file and computes its AUC in a thread pool.
+ * Results are announced by signals, which are delivered to the GUI thread
+ * through queued connections.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QSharedPointer>
+#include <QString>
+#include "../headers/fileProxy.h"
+#include "../headers/CurveData.h"
+
+class CurveLoader : public QObject, public QRunnable, public LoadObserver
+{
+	Q_OBJECT
+
+public:
+	CurveLoader(QSharedPointer<ProxyFile> _proxy);
+
+	void run();
+	void cancel();
+	bool progress(qint64, qint64);
+
+	static double computeAUC(const QVector<QPointF>&);
+
+	QSharedPointer<ProxyFile> getProxy();
+	QSharedPointer<CurveData> getCurveData();
+	double getAUC();
+	int getError();
+	QString getPath();
+	void setBatch(int);
+	int getBatch();
+
+signals:
+	void progressChanged(QString, int);
+	void loaded();
+	void failed(QString, int);
+
+private:
+	QSharedPointer<ProxyFile> proxy_;
+	QSharedPointer<CurveData> data_;
+	QString path_;
+	int error_;
+	int percent_;
+	int batch_;
+	QAtomicInt cancelled_;
+};
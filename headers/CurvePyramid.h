@@ -0,0 +1,70 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains CurvePyramid class definition.
+ * CurvePyramid is a multi-resolution min/max summary of curve samples.
+ * Level 0 splits the samples into buckets of BASE_BUCKET consecutive points,
+ * every next level joins FAN_OUT buckets of the previous one. For every bucket
+ * indices of samples with extreme x and y values are kept, which lets a curve
+ * draw only a few points for every pixel column of the canvas.
+ * Levels can be saved after the samples of a binary curve file and later
+ * used straight from its mapping, without being built again.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QByteArray>
+#include <QPointF>
+#include <qwt_series_data.h>
+
+class QwtScaleMap;
+
+class CurvePyramid {
+
+public:
+	enum { BASE_BUCKET = 16, FAN_OUT = 4 };
+
+	void build(const QwtSeriesData<QPointF> &_samples);
+	void select(const QwtSeriesData<QPointF> &_samples, const QwtScaleMap &_xMap,
+		int _from, int _to, double _width, QVector<int> &_indices) const;
+
+	QByteArray save() const;
+	void map(const uchar *_data, size_t _count);
+	static qint64 storedSize(size_t _count);
+
+	int levelCount() const;
+	qint64 memoryUsage() const;
+
+private:
+	struct Bucket {
+		quint32 minX;
+		quint32 maxX;
+		quint32 minY;
+		quint32 maxY;
+	};
+
+	int bucketSize(int _level) const;
+	void join(const QwtSeriesData<QPointF> &_samples, Bucket &_bucket, const Bucket &_part) const;
+	static QVector<int> levelSizes(size_t _count);
+
+	QVector<QVector<Bucket> > levels;		///< built levels, empty for a mapped pyramid
+	QVector<const Bucket*> buckets;			///< first bucket of every level, built or mapped
+	QVector<int> sizes;						///< number of buckets of every level
+};
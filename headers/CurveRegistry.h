@@ -0,0 +1,59 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains CurveRegistry class definition.
+ * CurveRegistry keeps curves of a plot together with proxies of their files.
+ * Curves are identified by stable ids (Curve::getId) and can be found
+ * by id or by file path in constant time. Curves are listed in the order
+ * in which they were registered, which is the order of their ids.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QSharedPointer>
+#include "../headers/Curve.h"
+#include "../headers/fileProxy.h"
+
+class CurveRegistry {
+
+public:
+	void insert(QSharedPointer<Curve> _curve, QSharedPointer<ProxyFile> _proxy);
+	void remove(int _id);
+	void clear();
+
+	QSharedPointer<Curve> curve(int _id) const;
+	QSharedPointer<ProxyFile> proxy(int _id) const;
+	QSharedPointer<Curve> findPath(const QString &_path) const;
+
+	QList<QSharedPointer<Curve> > curves() const;
+	int size() const;
+
+private:
+	struct Entry {
+		QSharedPointer<Curve> curve;
+		QSharedPointer<ProxyFile> proxy;
+	};
+
+	QHash<int, Entry> entries;
+	QList<int> order;					///< ids in the order of registration
+	QHash<QString, int> paths;
+};
@@ -0,0 +1,71 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains CurveTail class definition.
+ * CurveTail follows a text curve file which is still being written, e.g. by
+ * a training job. It remembers the byte offset up to which the file was parsed
+ * and, when the file grows, parses only the appended complete lines with
+ * DataParser. AUC, operating points and the bounding rect are updated from
+ * the new points alone. A file which became shorter was rewritten and is
+ * parsed again from its beginning.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include "../headers/Metrics.h"
+
+class CurveTail {
+
+public:
+	CurveTail(QString _path, int _type);
+
+	bool update();
+	bool wasRestarted() const;
+
+	QString getPath() const;
+	const QVector<QPointF>* getPoints() const;
+	size_t size() const;
+	QRectF boundingRect() const;
+	bool isMonotone() const;
+	double getAUC() const;
+	OperatingPoints getOperatingPoints() const;
+
+	static bool canFollow(QString _path);
+
+private:
+	void restart();
+	void append(int _from);
+
+	QString path;
+	int type;
+	qint64 offset;
+	bool restarted;
+	QVector<QPointF> points;
+	CompensatedSum area;
+	OperatingPointScan scan;
+	double left;
+	double right;
+	double top;
+	double bottom;
+	bool monotone;
+};
@@ -0,0 +1,42 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains DataParser class definition.
+ * DataParser scans tab separated point data in place (e.g. straight from
+ * a memory mapped file) without creating intermediate QString objects.
+ * Numbers are converted independently of the current locale.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+
+class DataParser {
+
+public:
+	static bool toDouble(const char *begin, const char *end, double &value);
+	static int splitFields(const char *begin, const char *end, const char **fields, const char **ends, int maxFields);
+	static int estimateLines(const char *begin, const char *end);
+	static const char* parsePoints(const char *begin, const char *end, QVector<QPointF> &points, bool &finished);
+	static void parseScores(const char *begin, const char *end, QVector<float> &scores, QVector<quint8> &labels,
+		QVector<float> &weights, bool &weighted);
+	static void parseAggregates(const char *begin, const char *end, QVector<float> &scores,
+		QVector<double> &positives, QVector<double> &negatives);
+};
@@ -0,0 +1,57 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains DeLong class definition.
+ * DeLong compares areas under ROC curves of several classifiers evaluated
+ * on the same examples with the test of DeLong, DeLong and Clarke-Pearson.
+ * The fast algorithm of Sun and Xu is used: placement values of every
+ * example are read from the score order already computed by ScoreSet,
+ * so each classifier takes O(n) after its sort, and the covariance matrix
+ * of all AUCs is computed in parallel. The class index of every example
+ * is shared by all classifiers, as they have to share labels.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QList>
+#include <QSharedPointer>
+
+class ScoreSet;
+
+class DeLong {
+
+public:
+	static QSharedPointer<DeLong> compare(const QList<QSharedPointer<ScoreSet> > &_sets);
+
+	int size() const;
+	double getAUC(int _model) const;
+	double getCovariance(int _first, int _second) const;
+	double zScore(int _first, int _second) const;
+	double pValue(int _first, int _second) const;
+
+	static double normalTail(double _z);
+
+private:
+	DeLong(int _count);
+
+	int count;
+	QVector<double> aucs;
+	QVector<double> covariance;
+};
@@ -0,0 +1,34 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains ErrorCodes class definition.
+ * Errors of opening, loading and writing files are thrown as int codes
+ * from 1000 up. ErrorCodes describes them without any widget, so both
+ * the window and the headless commands report them the same way.
+ */
+
+#pragma once
+
+#include <QString>
+
+class ErrorCodes {
+
+public:
+	static QString message(int _code);
+};
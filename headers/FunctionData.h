@@ -17,7 +17,9 @@
  * http://www.gnu.org/copyleft/gpl.html
  *
  * @section DESCRIPTION
- *
+ * FunctionData gives Qwt access to points of a curve. Its bounding rect
+ * is computed once, when the curve is loaded. Curves whose x values do not
+ * decrease expose the range of samples visible in an x interval.
  */
 
 #pragma once
@@ -27,12 +29,22 @@
 class FunctionData:  public QwtSeriesData<QPointF> {
 
 public:
-	FunctionData(QVector<QPointF> *_dataPoints);
+	FunctionData(const QVector<QPointF> *_dataPoints, QRectF _rect = QRectF(), bool _monotone = false);
     QPointF sample(size_t i) const;
     size_t size() const;
-	QRectF boundingRect() const;  
+	QRectF boundingRect() const;
+	bool isMonotone() const;
+	bool visibleRange(double _left, double _right, int &_from, int &_to) const;
+
+	static QRectF computeBoundingRect(const QPointF *_points, size_t _count, bool &_monotone);
+	static bool checkMonotone(const QwtSeriesData<QPointF> &_samples);
 
 private:
-	QVector<QPointF> *dataPoints;
+	size_t lowerBound(double _x) const;
+	size_t upperBound(double _x) const;
+
+	const QVector<QPointF> *dataPoints;
+	QRectF rect;
+	bool monotone;
 
 };
@@ -0,0 +1,120 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains Metrics class definition.
+ * Metrics computes areas under curves with the trapezoidal rule.
+ * The sum is compensated (CompensatedSum), so that it stays accurate over millions of points.
+ * Vectorized SSE2 and AVX kernels are chosen at runtime, depending on the
+ * processor, with a scalar kernel as the reference and the fallback.
+ * Operating points of a curve (EER, max F1, Youden J, TPR at low FPR and
+ * the break-even point) are found together in one pass by OperatingPointScan.
+ * PR curves are derived from ROC curves for a given prevalence of positive
+ * examples with the same runtime choice of kernels, and so are curves
+ * resampled onto a common grid by linear interpolation.
+ */
+
+#pragma once
+
+#include <QPointF>
+
+/**
+ * Compensated sum which keeps the rounding error of every addition (Neumaier)
+ */
+class CompensatedSum {
+
+public:
+	CompensatedSum(): sum(0.0), compensation(0.0) { }
+	void add(double _value);
+	double result() const;
+
+private:
+	double sum;
+	double compensation;
+};
+
+/**
+ * Operating points of a curve, NaN for values which cannot be read from it
+ */
+struct OperatingPoints {
+	double eer;					///< equal error rate, FPR at which FPR = 1 - TPR
+	double maxF1;				///< highest F1 score
+	double youden;				///< highest Youden J = TPR - FPR
+	double tprAt1e3;			///< TPR at FPR = 1e-3
+	double tprAt1e4;			///< TPR at FPR = 1e-4
+	double breakEven;			///< precision and recall at the point where they are equal
+
+	OperatingPoints();
+	static bool isAvailable(double _value);
+};
+
+/**
+ * Finds all operating points of a curve in one pass over its points, which may
+ * be given in blocks. ROC curves give EER, Youden J and TPR at low FPR; F1 and the
+ * break-even point need the prevalence of positive examples. PR curves give
+ * F1 and the break-even point.
+ */
+class OperatingPointScan {
+
+public:
+	enum { ROC_CURVE = 0, PR_CURVE = 1 };
+
+	OperatingPointScan(int _type, double _prevalence = 0.0);
+	void add(const QPointF *_points, size_t _count);
+	OperatingPoints result() const;
+
+private:
+	void addRoc(const QPointF *_points, size_t _count);
+	void addPr(const QPointF *_points, size_t _count);
+
+	int type;
+	double prevalence;
+	bool started;
+	QPointF last;
+	double eer;
+	double maxF1;
+	double youden;
+	double tprAt1e3;
+	double tprAt1e4;
+	double breakEven;
+};
+
+class Metrics {
+
+public:
+	enum Kernel { Scalar = 0, SSE2 = 1, AVX = 2 };
+
+	static double auc(const QPointF *_points, size_t _count);
+	static double auc(const QPointF *_points, size_t _count, Kernel _kernel);
+	static double partialAuc(const QPointF *_points, size_t _count, double _from, double _to);
+	static OperatingPoints operatingPoints(const QPointF *_points, size_t _count, int _type, double _prevalence = 0.0);
+	static void precisionRecall(const QPointF *_roc, size_t _count, double _prevalence, QPointF *_pr);
+	static void interpolate(const QPointF *_points, const quint32 *_segments, const double *_x, size_t _count, double *_y);
+
+	static Kernel bestKernel();
+	static const char* kernelName(Kernel _kernel);
+
+private:
+	static double scalarAuc(const QPointF *_points, size_t _count);
+	static double sse2Auc(const QPointF *_points, size_t _count);
+	static double avxAuc(const QPointF *_points, size_t _count);
+	static void scalarPrecision(const QPointF *_roc, size_t _count, double _prevalence, QPointF *_pr);
+	static void sse2Precision(const QPointF *_roc, size_t _count, double _prevalence, QPointF *_pr);
+	static void scalarInterpolate(const QPointF *_points, const quint32 *_segments, const double *_x, size_t _count, double *_y);
+	static void sse2Interpolate(const QPointF *_points, const quint32 *_segments, const double *_x, size_t _count, double *_y);
+};
@@ -29,6 +29,12 @@
 #include <qlistwidget.h>
 #include <qlist.h>
 #include <qpointer.h>
+#include <qhash.h>
+#include <qset.h>
+#include <qstringlist.h>
+#include <QSharedPointer>
+#include <qcolor.h>
+#include "../headers/Metrics.h"
 
 class QGridLayout;
 class QComboBox;
@@ -36,6 +42,9 @@ class QPushButton;
 class QLabel;
 class QLineEdit;
 class QCheckBox;
+class QTableWidget;
+class QSlider;
+class DeLong;
 
 class Panel: public QTabWidget
 {
@@ -48,7 +57,6 @@ signals:
     void settingsChanged(QString);
 	void nameChange(int, QString);
 	void colorChange(int, QColor);
-	void getColorAuc(int);
 	void curveDelete(int);
 	void hideAllExceptOfThis(int);
 	void clearPlot();
@@ -56,34 +64,78 @@ signals:
 	void plotNameChange(QString);
 	void labelsChange(QString, QString);
 	void gridChange(int);
+	void bootstrapRequested(int);
+	void followRequested(int, bool);
+	void significanceRequested();
+	void prevalenceChanged(double);
+	void hullsChanged(bool, double);
+	void averageAdd(int);
+	void averageRemove(int);
+	void averageModeChange(int, int);
 
 private slots:
-	void addCurve(QString, QColor, double);
+	void addCurve(int, QString, QColor, double, double, OperatingPoints);
 	void edited(const QString&);
 	void setColor();
 	void changeName();
 	void deleteCurve();
 	void hideAll();
 	void clearAll();
-	void readColorAuc(QColor, double);
+	void showAucInterval(int, double, double, int);
+	void requestBootstrap();
+	void requestFollow(int);
+	void showFollowed(int, bool);
+	void updateCurve(int, double, OperatingPoints);
+	void showSignificance(QStringList, QSharedPointer<DeLong>);
 	void setBcgColor();
 	void changePlotName();
 	void changeLabels();
 	void changeGrid(int);
+	void changePrevalence();
+	void changeHulls();
+	void addToAverage();
+	void removeFromAverage();
+	void changeAverageMode();
+	void showAverage(int, double);
 
 private:
+	/**
+	 * Values of a curve displayed in the curve tab, kept so that switching curves needs no signals
+	 */
+	struct CurveInfo {
+		QColor color;
+		double auc;
+		double aucError;
+		OperatingPoints operating;
+	};
+
 	QPointer<QWidget> createCurveTab(QPointer<QWidget>);
 	QPointer<QWidget> createPlotTab(QPointer<QWidget>);
+	QPointer<QWidget> createSignificanceTab(QPointer<QWidget>);
+	int currentCurve();
+	static QString formatAuc(double, double);
+	static QString formatOperatingPoints(const OperatingPoints&);
+	void showCurve(int);
 
 	QPointer<QWidget> curvesTab;
 	QPointer<QWidget> plotTab;
+	QPointer<QWidget> significanceTab;
 
 	QPointer<QComboBox> curvesCombo;
 
 	QPointer<QLineEdit> lineEdit;
 	QPointer<QLabel> colorLabel;
 	QPointer<QLabel> aucLabel;
+	QPointer<QLabel> intervalLabel;
+	QPointer<QLabel> metricsLabel;
 	QPointer<QPushButton> colorButton;
+	QPointer<QPushButton> bootstrapButton;
+	QPointer<QCheckBox> followCheckBox;
+	QPointer<QComboBox> averageModeCombo;
+	QPointer<QComboBox> averageBandCombo;
+	QPointer<QPushButton> averageAddButton;
+	QPointer<QPushButton> averageRemoveButton;
+	QPointer<QLabel> averageLabel;
 	QPointer<QPushButton> nameButton;
 	QPointer<QPushButton> deleteButton;
 	QPointer<QPushButton> hideAllButton;
@@ -99,7 +151,26 @@ private:
 	QPointer<QPushButton> plotBcgColorButton;
 	QPointer<QGridLayout> plotLayout;
 	QPointer<QCheckBox> gridCheckBox;
+	QPointer<QCheckBox> deriveCheckBox;
+	QPointer<QSlider> prevalenceSlider;
+	QPointer<QLabel> prevalenceLabel;
+	QPointer<QCheckBox> hullCheckBox;
+	QPointer<QCheckBox> isoCheckBox;
+	QPointer<QSlider> slopeSlider;
+	QPointer<QLabel> slopeLabel;
+
+	QPointer<QPushButton> compareButton;
+	QPointer<QTableWidget> significanceTable;
+	QPointer<QGridLayout> significanceLayout;
+
+	QHash<int, QString> intervals;
+	QHash<int, CurveInfo> curveInfo;
+	QSet<int> followed;
 
 	int type;
+
+	enum { PREVALENCE_STEPS = 1000, SLOPE_STEPS = 1000 };
+	double prevalence() const;
+	double slope() const;
 };
 
@@ -23,15 +23,30 @@
 
 #pragma once
 
-#include <vector>
 #include <qpointer.h>
 #include <QSharedPointer>
 #include <qwt_plot.h>
 #include <qwt_plot_curve.h>
+#include <QHash>
+#include <QStringList>
+#include <QSet>
+#include <QPixmap>
 #include "../headers/Curve.h"
 #include "../headers/fileProxy.h"
+#include "../headers/CurveRegistry.h"
+#include "../headers/CurveAverage.h"
 
 class QwtPlotGrid;
+class CurveLoader;
+class Bootstrap;
+class AverageUpdater;
+class QwtPlotIntervalCurve;
+class DeLong;
+class CurveTail;
+class QFileSystemWatcher;
+class QTimer;
+class QThreadPool;
+class QwtPlotDirectPainter;
 
 using namespace std;
 
@@ -41,21 +56,38 @@ class Plot : public QwtPlot
 
 public:
     Plot(QPointer<QWidget> parent = NULL, int _type = 0);
+	~Plot();
 
 	int addCurve(QString, int);
+	int addCurves(QStringList);
+	void setSourcePlot(Plot*);
+	QList<QSharedPointer<Curve> > attachedCurves() const;
+	static QColor curveColor(int);
+	static void applyStyle(QwtPlot*);
+	static QwtPlotGrid* createGrid();
+	void beginUpdate();
+	void endUpdate();
+	int replotCount() const;
+	int requestCount() const;
 
 	enum { ROC_CURVE = 0, PR_CURVE = 1 };
-	enum { CURVE_LIMIT = 20 };
+	enum { BAND_ALPHA = 60 };
+	enum { TAIL_INTERVAL = 500 };
+	enum { FRAME_INTERVAL = 16 };
+	enum { CURVE_Z = 20, CURVE_LAYERS = 8 };
+	enum { BELOW_LAYER = 0, FIRST_CURVE_LAYER = 1, ACTIVE_LAYER = CURVE_LAYERS + 1,
+		ABOVE_LAYER = CURVE_LAYERS + 2, LAYER_COUNT = CURVE_LAYERS + 3 };
 
 protected:
     virtual void resizeEvent(QResizeEvent*);
 	bool eventFilter(QObject*, QEvent*);
+	virtual void drawItems(QPainter*, const QRectF&, const QwtScaleMap maps[axisCnt]) const;
 
 public slots:	
+	virtual void replot();
 	void showItem(QwtPlotItem*, bool);
 	void changeName(int, QString);
 	void changeColor(int, QColor);
-	void getColAuc(int);
 	void deleteCurve(int);
 	void leaveOneUnhided(int);
 	void clearAll();
@@ -63,25 +95,104 @@ public slots:
 	void changePlotName(QString);
 	void changePlotLabels(QString, QString);
 	void changeGridState(int);
+	void cancelLoad(QString);
+	void bootstrapCurve(int);
+	void compareCurves();
+	void derivePrCurves(double);
+	void addToAverage(int);
+	void removeFromAverage(int);
+	void setAverageMode(int, int);
+	void setHullOverlay(bool, double);
+	void followCurve(int, bool);
+
+private slots:
+	void curveLoaded();
+	void curveFailed(QString, int);
+	void bootstrapProgress();
+	void bootstrapFinished();
+	void averageUpdated();
+	void tailChanged(QString);
+	void updateTails();
+	void sourceCurveChanged(int);
+	void flushReplot();
 
 signals:
 	void coordinatesAssembled(QPoint);
-	void curveAdded(QString, QColor, double);
+	void curveAdded(int, QString, QColor, double, double, OperatingPoints);
 	void curveAdd();
-	void resendColorAuc(QColor, double);
+	void loadStarted(QString);
+	void loadProgress(QString, int);
+	void loadFinished(QString);
+	void loadFailed(QString, int);
+	void loadReport(QString, QString);
+	void aucIntervalChanged(int, double, double, int);
+	void significanceComputed(QStringList, QSharedPointer<DeLong>);
+	void averageChanged(int, double);
+	void curveFollowed(int, bool);
+	void curveUpdated(int, double, OperatingPoints);
 
 private:
 	QColor generateColor();
 	QString generateName();
+	void attachCurves(const QList<QSharedPointer<Curve> >&);
+	void finishBatchItem(int);
+	void dropBand(int);
+	bool addFold(int);
+	void updateAverage();
+	void updateHulls();
+	void stopFollowing(int);
+	void deriveCurve(QSharedPointer<Curve>, QwtPlotCurve*);
+	void requestReplot();
+	void invalidateItem(const QwtPlotItem*);
+	void forgetItem(const QwtPlotItem*);
+	QVector<int> assignLayers() const;
 
 	int type;
 	int curve_counter;
-	vector<QSharedPointer<Curve> > curves_;
-	vector<QSharedPointer<ProxyFile> > proxies_;
+	int batch_counter;
+	int name_counter;
+	CurveRegistry registry_;
+	QThreadPool *pool_;
+	QHash<QString, CurveLoader*> loaders_;
+	QHash<int, int> batchPending_;
+	QHash<int, QList<QSharedPointer<Curve> > > batchCurves_;
+	QHash<int, Bootstrap*> bootstraps_;
+	QHash<int, QwtPlotIntervalCurve*> bands_;
+	QPointer<Plot> source_;
+	QHash<int, QwtPlotCurve*> derived_;
+	double prevalence_;
+	CurveAverage average_;
+	AverageUpdater *averageUpdater_;
+	bool averageDirty_;
+	QwtPlotCurve *averageCurve_;
+	QwtPlotIntervalCurve *averageBand_;
+	bool hullsShown_;
+	double isoSlope_;
+	QHash<int, QVector<QPointF> > hulls_;
+	QHash<int, QwtPlotCurve*> hullCurves_;
+	QwtPlotCurve *unionHull_;
+	QwtPlotCurve *isoLine_;
+	QHash<int, CurveTail*> tails_;
+	QSet<int> changedTails_;
+	QFileSystemWatcher *watcher_;
+	QTimer *tailTimer_;
+	QwtPlotDirectPainter *directPainter_;
+	int updateDepth_;
+	bool replotRequested_;
+	int replotCount_;
+	int requestCount_;
+	QTimer *replotTimer_;
+	mutable QVector<QPixmap> layers_;
+	mutable QVector<QList<const QwtPlotItem*> > layerItems_;
+	mutable QVector<bool> layerValid_;
+	mutable QVector<double> layerKey_;
+	mutable QHash<const QwtPlotItem*, int> curveLayers_;
+	const QwtPlotItem *activeItem_;
 
 	QPointer<QwtLegend> legend;
 	QwtPlotGrid* grid;
 
-	const int* QtColors;
+	static const Qt::GlobalColor QtColors[];
+	static const int QtColorsCount;
 	int itColor;
 };
@@ -25,6 +25,7 @@
 #include "../headers/Plot.h"
 #include <qmainwindow.h>
 #include <qpoint.h>
+#include <qhash.h>
 #include "../headers/fileProxy.h"
 
 class QAction;
@@ -32,6 +33,10 @@ class QMenu;
 class QPlainTextEdit;
 class Panel;
 class QHBoxLayout;
+class QProgressBar;
+class QSignalMapper;
+class QErrorMessage;
+class SketchBuilder;
 
 class PlotWindow : public QMainWindow{	
 	Q_OBJECT
@@ -44,9 +49,23 @@ protected:
 
 private slots:
 	void open();
+	void convert();
+	void buildSketch();
+	void setCacheBudget();
+	void setStorageMode();
+	void setScoreBudget();
 	void about();
 	void switchPlot();
 	void exportDocument();
+	void loadStarted(QString);
+	void loadProgress(QString, int);
+	void loadFinished(QString);
+	void cancelLoad(QString);
+	void reportError(QString, int);
+	void showFailures();
+	void sketchBuilt();
+	void sketchFailed(QString, int);
+	void showReport(QString, QString);
 
 #ifndef QT_NO_PRINTER
     void print();
@@ -70,9 +89,14 @@ private:
 	QToolBar *fileToolBar;
 	
 	QAction *openAction;
+	QAction *convertAction;
+	QAction *sketchAction;
 	QAction *printAction;
 	QAction *switchAction;
 	QAction *clearAction;
+	QAction *cacheAction;
+	QAction *storageAction;
+	QAction *scoreBudgetAction;
 	QAction *exportAction;
 	QAction *exitAction;
 	QAction *aboutAct;
@@ -90,4 +114,11 @@ private:
 	Plot *roc_plot;
 	Plot *pr_plot;
 	Plot *current_plot;
+
+	QSignalMapper *cancelMapper;
+	QHash<QString, QWidget*> progressWidgets;
+	QHash<QString, QProgressBar*> progressBars;
+	QErrorMessage *errorDialog;
+	QHash<QString, SketchBuilder*> sketchBuilders;
+	QStringList failures;
 };
@@ -0,0 +1,77 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains QuantizedPoints class definition.
+ * QuantizedPoints keeps points of a curve in a compact form: as floats or as
+ * 16 or 32 bit fixed point numbers spread over the bounding rect of the curve.
+ * x and y values are stored in separate arrays. QuantizedFunctionData
+ * decodes the points when Qwt asks for them.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+#include "../headers/FunctionData.h"
+
+class QuantizedPoints {
+
+public:
+	enum Mode { DoublePrecision = 0, SinglePrecision = 1, Fixed16 = 2, Fixed32 = 3 };
+
+	QuantizedPoints();
+
+	void encode(const QVector<QPointF> &_points, const QRectF &_rect, Mode _mode);
+	QPointF sample(size_t i) const;
+	size_t size() const;
+	Mode getMode() const;
+	double getMaxError() const;
+	qint64 memoryUsage() const;
+
+	static double errorBound(Mode _mode, const QRectF &_rect);
+	static QString modeName(Mode _mode);
+
+private:
+	Mode mode;
+	size_t count;
+	QVector<float> xFloats;
+	QVector<float> yFloats;
+	QVector<quint16> xFixed16;
+	QVector<quint16> yFixed16;
+	QVector<quint32> xFixed32;
+	QVector<quint32> yFixed32;
+	double xOrigin;
+	double xStep;
+	double yOrigin;
+	double yStep;
+	double maxError;
+};
+
+class QuantizedFunctionData: public FunctionData {
+
+public:
+	QuantizedFunctionData(const QuantizedPoints *_points, QRectF _rect, bool _monotone);
+	QPointF sample(size_t i) const;
+	size_t size() const;
+
+private:
+	const QuantizedPoints *points;
+};
@@ -0,0 +1,38 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains RadixSort class definition.
+ * RadixSort orders float keys with a multi-threaded least significant
+ * digit radix sort. Every pass counts digits of consecutive parts of the
+ * keys in parallel and scatters them in parallel to precomputed offsets,
+ * so the sort is stable.
+ */
+
+#pragma once
+
+#include <QtGlobal>
+
+class RadixSort {
+
+public:
+	enum { DIGIT_BITS = 11, BUCKETS = 1 << DIGIT_BITS };
+
+	static void sortDescending(const float *_keys, quint32 _count, quint32 *_order, int _threads = 0);
+	static quint32 descendingKey(float _key);
+};
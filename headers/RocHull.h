@@ -0,0 +1,46 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains RocHull class definition.
+ * RocHull builds ROC convex hulls (Provost and Fawcett, "Robust classification
+ * for imprecise environments"). Points of ROC curves are sorted by false positive
+ * rate, so the upper hull is found by a monotone chain in linear time. Hulls of
+ * many curves are united by a sweep which merges their sorted vertices and runs
+ * the chain again. The optimal point for a slope of iso-performance lines, given
+ * by the costs and the class ratio, is found by binary search over hull edges.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+#include <QLineF>
+#include <QList>
+
+class RocHull {
+
+public:
+	static QVector<QPointF> hull(const QPointF *_points, size_t _count);
+	static QVector<QPointF> unite(const QList<QVector<QPointF> > &_hulls, QVector<int> *_owners = 0);
+	static int optimalVertex(const QVector<QPointF> &_hull, double _slope);
+	static QLineF isoPerformanceLine(QPointF _point, double _slope);
+
+private:
+	static void chain(const QPointF *_points, const int *_owners, size_t _count, QVector<QPointF> &_hull, QVector<int> *_hullOwners);
+};
@@ -0,0 +1,94 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains ScoreSet class definition.
+ * ScoreSet holds raw classifier output read from a .scores file: a score,
+ * a label and an optional weight of every example. The file is parsed in
+ * parallel, examples are ordered by descending score with RadixSort, and
+ * both ROC and PR curves are built in one walk over the sorted examples.
+ * Examples with equal scores are handled as one threshold. Curve points are
+ * thinned to CURVE_RESOLUTION, the AUC is computed from all examples.
+ *
+ * Whether a file fits in the memory budget is decided from its size and the
+ * number of its examples, estimated from its first block, times the memory
+ * an example takes. Files too large for the memory budget are streamed: runs of examples are
+ * sorted in memory and spilled to temporary files, which are then merged,
+ * while curve points are emitted and thinned to CURVE_RESOLUTION on the fly.
+ * Examples of streamed files are not kept, only their curves.
+ * Manifests of sorted shards (.shards) are merged by ShardMerge in the same way.
+ *
+ * Curves of a score file are opened as "file.scores#roc" and "file.scores#pr",
+ * both share one ScoreSet through CurveCache.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+#include <QString>
+#include <QSharedPointer>
+
+class LoadObserver;
+class QFile;
+
+class ScoreSet {
+
+public:
+	enum { ROC_CURVE = 0, PR_CURVE = 1 };
+	enum { CURVE_RESOLUTION = 16384 };
+
+	static QSharedPointer<ScoreSet> load(QString _path, LoadObserver *_observer = 0);
+	static bool isScoreFile(QString _path);
+	static QString curvePath(QString _file, int _type);
+	static bool splitCurvePath(QString _path, QString &_file, int &_type);
+	static void setMemoryBudget(qint64 _bytes);
+	static qint64 getMemoryBudget();
+
+	QString getPath() const;
+	size_t size() const;
+	bool isStreamed() const;
+	const float* getScores() const;
+	const quint8* getLabels() const;
+	const float* getWeights() const;
+	const quint32* getOrder() const;
+	double getPositives() const;
+	double getNegatives() const;
+	const QVector<QPointF>& getCurve(int _type) const;
+	double getAUC() const;
+	qint64 memoryUsage() const;
+
+private:
+	ScoreSet(QString _path);
+	void parse(const char *_begin, const char *_end, LoadObserver *_observer, qint64 _total);
+	void buildCurves();
+	void loadStreamed(QFile &_file, LoadObserver *_observer);
+
+	QString path;
+	QVector<float> scores;
+	QVector<quint8> labels;
+	QVector<float> weights;
+	QVector<quint32> order;
+	QVector<QPointF> roc;
+	QVector<QPointF> pr;
+	double positives;
+	double negatives;
+	double auc;
+	quint64 examples;
+	bool streamed;
+};
@@ -0,0 +1,107 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains the score sketch format (.sketch) and ScoreSketch class definition.
+ * ScoreSketch is a fixed-bin histogram of scores kept separately for positive
+ * and negative examples, so that curves of any number of predictions are
+ * built in constant memory. Sketches with the same bins are merged by adding
+ * their histograms, which makes merging associative and lets shards computed
+ * on different nodes be combined into one curve.
+ *
+ * A sketch file consists of a ScoreSketchHeader followed by ScoreSketchBin
+ * records of the non-empty bins in ascending order, in native byte order.
+ *
+ * Error bound: examples falling into one bin are treated as tied. Only pairs of
+ * a positive and a negative example in the same bin can be ordered wrongly, so
+ * the ROC AUC of the sketch differs from the exact AUC by at most
+ * sum(p[b] * n[b]) / (2 * P * N), where p[b], n[b] are the weights of positive
+ * and negative examples in bin b and P, N their totals. Scores outside the range
+ * of the bins are counted in the first or the last bin, the bound covers them.
+ * The bound does not apply to the PR curve.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+#include <QString>
+
+class LoadObserver;
+
+/**
+ * Header of a score sketch file
+ */
+struct ScoreSketchHeader {
+	char magic[4];			///< "ZPRS"
+	quint32 version;		///< format version, currently 1
+	quint32 bins;			///< number of bins
+	quint32 used;			///< number of stored bins
+	double low;				///< score range covered by the bins
+	double high;
+	quint64 examples;		///< number of examples added to the sketch
+	quint64 checksum;		///< checksum of the bin records
+};
+
+/**
+ * Non-empty bin of a score sketch file
+ */
+struct ScoreSketchBin {
+	quint32 bin;			///< index of the bin
+	quint32 reserved;
+	double positives;		///< weight of positive examples in the bin
+	double negatives;		///< weight of negative examples in the bin
+};
+
+class ScoreSketch {
+
+public:
+	enum { VERSION = 1 };
+	enum { DEFAULT_BINS = 65536, MAX_BINS = 1 << 24 };
+
+	ScoreSketch(double _low = 0.0, double _high = 1.0, quint32 _bins = DEFAULT_BINS);
+
+	void add(float _score, bool _positive, double _weight = 1.0);
+	void addScores(QString _path, LoadObserver *_observer = 0);
+	void merge(const ScoreSketch &_other);
+	bool isCompatible(const ScoreSketch &_other) const;
+
+	void save(QString _path) const;
+	static ScoreSketch load(QString _path, LoadObserver *_observer = 0);
+	static bool isSketchFile(QString _path);
+
+	double getLow() const;
+	double getHigh() const;
+	quint32 getBins() const;
+	quint64 getExamples() const;
+	double getPositives() const;
+	double getNegatives() const;
+
+	double buildCurves(QVector<QPointF> &_roc, QVector<QPointF> &_pr) const;
+	double aucErrorBound() const;
+
+private:
+	quint32 bin(float _score) const;
+
+	double low;
+	double high;
+	quint32 bins;
+	quint64 examples;
+	QVector<double> positives;
+	QVector<double> negatives;
+};
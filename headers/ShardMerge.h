@@ -0,0 +1,51 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains ShardMerge class definition.
+ * ShardMerge builds the exact curves of a dataset split into shards, which
+ * were sorted by descending score on the nodes that produced them. A shard
+ * manifest (.shards) lists one shard per line, relative to the manifest.
+ * A shard is a score file, or an aggregate (.agg) holding the total weight
+ * of positive and negative examples of every score.
+ *
+ * Shards are memory mapped and read twice: once in parallel to sum the
+ * weights and check the order, then merged with a heap, while the curves
+ * are built. Only a small batch of every shard is parsed at a time, so the
+ * combined dataset is never held in memory.
+ */
+
+#pragma once
+
+#include <QVector>
+#include <QPointF>
+#include <QString>
+#include <QStringList>
+
+class LoadObserver;
+
+class ShardMerge {
+
+public:
+	static bool isManifest(QString _path);
+	static bool isAggregate(QString _path);
+	static QStringList readManifest(QString _path);
+
+	static double merge(QString _manifest, LoadObserver *_observer, QVector<QPointF> &_roc, QVector<QPointF> &_pr,
+		double &_positives, double &_negatives, quint64 &_examples);
+};
@@ -0,0 +1,62 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This header file contains SketchBuilder class definition.
+ * SketchBuilder merges score sketches and adds score files to a sketch, which
+ * is then saved, in a thread pool. Progress over all files and the result are
+ * announced by signals, which are delivered to the GUI thread through queued connections.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QAtomicInt>
+#include <QStringList>
+#include "../headers/fileProxy.h"
+#include "../headers/ScoreSketch.h"
+
+class SketchBuilder : public QObject, public QRunnable, public LoadObserver
+{
+	Q_OBJECT
+
+public:
+	SketchBuilder(const ScoreSketch &_sketch, QStringList _sketchFiles, QStringList _scoreFiles, QString _target);
+
+	void run();
+	void cancel();
+	bool progress(qint64, qint64);
+
+	const ScoreSketch& getSketch() const;
+	QString getTarget() const;
+
+signals:
+	void progressChanged(QString, int);
+	void built();
+	void failed(QString, int);
+
+private:
+	ScoreSketch sketch_;
+	QStringList sketchFiles_;
+	QStringList scoreFiles_;
+	QString target_;
+	int file_;
+	int percent_;
+	QAtomicInt cancelled_;
+};
@@ -25,21 +25,34 @@
 #pragma once
 
 #include "../headers/FunctionData.h"
+#include "../headers/CurveData.h"
 #include <string>
 #include "qwt_math.h"
 #include <qwt_series_data.h>
 #include <QString>
 #include <QPointF>
+#include <QSharedPointer>
+
+/**
+ * Interface of an object which is notified about loading progress.
+ * Returning false from progress cancels the loading.
+ */
+class LoadObserver{
+	public:
+		virtual ~LoadObserver(){}
+		virtual bool progress(qint64 _done, qint64 _total) = 0;
+};
 
 class RealFile{
 	private:
 		QVector<QPointF> data_points;
 		QString path;
+		bool loaded;
 		
 	public:
 		RealFile(QString _path); //constructor
 		~RealFile(); //destructor
-		QVector<QPointF>* getData();
+		QVector<QPointF>* getData(LoadObserver *_observer = 0);
 
 };
 
@@ -55,6 +68,7 @@ class ProxyFile{
 		~ProxyFile();
 		
 		ProxyFile* init_path(QString _path);
-		QVector<QPointF>* getData();
+		QVector<QPointF>* getData(LoadObserver *_observer = 0);
+		QSharedPointer<CurveData> getCurveData(LoadObserver *_observer = 0);
 };
 
@@ -9,17 +9,65 @@ INCLUDEPATH += . headers
 CONFIG += qwt
 
 # Input
-HEADERS += headers/Curve.h \
+HEADERS += headers/AverageUpdater.h \
+           headers/BatchMetrics.h \
+           headers/BatchRender.h \
+           headers/BinaryCurve.h \
+           headers/Bootstrap.h \
+           headers/Curve.h \
+           headers/CurveAverage.h \
+           headers/CurveBuilder.h \
+           headers/CurveCache.h \
+           headers/CurveData.h \
+           headers/CurveLoader.h \
+           headers/CurvePyramid.h \
+           headers/CurveRegistry.h \
+           headers/CurveTail.h \
+           headers/DataParser.h \
+           headers/DeLong.h \
+           headers/ErrorCodes.h \
            headers/fileProxy.h \
            headers/FunctionData.h \
+           headers/Metrics.h \
            headers/Panel.h \
            headers/Plot.h \
-           headers/PlotWindow.h
-SOURCES += sources/Curve.cpp \
+           headers/PlotWindow.h \
+           headers/QuantizedPoints.h \
+           headers/RadixSort.h \
+           headers/RocHull.h \
+           headers/ScoreSet.h \
+           headers/ScoreSketch.h \
+           headers/ShardMerge.h \
+           headers/SketchBuilder.h
+SOURCES += sources/AverageUpdater.cpp \
+           sources/BatchMetrics.cpp \
+           sources/BatchRender.cpp \
+           sources/BinaryCurve.cpp \
+           sources/Bootstrap.cpp \
+           sources/Curve.cpp \
+           sources/CurveAverage.cpp \
+           sources/CurveBuilder.cpp \
+           sources/CurveCache.cpp \
+           sources/CurveData.cpp \
+           sources/CurveLoader.cpp \
+           sources/CurvePyramid.cpp \
+           sources/CurveRegistry.cpp \
+           sources/CurveTail.cpp \
+           sources/DataParser.cpp \
+           sources/DeLong.cpp \
+           sources/ErrorCodes.cpp \
            sources/fileProxy.cpp \
            sources/FunctionData.cpp \
            sources/main.cpp \
+           sources/Metrics.cpp \
            sources/Panel.cpp \
            sources/Plot.cpp \
-           sources/PlotWindow.cpp
+           sources/PlotWindow.cpp \
+           sources/QuantizedPoints.cpp \
+           sources/RadixSort.cpp \
+           sources/RocHull.cpp \
+           sources/ScoreSet.cpp \
+           sources/ScoreSketch.cpp \
+           sources/ShardMerge.cpp \
+           sources/SketchBuilder.cpp
 RESOURCES += application.qrc
@@ -0,0 +1,67 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+
+#include "../headers/AverageUpdater.h"
+
+/**
+ * AverageUpdater class constructor. Folds of the average are implicitly shared,
+ * so the copy is cheap until it is updated. The updater is deleted by its owner,
+ * not by the thread pool.
+ * @param _average average to be updated
+ */
+AverageUpdater::AverageUpdater(const CurveAverage &_average):
+	average_(_average), error_(0)
+{
+	setAutoDelete(false);
+}
+
+/**
+ * Updates the average. Called by the thread pool, emits finished signal when done.
+ */
+void AverageUpdater::run()
+{
+	try {
+		average_.update();
+	}
+	catch(int e) {
+		error_ = e;
+	}
+	emit finished();
+}
+
+/**
+ * @return updated average, valid after finished signal was emitted
+ */
+const CurveAverage& AverageUpdater::getAverage() const
+{
+	return average_;
+}
+
+/**
+ * @return error thrown by the update (see CurveAverage::update), 0 if there was none
+ */
+int AverageUpdater::getError() const
+{
+	return error_;
+}
@@ -0,0 +1,415 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+#include "../headers/BatchMetrics.h"
+#include "../headers/CurveData.h"
+#include "../headers/ErrorCodes.h"
+#include "../headers/ScoreSet.h"
+#include "../headers/ScoreSketch.h"
+#include <QtConcurrentMap>
+#include <QFuture>
+#include <QThreadPool>
+#include <qdir.h>
+#include <qdiriterator.h>
+#include <qfileinfo.h>
+#include <qregexp.h>
+#include <qtextstream.h>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+
+/**
+ * Measures the curves of one file. Both curves of a score or sketch file are measured
+ * in one task from its examples or histogram, which are loaded only once.
+ * @param _task file to be measured
+ */
+static void measureTask(MetricsTask &_task)
+{
+	QStringList names;
+	bool scores = ScoreSet::isScoreFile(_task.path) || ScoreSketch::isSketchFile(_task.path);
+	if (scores) {
+		names << "roc" << "pr";
+	}
+	else {
+		QString suffix = QFileInfo(_task.path).suffix().toLower();
+		names << (suffix.startsWith("pr") ? "pr" : "roc");
+	}
+
+	_task.rows.clear();
+	_task.rows.resize(names.size());
+	for (int c = 0; c < names.size(); c++) {
+		MetricsRow &row = _task.rows[c];
+		row.path = _task.path;
+		row.curve = names[c];
+		row.points = 0;
+		row.auc = std::numeric_limits<double>::quiet_NaN();
+		row.aucError = 0.0;
+	}
+
+	try {
+		QVector<QSharedPointer<CurveData> > curves;
+		if (scores) {
+			curves = CurveData::loadScoreCurves(_task.path, 0, false);
+		}
+		else {
+			curves.append(CurveData::load(_task.path, 0, false));
+		}
+		for (int c = 0; c < curves.size(); c++) {
+			MetricsRow &row = _task.rows[c];
+			row.points = curves[c]->size();
+			row.aucError = curves[c]->getAUCError();
+			row.operating = curves[c]->getOperatingPoints();
+			if (curves[c]->getError() != 0) {
+				row.error = ErrorCodes::message(curves[c]->getError());
+			}
+			else {
+				row.auc = curves[c]->getAUC();
+			}
+		}
+	}
+	catch(int e) {
+		for (int c = 0; c < _task.rows.size(); c++) {
+			_task.rows[c].error = ErrorCodes::message(e);
+		}
+	}
+}
+
+/**
+ * Formats a measure, values which are not available are left empty
+ * @param _value measure
+ * @param _empty text written for NaN
+ * @return text of the value
+ */
+static QString formatValue(double _value, const char *_empty)
+{
+	if (!OperatingPoints::isAvailable(_value)) {
+		return _empty;
+	}
+	return QString::number(_value, 'g', 12);
+}
+
+/**
+ * Quotes a CSV field if it holds a separator, a quote or a line break
+ * @param _text field
+ * @return quoted field
+ */
+static QString csvField(QString _text)
+{
+	if (!_text.contains(QRegExp("[,\"\\n\\r]"))) {
+		return _text;
+	}
+	return "\"" + _text.replace("\"", "\"\"") + "\"";
+}
+
+/**
+ * Quotes a JSON string
+ * @param _text string
+ * @return quoted and escaped string
+ */
+static QString jsonString(QString _text)
+{
+	QString quoted = "\"";
+	for (int i = 0; i < _text.size(); i++) {
+		QChar c = _text[i];
+		if (c == '"' || c == '\\') {
+			quoted += '\\';
+			quoted += c;
+		}
+		else if (c.unicode() < 0x20) {
+			quoted += QString("\\u%1").arg(c.unicode(), 4, 16, QChar('0'));
+		}
+		else {
+			quoted += c;
+		}
+	}
+	return quoted + "\"";
+}
+
+/**
+ * Checks if the program was started to measure curve files. The command line is
+ * checked before any application object exists, as no GUI is started for it.
+ * @param _argc number of arguments
+ * @param _argv arguments
+ * @return true if the command line holds --metrics
+ */
+bool BatchMetrics::isMetricsCommand(int _argc, char *_argv[])
+{
+	for (int i = 1; i < _argc; i++) {
+		if (strcmp(_argv[i], "--metrics") == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+ * Describes the command line of batch measuring
+ * @return usage text
+ */
+QString BatchMetrics::usage()
+{
+	return QString("usage: --metrics [--format csv|json] [--output file] [--threads n] [--list file] [--verify] file|wildcard|directory...\n"
+		"directories are searched with their subdirectories, --list reads one file per line,\n"
+		"--verify checks checksums of binary curve files");
+}
+
+/**
+ * BatchMetrics class constructor reads options and files from the command line
+ * and opens the output, the standard output if no file is given
+ * @param _arguments command line
+ * @throw 1016 invalid option or no files
+ * @throw 1007 the output cannot be written
+ */
+BatchMetrics::BatchMetrics(const QStringList &_arguments):
+	format(CsvFormat), firstRow(true), failed(false)
+{
+	QString outputPath;
+	bool formatSet = false;
+	for (int i = 1; i < _arguments.size(); i++) {
+		const QString &argument = _arguments[i];
+		if (argument == "--metrics") {
+			continue;
+		}
+		if (!argument.startsWith("--")) {
+			addFiles(argument);
+			continue;
+		}
+		if (argument == "--verify") {
+			CurveData::setVerifyChecksums(true);
+			continue;
+		}
+
+		///other options take a value
+		if (i + 1 >= _arguments.size()) {
+			throw 1016;
+		}
+		QString value = _arguments[++i];
+		if (argument == "--format") {
+			if (value.compare("csv", Qt::CaseInsensitive) == 0) {
+				format = CsvFormat;
+			}
+			else if (value.compare("json", Qt::CaseInsensitive) == 0) {
+				format = JsonFormat;
+			}
+			else {
+				throw 1016;
+			}
+			formatSet = true;
+		}
+		else if (argument == "--output") {
+			outputPath = value;
+		}
+		else if (argument == "--threads") {
+			bool ok = false;
+			int threads = value.toInt(&ok);
+			if (!ok || threads <= 0) {
+				throw 1016;
+			}
+			QThreadPool::globalInstance()->setMaxThreadCount(threads);
+		}
+		else if (argument == "--list") {
+			QFile list(value);
+			if (!list.open(QIODevice::ReadOnly | QIODevice::Text)) {
+				throw 1016;
+			}
+			QTextStream stream(&list);
+			while (!stream.atEnd()) {
+				QString line = stream.readLine().trimmed();
+				if (!line.isEmpty()) {
+					files.append(line);
+				}
+			}
+		}
+		else {
+			throw 1016;
+		}
+	}
+	if (files.isEmpty()) {
+		throw 1016;
+	}
+
+	///format follows the extension of the output, unless it is given
+	if (!formatSet && QFileInfo(outputPath).suffix().compare("json", Qt::CaseInsensitive) == 0) {
+		format = JsonFormat;
+	}
+	bool opened;
+	if (outputPath.isEmpty()) {
+		opened = output.open(stdout, QIODevice::WriteOnly);
+	}
+	else {
+		output.setFileName(outputPath);
+		opened = output.open(QIODevice::WriteOnly | QIODevice::Truncate);
+	}
+	if (!opened) {
+		throw 1007;
+	}
+}
+
+/**
+ * Measures all files. While a chunk of files is measured by the thread pool,
+ * rows of the previous chunk are written, so the output streams in the order of files.
+ * @return 0 if all files were measured, 1 otherwise
+ */
+int BatchMetrics::run()
+{
+	int chunk = qMax(1, QThreadPool::globalInstance()->maxThreadCount() * int(FILES_PER_THREAD));
+	QVector<MetricsTask> chunks[2];
+	QFuture<void> measuring;
+	int current = 0;
+
+	writeHeader();
+	for (int begin = 0; begin < files.size(); begin += chunk) {
+		QVector<MetricsTask> &tasks = chunks[current];
+		tasks.resize(qMin(chunk, files.size() - begin));
+		for (int t = 0; t < tasks.size(); t++) {
+			tasks[t].path = files[begin + t];
+		}
+		QFuture<void> started = QtConcurrent::map(tasks, measureTask);
+
+		measuring.waitForFinished();
+		writeRows(chunks[1 - current]);
+		measuring = started;
+		current = 1 - current;
+	}
+	measuring.waitForFinished();
+	writeRows(chunks[1 - current]);
+	writeFooter();
+	output.close();
+
+	return failed ? 1 : 0;
+}
+
+/**
+ * Adds files of a command line argument. Wildcards are matched in their directory,
+ * directories are searched with their subdirectories, in order of paths.
+ * @param _argument file, wildcard or directory
+ */
+void BatchMetrics::addFiles(QString _argument)
+{
+	QFileInfo info(_argument);
+	QStringList found;
+	if (info.isDir()) {
+		QDirIterator it(_argument, QDir::Files, QDirIterator::Subdirectories);
+		while (it.hasNext()) {
+			QString path = it.next();
+			if (isMeasured(path)) {
+				found.append(path);
+			}
+		}
+	}
+	else if (_argument.contains(QRegExp("[*?\\[]"))) {
+		QDir dir = info.dir();
+		QStringList names = dir.entryList(QStringList(info.fileName()), QDir::Files);
+		for (int n = 0; n < names.size(); n++) {
+			found.append(dir.filePath(names[n]));
+		}
+	}
+	else {
+		files.append(_argument);
+		return;
+	}
+	found.sort();
+	files += found;
+}
+
+/**
+ * Checks if a file found in a directory is measured
+ * @param _path path of the file
+ * @return true for curve, score and sketch files
+ */
+bool BatchMetrics::isMeasured(QString _path)
+{
+	QString suffix = QFileInfo(_path).suffix().toLower();
+	return suffix == "roc" || suffix == "rocb" || suffix == "pr" || suffix == "prb"
+		|| ScoreSet::isScoreFile(_path) || ScoreSketch::isSketchFile(_path);
+}
+
+/**
+ * Writes the beginning of the output, the CSV header or the opening of the JSON array
+ */
+void BatchMetrics::writeHeader()
+{
+	if (format == CsvFormat) {
+		output.write("path,curve,points,auc,auc_error,eer,max_f1,youden,tpr_at_fpr_1e-3,tpr_at_fpr_1e-4,break_even,error\n");
+	}
+	else {
+		output.write("[");
+	}
+}
+
+/**
+ * Writes rows of measured files and releases them
+ * @param _tasks measured files
+ */
+void BatchMetrics::writeRows(QVector<MetricsTask> &_tasks)
+{
+	for (int t = 0; t < _tasks.size(); t++) {
+		for (int r = 0; r < _tasks[t].rows.size(); r++) {
+			writeRow(_tasks[t].rows[r]);
+		}
+	}
+	_tasks.clear();
+	output.flush();
+}
+
+/**
+ * Writes one row, as a CSV line or a JSON object. Measures which are not available
+ * are empty in CSV and null in JSON.
+ * @param _row measures of a curve
+ */
+void BatchMetrics::writeRow(const MetricsRow &_row)
+{
+	const OperatingPoints &op = _row.operating;
+	double values[] = { _row.auc, _row.aucError, op.eer, op.maxF1, op.youden, op.tprAt1e3, op.tprAt1e4, op.breakEven };
+	int count = int(sizeof(values) / sizeof(values[0]));
+	failed = failed || !_row.error.isEmpty();
+
+	QString line;
+	if (format == CsvFormat) {
+		line = csvField(_row.path) + "," + _row.curve + "," + QString::number(_row.points);
+		for (int v = 0; v < count; v++) {
+			line += "," + formatValue(values[v], "");
+		}
+		line += "," + csvField(_row.error) + "\n";
+	}
+	else {
+		static const char *keys[] = { "auc", "auc_error", "eer", "max_f1", "youden", "tpr_at_fpr_1e-3", "tpr_at_fpr_1e-4", "break_even" };
+		line = firstRow ? "\n" : ",\n";
+		line += "{\"path\":" + jsonString(_row.path) + ",\"curve\":\"" + _row.curve + "\",\"points\":" + QString::number(_row.points);
+		for (int v = 0; v < count; v++) {
+			line += QString(",\"%1\":").arg(keys[v]) + formatValue(values[v], "null");
+		}
+		line += ",\"error\":" + (_row.error.isEmpty() ? QString("null") : jsonString(_row.error)) + "}";
+	}
+	firstRow = false;
+	output.write(line.toUtf8());
+}
+
+/**
+ * Writes the end of the output, the closing of the JSON array
+ */
+void BatchMetrics::writeFooter()
+{
+	if (format == JsonFormat) {
+		output.write("\n]\n");
+	}
+}
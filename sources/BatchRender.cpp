@@ -0,0 +1,452 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+#include "../headers/BatchRender.h"
+#include "../headers/Curve.h"
+#include "../headers/CurveCache.h"
+#include "../headers/ErrorCodes.h"
+#include "../headers/Plot.h"
+#include "../headers/ScoreSet.h"
+#include "../headers/ScoreSketch.h"
+#include <iostream>
+#include <QtConcurrentMap>
+#include <QFuture>
+#include <QThreadPool>
+#include <qdir.h>
+#include <qfile.h>
+#include <qfileinfo.h>
+#include <qregexp.h>
+#include <qtextstream.h>
+#include <qimage.h>
+#include <qimagewriter.h>
+#include <qpainter.h>
+#include <qprinter.h>
+#include <qwt_plot.h>
+#include <qwt_plot_canvas.h>
+#include <qwt_plot_renderer.h>
+#include <qwt_legend.h>
+#include <qwt_text.h>
+#ifndef QWT_NO_SVG
+#include <qsvggenerator.h>
+#endif
+
+/**
+ * Resolution of written documents, the one used by the export dialog
+ */
+static const int DOCUMENT_RESOLUTION = 85;
+
+/**
+ * Loads curves of all files of a plot, files which cannot be loaded are left out
+ * @param _job plot
+ */
+static void loadJob(RenderJob &_job)
+{
+	for (int f = 0; f < _job.files.size(); f++) {
+		try {
+			QSharedPointer<CurveData> data = CurveCache::instance()->acquire(_job.files[f]);
+			if (data->getError() != 0) {
+				_job.errors.append(_job.files[f] + ": " + ErrorCodes::message(data->getError()));
+			}
+			_job.curves.append(data);
+		}
+		catch(int e) {
+			_job.errors.append(_job.files[f] + ": " + ErrorCodes::message(e));
+		}
+	}
+}
+
+/**
+ * Replays the recorded plot into its own image or document and writes it
+ * @param _job plot
+ */
+static void paintJob(RenderJob &_job)
+{
+	if (_job.picture.isNull()) {
+		return;
+	}
+	const RenderOptions &options = *_job.options;
+	QPainter painter;
+	bool written = false;
+
+	if (options.format == "pdf" || options.format == "ps") {
+#ifndef QT_NO_PRINTER
+		QPrinter printer;
+		printer.setOutputFormat(options.format == "pdf" ? QPrinter::PdfFormat : QPrinter::PostScriptFormat);
+		printer.setOutputFileName(_job.output);
+		printer.setFullPage(true);
+		printer.setResolution(DOCUMENT_RESOLUTION);
+		printer.setPaperSize(QSizeF(options.size), QPrinter::DevicePixel);
+		if (painter.begin(&printer)) {
+			painter.drawPicture(0, 0, _job.picture);
+			written = painter.end();
+		}
+#endif
+	}
+#ifndef QWT_NO_SVG
+	else if (options.format == "svg") {
+		QSvgGenerator generator;
+		generator.setFileName(_job.output);
+		generator.setSize(options.size);
+		generator.setViewBox(QRect(QPoint(0, 0), options.size));
+		generator.setResolution(DOCUMENT_RESOLUTION);
+		if (painter.begin(&generator)) {
+			painter.drawPicture(0, 0, _job.picture);
+			written = painter.end();
+		}
+	}
+#endif
+	else {
+		QImage image(options.size, QImage::Format_ARGB32);
+		image.fill(QColor(Qt::white).rgb());
+		painter.begin(&image);
+		painter.drawPicture(0, 0, _job.picture);
+		painter.end();
+		written = image.save(_job.output, options.format.toAscii().constData());
+	}
+
+	_job.written = written;
+	if (!written) {
+		_job.errors.append(_job.output + ": " + ErrorCodes::message(1007));
+	}
+	///the picture is not needed any more
+	_job.picture = QPicture();
+}
+
+/**
+ * Name of a curve in the legend, the name of its file
+ * @param _path path of the curve, see ScoreSet::curvePath
+ * @return name of the file
+ */
+static QString curveName(QString _path)
+{
+	QString file = _path;
+	int type;
+	ScoreSet::splitCurvePath(_path, file, type);
+	return QFileInfo(file).fileName();
+}
+
+/**
+ * Checks if the program was started to render plots to files
+ * @param _arguments command line
+ * @return true if the command line holds --render
+ */
+bool BatchRender::isRenderCommand(const QStringList &_arguments)
+{
+	return _arguments.contains("--render");
+}
+
+/**
+ * Describes the command line of batch rendering
+ * @return usage text
+ */
+QString BatchRender::usage()
+{
+	return QString("usage: --render [--type roc|pr] [--title text] [--xlabel text] [--ylabel text] [--grid]\n"
+		"  [--size WxH] [--format png|svg|pdf|ps|...] [--output dir] [--threads n] [--list file] plot...\n"
+		"every plot is a comma separated list of files or wildcards, --list reads one plot per line");
+}
+
+/**
+ * BatchRender class constructor reads options and plots from the command line
+ * and finds files of every plot
+ * @param _arguments command line
+ * @throw 1016 invalid option or no plots
+ */
+BatchRender::BatchRender(const QStringList &_arguments)
+{
+	options.type = Plot::ROC_CURVE;
+	options.grid = false;
+	options.size = QSize(800, 600);
+	options.format = "png";
+	options.directory = ".";
+	bool xLabelSet = false, yLabelSet = false;
+
+	QStringList plots;
+	for (int i = 1; i < _arguments.size(); i++) {
+		const QString &argument = _arguments[i];
+		if (argument == "--render") {
+			continue;
+		}
+		if (argument == "--grid") {
+			options.grid = true;
+			continue;
+		}
+		if (!argument.startsWith("--")) {
+			plots.append(argument);
+			continue;
+		}
+
+		///other options take a value
+		if (i + 1 >= _arguments.size()) {
+			throw 1016;
+		}
+		QString value = _arguments[++i];
+		if (argument == "--type") {
+			if (value.compare("roc", Qt::CaseInsensitive) == 0) {
+				options.type = Plot::ROC_CURVE;
+			}
+			else if (value.compare("pr", Qt::CaseInsensitive) == 0) {
+				options.type = Plot::PR_CURVE;
+			}
+			else {
+				throw 1016;
+			}
+		}
+		else if (argument == "--title") {
+			options.title = value;
+		}
+		else if (argument == "--xlabel") {
+			options.xLabel = value;
+			xLabelSet = true;
+		}
+		else if (argument == "--ylabel") {
+			options.yLabel = value;
+			yLabelSet = true;
+		}
+		else if (argument == "--size") {
+			QRegExp size("(\\d+)x(\\d+)");
+			if (!size.exactMatch(value) || size.cap(1).toInt() <= 0 || size.cap(2).toInt() <= 0) {
+				throw 1016;
+			}
+			options.size = QSize(size.cap(1).toInt(), size.cap(2).toInt());
+		}
+		else if (argument == "--format") {
+			options.format = value.toLower();
+			bool supported = QImageWriter::supportedImageFormats().contains(options.format.toAscii());
+#ifndef QT_NO_PRINTER
+			supported = supported || options.format == "pdf" || options.format == "ps";
+#endif
+#ifndef QWT_NO_SVG
+			supported = supported || options.format == "svg";
+#endif
+			if (!supported) {
+				throw 1016;
+			}
+		}
+		else if (argument == "--output") {
+			options.directory = value;
+			if (!QDir().mkpath(value)) {
+				throw 1016;
+			}
+		}
+		else if (argument == "--threads") {
+			bool ok = false;
+			int threads = value.toInt(&ok);
+			if (!ok || threads <= 0) {
+				throw 1016;
+			}
+			QThreadPool::globalInstance()->setMaxThreadCount(threads);
+		}
+		else if (argument == "--list") {
+			QFile list(value);
+			if (!list.open(QIODevice::ReadOnly | QIODevice::Text)) {
+				throw 1016;
+			}
+			QTextStream stream(&list);
+			while (!stream.atEnd()) {
+				QString line = stream.readLine().trimmed();
+				if (!line.isEmpty()) {
+					plots.append(line);
+				}
+			}
+		}
+		else {
+			throw 1016;
+		}
+	}
+
+	///axis titles of the interactive plots
+	if (!xLabelSet) {
+		options.xLabel = options.type == Plot::ROC_CURVE ? "False Positive Rate" : "Recall";
+	}
+	if (!yLabelSet) {
+		options.yLabel = options.type == Plot::ROC_CURVE ? "True Positive Rate" : "Precision";
+	}
+	if (plots.isEmpty()) {
+		throw 1016;
+	}
+	for (int p = 0; p < plots.size(); p++) {
+		addPlot(plots[p]);
+	}
+}
+
+/**
+ * Renders all plots. Plots are loaded and painted in chunks of a few plots per thread:
+ * while the GUI thread records a chunk, the previous chunk is painted by workers.
+ * Written files are printed to the standard output, errors to the standard error.
+ * @return 0 if all plots were written without errors, 1 otherwise
+ */
+int BatchRender::run()
+{
+	int chunk = qMax(1, QThreadPool::globalInstance()->maxThreadCount() * int(JOBS_PER_THREAD));
+	QFuture<void> painting;
+	for (int begin = 0; begin < jobs.size(); begin += chunk) {
+		int end = qMin(jobs.size(), begin + chunk);
+		QtConcurrent::blockingMap(jobs.begin() + begin, jobs.begin() + end, loadJob);
+		for (int j = begin; j < end; j++) {
+			record(jobs[j]);
+		}
+		painting.waitForFinished();
+		painting = QtConcurrent::map(jobs.begin() + begin, jobs.begin() + end, paintJob);
+	}
+	painting.waitForFinished();
+
+	bool failed = false;
+	for (int j = 0; j < jobs.size(); j++) {
+		for (int e = 0; e < jobs[j].errors.size(); e++) {
+			std::cerr << qPrintable(jobs[j].errors[e]) << std::endl;
+		}
+		if (jobs[j].written) {
+			std::cout << qPrintable(jobs[j].output) << std::endl;
+		}
+		failed = failed || !jobs[j].errors.isEmpty();
+	}
+	return failed ? 1 : 0;
+}
+
+/**
+ * Adds a plot to the batch. Score files and sketches give the curve of the plot type,
+ * curve files of the other type and of unknown types are reported and left out.
+ * @param _spec comma separated list of files or wildcards
+ */
+void BatchRender::addPlot(QString _spec)
+{
+	RenderJob job;
+	job.spec = _spec;
+	job.output = outputName(_spec);
+	job.options = &options;
+	job.written = false;
+
+	QStringList files = expand(_spec);
+	for (int f = 0; f < files.size(); f++) {
+		QString extension = QFileInfo(files[f]).suffix().toLower();
+		if (extension == "roc" || extension == "rocb" || extension == "pr" || extension == "prb") {
+			bool roc = extension.startsWith("roc");
+			if (roc == (options.type == Plot::ROC_CURVE)) {
+				job.files.append(files[f]);
+			}
+			else {
+				job.errors.append(files[f] + ": curve of the other plot type, left out");
+			}
+		}
+		else if (ScoreSet::isScoreFile(files[f]) || ScoreSketch::isSketchFile(files[f])) {
+			job.files.append(ScoreSet::curvePath(files[f], options.type));
+		}
+		else {
+			job.errors.append(files[f] + ": " + ErrorCodes::message(1000));
+		}
+	}
+	if (job.files.isEmpty()) {
+		job.errors.append(_spec + ": no curves to render");
+	}
+	jobs.append(job);
+}
+
+/**
+ * Finds files of a plot. Wildcards are matched in their directory, in order of names.
+ * @param _spec comma separated list of files or wildcards
+ * @return paths of files
+ */
+QStringList BatchRender::expand(QString _spec) const
+{
+	QStringList files;
+	QStringList parts = _spec.split(',', QString::SkipEmptyParts);
+	for (int p = 0; p < parts.size(); p++) {
+		QString part = parts[p].trimmed();
+		if (!part.contains(QRegExp("[*?\\[]"))) {
+			files.append(part);
+			continue;
+		}
+		QFileInfo info(part);
+		QDir dir = info.dir();
+		QStringList names = dir.entryList(QStringList(info.fileName()), QDir::Files, QDir::Name);
+		for (int n = 0; n < names.size(); n++) {
+			files.append(dir.filePath(names[n]));
+		}
+	}
+	return files;
+}
+
+/**
+ * Chooses the file written for a plot, named after its files, e.g. runs_exp1_scores.png
+ * for runs/exp1/*.scores. Plots which would share a name are numbered.
+ * @param _spec comma separated list of files or wildcards
+ * @return path of the written file
+ */
+QString BatchRender::outputName(QString _spec)
+{
+	QString base = _spec;
+	base.replace(QRegExp("[^A-Za-z0-9]+"), "_");
+	base.remove(QRegExp("^_+|_+$"));
+	if (base.isEmpty()) {
+		base = "plot";
+	}
+	QString name = base;
+	for (int n = 2; outputs.contains(name); n++) {
+		name = QString("%1_%2").arg(base).arg(n);
+	}
+	outputs.append(name);
+	return QDir(options.directory).filePath(name + "." + options.format);
+}
+
+/**
+ * Lays out a plot with its curves, styled by Plot like the interactive plot, and records it
+ * by QwtPlotRenderer into a picture. Widgets must live in the GUI thread, so this
+ * is the only part of a plot done there. Data of the curves is released afterwards.
+ * @param _job plot
+ */
+void BatchRender::record(RenderJob &_job) const
+{
+	if (_job.curves.isEmpty()) {
+		return;
+	}
+
+	QwtPlot plot;
+	plot.setTitle(options.title.isEmpty() ? _job.spec : options.title);
+	plot.setAxisTitle(QwtPlot::xBottom, options.xLabel);
+	plot.setAxisTitle(QwtPlot::yLeft, options.yLabel);
+	plot.insertLegend(new QwtLegend, QwtPlot::RightLegend);
+	Plot::applyStyle(&plot);
+	if (options.grid) {
+		Plot::createGrid()->attach(&plot);
+	}
+
+	///curves are owned and deleted by the plot
+	for (int i = 0; i < _job.curves.size(); i++) {
+		Curve *curve = new Curve(QwtText(curveName(_job.curves[i]->getPath())));
+		curve->setRenderHint(QwtPlotItem::RenderAntialiased);
+		curve->setCurveData(_job.curves[i]);
+		curve->init(_job.curves[i]->getAUC(), Plot::curveColor(i));
+		curve->setColor(Plot::curveColor(i));
+		curve->attach(&plot);
+	}
+	plot.resize(options.size);
+
+	QwtPlotRenderer renderer;
+	renderer.setDiscardFlag(QwtPlotRenderer::DiscardBackground, false);
+	renderer.setLayoutFlag(QwtPlotRenderer::KeepFrames, true);
+	QPainter painter(&_job.picture);
+	renderer.render(&plot, &painter, QRectF(QPointF(0.0, 0.0), QSizeF(options.size)));
+	painter.end();
+
+	_job.curves.clear();
+}
@@ -0,0 +1,338 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/BinaryCurve.h"
+#include "../headers/fileProxy.h"
+#include "../headers/CurveLoader.h"
+#include <QByteArray>
+#include <QFileInfo>
+#include <cstring>
+
+static const char binaryMagic[4] = { 'Z', 'P', 'R', 'C' };
+
+/**
+ * Constructor of BinaryCurveFile class
+ * @param _path path of file
+ */
+BinaryCurveFile::BinaryCurveFile(QString _path):
+	file(_path), header(0), doubles(0), floats(0), summary(0), summarySize(0)
+{
+}
+
+/**
+ * Destructor of BinaryCurveFile class. Closing the file releases the mapping.
+ */
+BinaryCurveFile::~BinaryCurveFile()
+{
+	file.close();
+}
+
+/**
+ * Maps the file into memory and checks its header and size. The samples are
+ * not read, so opening takes the same time for any file; see verify.
+ * @throw 1005 the file is not a valid binary curve file
+ */
+void BinaryCurveFile::open()
+{
+	if (!file.open(QIODevice::ReadOnly)) {
+		throw 1005;
+	}
+	qint64 fileSize = file.size();
+	if (fileSize < qint64(sizeof(BinaryCurveHeader))) {
+		throw 1005;
+	}
+	const uchar *map = file.map(0, fileSize);
+	if (!map) {
+		throw 1005;
+	}
+
+	header = reinterpret_cast<const BinaryCurveHeader*>(map);
+	if (memcmp(header->magic, binaryMagic, sizeof(binaryMagic)) != 0 || header->version != VERSION) {
+		throw 1005;
+	}
+
+	///the file has to hold exactly count pairs of samples followed by their summary
+	qint64 sampleSize = (header->flags & FloatSamples) ? sizeof(float) : sizeof(double);
+	qint64 dataSize = fileSize - qint64(sizeof(BinaryCurveHeader));
+	if (header->count > quint64(dataSize / (2 * sampleSize))) {
+		throw 1005;
+	}
+	qint64 samplesSize = qint64(header->count) * 2 * sampleSize;
+	summarySize = qint64(sizeof(OperatingPoints)) + CurvePyramid::storedSize(size_t(header->count));
+	if (samplesSize + summarySize != dataSize) {
+		throw 1005;
+	}
+
+	const uchar *data = map + sizeof(BinaryCurveHeader);
+	if (header->flags & FloatSamples) {
+		floats = reinterpret_cast<const float*>(data);
+	}
+	else {
+		doubles = reinterpret_cast<const double*>(data);
+	}
+	summary = data + samplesSize;
+}
+
+/**
+ * Verifies the checksum of the samples and their summary, which reads the whole file.
+ * It is done only on demand, see CurveData::setVerifyChecksums.
+ * @param _observer optional object notified about progress of the verification
+ * @throw 1004 verification was cancelled by the observer
+ * @throw 1006 checksum does not match
+ */
+void BinaryCurveFile::verify(LoadObserver *_observer) const
+{
+	const uchar *data = reinterpret_cast<const uchar*>(header) + sizeof(BinaryCurveHeader);
+	qint64 dataSize = (summary - data) + summarySize;
+
+	///verify the checksum in chunks, so that progress can be reported
+	const qint64 chunkSize = 16 * 1024 * 1024;
+	///checksum of an empty block is the initial seed
+	quint64 sum = checksum(data, 0);
+	for (qint64 done = 0; done < dataSize; done += chunkSize) {
+		qint64 length = (dataSize - done > chunkSize) ? chunkSize : dataSize - done;
+		sum = checksum(data + done, length, sum);
+		if (_observer && !_observer->progress(done + length, dataSize)) {
+			throw 1004;
+		}
+	}
+	if (sum != header->checksum) {
+		throw 1006;
+	}
+}
+
+/**
+ * @return number of points stored in the file
+ */
+size_t BinaryCurveFile::size() const
+{
+	return header ? size_t(header->count) : 0;
+}
+
+/**
+ * Return i-th sample read directly from the mapping
+ * @param i which sample to return
+ * @return i-th sample
+ */
+QPointF BinaryCurveFile::sample(size_t i) const
+{
+	if (floats) {
+		return QPointF(floats[2*i], floats[2*i + 1]);
+	}
+	return QPointF(doubles[2*i], doubles[2*i + 1]);
+}
+
+/**
+ * @return bounding rect of the points stored in the header
+ */
+QRectF BinaryCurveFile::boundingRect() const
+{
+	if (!header || header->count == 0) {
+		return QRectF();
+	}
+	return QRectF(header->left, header->top, header->right - header->left, header->bottom - header->top);
+}
+
+/**
+ * @return area under the curve stored in the header
+ */
+double BinaryCurveFile::getAUC() const
+{
+	return header ? header->auc : 0.0;
+}
+
+/**
+ * @return true if x values of the samples do not decrease, as found at conversion
+ */
+bool BinaryCurveFile::isMonotone() const
+{
+	return header && (header->flags & MonotoneSamples);
+}
+
+/**
+ * @return operating points found at conversion
+ */
+OperatingPoints BinaryCurveFile::getOperatingPoints() const
+{
+	OperatingPoints operating;
+	if (summary) {
+		memcpy(&operating, summary, sizeof(OperatingPoints));
+	}
+	return operating;
+}
+
+/**
+ * Lets a pyramid use the levels stored after the samples, they stay mapped
+ * as long as this object exists
+ * @param _pyramid pyramid of the samples
+ */
+void BinaryCurveFile::mapPyramid(CurvePyramid &_pyramid) const
+{
+	if (summary) {
+		_pyramid.map(summary + sizeof(OperatingPoints), size());
+	}
+}
+
+/**
+ * Computes checksum of a block of samples. The block is processed in 64-bit words,
+ * so that checking a mapped file takes as little time as possible.
+ * Blocks can be checked one by one by passing the previous result as a seed,
+ * all blocks but the last one have to be a multiple of 8 bytes long.
+ * @param _data beginning of the block
+ * @param _size size of the block in bytes
+ * @param _seed checksum of the preceding blocks
+ * @return checksum
+ */
+quint64 BinaryCurveFile::checksum(const uchar *_data, qint64 _size, quint64 _seed)
+{
+	const quint64 prime = Q_UINT64_C(0x100000001b3);
+	quint64 sum = _seed;
+
+	qint64 words = _size / 8;
+	for (qint64 i = 0; i < words; i++) {
+		quint64 word;
+		memcpy(&word, _data + 8 * i, 8);
+		sum = (sum ^ word) * prime;
+		sum ^= sum >> 32;
+	}
+	for (qint64 i = words * 8; i < _size; i++) {
+		sum = (sum ^ _data[i]) * prime;
+	}
+	return sum;
+}
+
+/**
+ * Converts a text curve file into the binary format.
+ * The AUC, the bounding rect, monotonicity, operating points and the pyramid are computed once,
+ * from the samples as they are stored, and kept in the file. PR curves are written to .prb files.
+ * @param _source path of the text file
+ * @param _target path of the binary file to be written
+ * @param _floatSamples store samples as floats instead of doubles
+ * @throw 1001 unsupported structure of the text file
+ * @throw 1002 number conversion failed
+ * @throw 1003 too few points to compute the AUC
+ * @throw 1007 the binary file cannot be written
+ */
+void BinaryCurveFile::convert(QString _source, QString _target, bool _floatSamples)
+{
+	RealFile source(_source);
+	const QVector<QPointF> &points = *source.getData();
+	int count = points.size();
+
+	BinaryCurveHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, binaryMagic, sizeof(binaryMagic));
+	h.version = VERSION;
+	h.flags = _floatSamples ? FloatSamples : 0;
+	h.count = count;
+
+	///float samples are rounded, the header describes what is loaded back
+	QVector<QPointF> rounded;
+	if (_floatSamples) {
+		rounded.resize(count);
+		for (int i = 0; i < count; i++) {
+			rounded[i] = QPointF(float(points[i].x()), float(points[i].y()));
+		}
+	}
+	const QVector<QPointF> &stored = _floatSamples ? rounded : points;
+
+	h.auc = CurveLoader::computeAUC(stored);
+
+	bool monotone;
+	QRectF rect = FunctionData::computeBoundingRect(stored.constData(), count, monotone);
+	h.left = rect.left();
+	h.top = rect.top();
+	h.right = rect.right();
+	h.bottom = rect.bottom();
+	if (monotone) {
+		h.flags |= MonotoneSamples;
+	}
+
+	bool pr = QFileInfo(_target).suffix().compare("prb", Qt::CaseInsensitive) == 0;
+	OperatingPoints operating = Metrics::operatingPoints(stored.constData(), count,
+		pr ? OperatingPointScan::PR_CURVE : OperatingPointScan::ROC_CURVE);
+	CurvePyramid pyramid;
+	FunctionData series(&stored, rect, monotone);
+	pyramid.build(series);
+
+	///samples are stored as x, y pairs
+	QByteArray samples;
+	if (_floatSamples) {
+		QVector<float> values(2 * count);
+		for (int i = 0; i < count; i++) {
+			values[2*i] = float(stored[i].x());
+			values[2*i + 1] = float(stored[i].y());
+		}
+		samples = QByteArray(reinterpret_cast<const char*>(values.constData()), values.size() * sizeof(float));
+	}
+	else {
+		QVector<double> values(2 * count);
+		for (int i = 0; i < count; i++) {
+			values[2*i] = points[i].x();
+			values[2*i + 1] = points[i].y();
+		}
+		samples = QByteArray(reinterpret_cast<const char*>(values.constData()), values.size() * sizeof(double));
+	}
+	samples.append(reinterpret_cast<const char*>(&operating), sizeof(OperatingPoints));
+	samples.append(pyramid.save());
+	h.checksum = checksum(reinterpret_cast<const uchar*>(samples.constData()), samples.size());
+
+	QFile target(_target);
+	if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		throw 1007;
+	}
+	if (target.write(reinterpret_cast<const char*>(&h), sizeof(h)) != qint64(sizeof(h))
+		|| target.write(samples) != samples.size()) {
+		target.remove();
+		throw 1007;
+	}
+}
+
+/**
+ * Constructor of MappedFunctionData class
+ * @param _file opened binary curve file
+ * @param _monotone true if x values of the samples do not decrease
+ */
+MappedFunctionData::MappedFunctionData(QSharedPointer<BinaryCurveFile> _file, bool _monotone):
+	FunctionData(0, _file->boundingRect(), _monotone), file(_file)
+{
+}
+
+/**
+ * Return i-th sample straight from the mapped file
+ * @param i which sample to return
+ * @return i-th sample
+ */
+QPointF MappedFunctionData::sample(size_t i) const
+{
+	return file->sample(i);
+}
+
+/**
+ * @return number of samples in the mapped file
+ */
+size_t MappedFunctionData::size() const
+{
+	return file->size();
+}
+
@@ -0,0 +1,356 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/Bootstrap.h"
+#include "../headers/Metrics.h"
+#include <QThread>
+#include <QHash>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * Examples of a score set in descending score order, prepared once for all replicates
+ */
+struct BootstrapData {
+	QVector<quint8> labels;
+	QVector<double> weights;
+	QVector<quint32> groupEnds;			///< end of every group of tied scores
+	QVector<quint32> positives;			///< positions of positive examples
+	QVector<quint32> negatives;			///< positions of negative examples
+};
+
+/**
+ * Replicates computed by one thread in one round, the thread reuses its draw counts.
+ * A count is kept in a byte, every wrap around of a byte adds 256 to overflow.
+ */
+struct BootstrapWorker {
+	const BootstrapData *data;
+	const QAtomicInt *cancelled;
+	int type;
+	quint64 seed;
+	int first;							///< first replicate of the round handled by the worker
+	int end;							///< end of the round
+	int step;							///< number of workers
+	double *aucs;						///< AUC of every replicate
+	double *rows;						///< GRID_POINTS values of every replicate
+	QVector<quint8> counts;
+	QHash<quint32, quint32> overflow;
+};
+
+/**
+ * Advances a splitmix64 random stream
+ * @param _state state of the stream
+ * @return next 64 random bits
+ */
+static inline quint64 nextRandom(quint64 &_state)
+{
+	quint64 z = (_state += Q_UINT64_C(0x9E3779B97F4A7C15));
+	z = (z ^ (z >> 30)) * Q_UINT64_C(0xBF58476D1CE4E5B9);
+	z = (z ^ (z >> 27)) * Q_UINT64_C(0x94D049BB133111EB);
+	return z ^ (z >> 31);
+}
+
+/**
+ * Draws an integer from [0, _bound) by scaling 32 random bits (multiply and shift)
+ * @param _state state of the stream
+ * @param _bound number of possible values
+ * @return random integer
+ */
+static inline quint32 randomBelow(quint64 &_state, quint32 _bound)
+{
+	return quint32(((nextRandom(_state) >> 32) * _bound) >> 32);
+}
+
+/**
+ * Stores values of a curve at the grid points lying left of the segment end.
+ * Grid points on a vertical segment take its upper end from the next segment.
+ * @param _row values at the grid points
+ * @param _next first grid point without a value, updated
+ * @param _from start of the segment
+ * @param _to end of the segment
+ */
+static inline void fillGrid(double *_row, int &_next, const QPointF &_from, const QPointF &_to)
+{
+	const double step = 1.0 / (Bootstrap::GRID_POINTS - 1);
+	while (_next < Bootstrap::GRID_POINTS && _next * step < _to.x()) {
+		double x = _next * step;
+		double t = _to.x() > _from.x() ? (x - _from.x()) / (_to.x() - _from.x()) : 1.0;
+		_row[_next++] = _from.y() + (_to.y() - _from.y()) * qMax(t, 0.0);
+	}
+}
+
+/**
+ * Computes one replicate: draws as many positive and negative examples as the set has,
+ * with replacement, and walks the sorted examples once, weighting them by their draws
+ * @param _worker worker computing the replicate, its counts are overwritten
+ * @param _replicate number of the replicate, selects its random stream
+ */
+static void computeReplicate(BootstrapWorker &_worker, int _replicate)
+{
+	const BootstrapData &data = *_worker.data;
+	quint8 *counts = _worker.counts.data();
+	std::fill(_worker.counts.begin(), _worker.counts.end(), quint8(0));
+	QHash<quint32, quint32> &overflow = _worker.overflow;
+	overflow.clear();
+
+	quint64 state = _worker.seed + quint64(_replicate) * Q_UINT64_C(0xD1B54A32D192ED03);
+	nextRandom(state);
+	quint32 positives = data.positives.size(), negatives = data.negatives.size();
+	double p = 0.0, n = 0.0;
+	for (quint32 i = 0; i < positives; i++) {
+		quint32 k = data.positives[randomBelow(state, positives)];
+		if (++counts[k] == 0) {
+			overflow[k] += 256;
+		}
+		p += data.weights[k];
+	}
+	for (quint32 i = 0; i < negatives; i++) {
+		quint32 k = data.negatives[randomBelow(state, negatives)];
+		if (++counts[k] == 0) {
+			overflow[k] += 256;
+		}
+		n += data.weights[k];
+	}
+
+	double *row = _worker.rows + qint64(_replicate) * Bootstrap::GRID_POINTS;
+	int next = 0;
+	CompensatedSum area;
+	double tp = 0.0, fp = 0.0;
+	QPointF last(0.0, 0.0);
+	bool first = true;
+	quint32 begin = 0;
+	for (int g = 0; g < data.groupEnds.size(); g++) {
+		quint32 end = data.groupEnds[g];
+		double groupTp = 0.0, groupFp = 0.0;
+		for (quint32 i = begin; i < end; i++) {
+			quint32 count = counts[i];
+			if (!overflow.isEmpty()) {
+				count += overflow.value(i);
+			}
+			if (count) {
+				(data.labels[i] ? groupTp : groupFp) += count * data.weights[i];
+			}
+		}
+		begin = end;
+		if (groupTp == 0.0 && groupFp == 0.0) {
+			continue;
+		}
+
+		if (_worker.type == ScoreSet::ROC_CURVE) {
+			area.add(groupFp * (2.0 * tp + groupTp));
+			tp += groupTp;
+			fp += groupFp;
+			QPointF point(fp / n, tp / p);
+			fillGrid(row, next, last, point);
+			last = point;
+		}
+		else {
+			tp += groupTp;
+			fp += groupFp;
+			QPointF point(tp / p, tp / (tp + fp));
+			if (first) {
+				last = QPointF(0.0, point.y());
+			}
+			area.add((last.y() + point.y()) * (point.x() - last.x()));
+			fillGrid(row, next, last, point);
+			last = point;
+		}
+		first = false;
+	}
+	while (next < Bootstrap::GRID_POINTS) {
+		row[next++] = last.y();
+	}
+
+	_worker.aucs[_replicate] = _worker.type == ScoreSet::ROC_CURVE
+		? area.result() / (2.0 * p * n) : 0.5 * area.result();
+}
+
+/**
+ * Computes the replicates of a round assigned to a worker
+ * @param _worker worker
+ */
+static void computeReplicates(BootstrapWorker &_worker)
+{
+	for (int r = _worker.first; r < _worker.end; r += _worker.step) {
+		if (*_worker.cancelled) {
+			return;
+		}
+		computeReplicate(_worker, r);
+	}
+}
+
+/**
+ * Bootstrap class constructor. The object is deleted by its owner, not by the thread pool.
+ * @param _scores score set with examples kept in memory
+ * @param _type ScoreSet::ROC_CURVE or ScoreSet::PR_CURVE
+ * @param _replicates number of replicates
+ * @param _level confidence level of intervals, e.g. 0.95
+ * @param _seed seed of random streams, equal seeds give equal results
+ */
+Bootstrap::Bootstrap(QSharedPointer<ScoreSet> _scores, int _type, int _replicates, double _level, quint64 _seed):
+	scores_(_scores), type_(_type), replicates_(qMax(_replicates, 1)), level_(_level),
+	seed_(_seed), curveId_(-1), cancelled_(0)
+{
+	setAutoDelete(false);
+	result_.replicates = 0;
+	result_.aucLow = result_.aucHigh = 0.0;
+}
+
+/**
+ * Computes replicates in rounds on the global thread pool. After every round
+ * intervals are updated and progressChanged is emitted. Emits finished when all
+ * replicates are done or the computation was cancelled.
+ * Called by the thread pool.
+ */
+void Bootstrap::run()
+{
+	BootstrapData data;
+	const ScoreSet &set = *scores_;
+	quint32 count = quint32(set.size());
+	const float *scores = set.getScores();
+	const quint8 *labels = set.getLabels();
+	const float *weights = set.getWeights();
+	const quint32 *order = set.getOrder();
+
+	///examples are laid out in sorted order, so replicates read them sequentially
+	data.labels.resize(count);
+	data.weights.resize(count);
+	for (quint32 i = 0; i < count; i++) {
+		quint32 k = order[i];
+		data.labels[i] = labels[k] ? 1 : 0;
+		data.weights[i] = weights ? weights[k] : 1.0;
+		(labels[k] ? data.positives : data.negatives).append(i);
+		if (i > 0 && scores[k] != scores[order[i - 1]]) {
+			data.groupEnds.append(i);
+		}
+	}
+	data.groupEnds.append(count);
+
+	if (data.positives.isEmpty() || data.negatives.isEmpty()) {
+		emit finished();
+		return;
+	}
+
+	aucs_.resize(replicates_);
+	rows_.resize(replicates_ * GRID_POINTS);
+
+	///draw counts of all threads fit in COUNTS_BUDGET, see the bound in Bootstrap.h
+	int threads = qMax(QThread::idealThreadCount(), 1);
+	threads = int(qMax(quint32(1), qMin(quint32(threads), quint32(COUNTS_BUDGET) / count)));
+	QVector<BootstrapWorker> workers(threads);
+	for (int t = 0; t < threads; t++) {
+		workers[t].data = &data;
+		workers[t].cancelled = &cancelled_;
+		workers[t].type = type_;
+		workers[t].seed = seed_;
+		workers[t].step = threads;
+		workers[t].aucs = aucs_.data();
+		workers[t].rows = rows_.data();
+		workers[t].counts.resize(count);
+	}
+
+	int done = 0;
+	while (done < replicates_ && !cancelled_) {
+		int end = qMin(replicates_, done + threads * ROUND_REPLICATES);
+		for (int t = 0; t < threads; t++) {
+			workers[t].first = done + t;
+			workers[t].end = end;
+		}
+		QtConcurrent::blockingMap(workers, computeReplicates);
+		if (cancelled_) {
+			break;
+		}
+		done = end;
+		publish(done);
+		emit progressChanged(done, replicates_);
+	}
+	emit finished();
+}
+
+/**
+ * Computes percentile intervals from the first replicates and stores them as the result
+ * @param _replicates number of finished replicates
+ */
+void Bootstrap::publish(int _replicates)
+{
+	double alpha = 0.5 * (1.0 - level_);
+	int low = int(std::floor(alpha * (_replicates - 1)));
+	int high = int(std::ceil((1.0 - alpha) * (_replicates - 1)));
+
+	BootstrapResult result;
+	result.replicates = _replicates;
+	QVector<double> values(aucs_.constBegin(), aucs_.constBegin() + _replicates);
+	std::nth_element(values.begin(), values.begin() + low, values.end());
+	result.aucLow = values[low];
+	std::nth_element(values.begin(), values.begin() + high, values.end());
+	result.aucHigh = values[high];
+
+	result.band.reserve(GRID_POINTS);
+	for (int g = 0; g < GRID_POINTS; g++) {
+		for (int r = 0; r < _replicates; r++) {
+			values[r] = rows_[r * GRID_POINTS + g];
+		}
+		std::nth_element(values.begin(), values.begin() + low, values.end());
+		double minimum = values[low];
+		std::nth_element(values.begin(), values.begin() + high, values.end());
+		result.band.append(QwtIntervalSample(double(g) / (GRID_POINTS - 1), minimum, values[high]));
+	}
+
+	QMutexLocker locker(&mutex_);
+	result_ = result;
+}
+
+/**
+ * Requests cancellation, the computation stops after the replicates in progress.
+ * Safe to call from any thread.
+ */
+void Bootstrap::cancel()
+{
+	cancelled_.fetchAndStoreOrdered(1);
+}
+
+/**
+ * @return intervals computed from the replicates finished so far, safe to call from any thread
+ */
+BootstrapResult Bootstrap::result()
+{
+	QMutexLocker locker(&mutex_);
+	return result_;
+}
+
+/**
+ * @param _id identifier of the curve the intervals belong to
+ */
+void Bootstrap::setCurveId(int _id)
+{
+	curveId_ = _id;
+}
+
+/**
+ * @return identifier of the curve the intervals belong to
+ */
+int Bootstrap::getCurveId()
+{
+	return curveId_;
+}
@@ -22,11 +22,18 @@
 
 
 #include "../headers/Curve.h"
+#include "../headers/FunctionData.h"
 
 #include <string>
 #include <qwt_text.h>
 #include <qstring.h>
 #include <qcolor.h>
+#include <qpen.h>
+#include <qwt_series_data.h>
+#include <qwt_scale_map.h>
+#include <qwt_painter.h>
+#include <qwt_clipper.h>
+#include <qpainter.h>
 
 using namespace std;
 
@@ -36,7 +43,7 @@ int Curve::id_ = 0;
 * Curve class constructor calls QwtPlotCurve constructor.
 * @param _title Plot title
 */
-Curve::Curve(const QwtText &_title) : QwtPlotCurve(_title) { }
+Curve::Curve(const QwtText &_title) : QwtPlotCurve(_title), auc_(0.0), aucError_(0.0), attached_(false), uid_(++id_) { }
 
 /**
 * Curve class init method initialize value of an area under the curve and curve color.
@@ -49,6 +56,26 @@ void Curve::init(double _auc, QColor _color)
 	color_ = _color;
 }
 
+/**
+* Curve class setAUCError method stores the largest error of the area under the curve,
+* which is not exact for curves built from score sketches.
+* @param _error error bound of the AUC
+*/
+void Curve::setAUCError(double _error)
+{
+	aucError_ = _error;
+}
+
+/**
+* Curve class setOperatingPoints method stores operating points of the curve,
+* so that they are available after its data is released.
+* @param _points operating points found when the curve was loaded
+*/
+void Curve::setOperatingPoints(const OperatingPoints &_points)
+{
+	operating_ = _points;
+}
+
 /**
 * Curve class setAttached method is used to store information 
 * if the curve is attached to the plot.
@@ -60,12 +87,38 @@ void Curve::setAttached(bool _attached)
 }
 
 /**
-* Curve class setIndex method is used to store information about curve index in plot curve vector
-* @param _index index of curve in a plot curve vector
+* Curve class setColor method changes color of the curve and its pen
+* @param _color new curve color
 */
-void Curve::setIndex(int _index)
+void Curve::setColor(QColor _color)
 {
-	index_ = _index;
+	color_ = _color;
+	setPen(QPen(_color));
+}
+	
+/**
+* Curve class setCurveData method displays loaded data of a file.
+* The curve keeps the data alive as long as it is displayed.
+* @param _data shared data of a curve file
+*/
+void Curve::setCurveData(QSharedPointer<CurveData> _data)
+{
+	data_ = _data;
+	setData(_data->createSeriesData());
+}
+
+/**
+* Curve class releaseCurveData method is called when the curve is detached.
+* It stops displaying the data and gives it away, so that it can be kept
+* in the curve cache or released.
+* @return data which was displayed by the curve
+*/
+QSharedPointer<CurveData> Curve::releaseCurveData()
+{
+	QSharedPointer<CurveData> data = data_;
+	setData(new QwtPointSeriesData());
+	data_.clear();
+	return data;
 }
 	
 /**
@@ -77,6 +130,24 @@ double Curve::getAUC()
 	return auc_;
 }
 
+/**
+ * Curve class getAUCError method is used to receive the largest error of the area under the curve
+ * @return error bound of the AUC, 0 if the AUC is exact
+ */
+double Curve::getAUCError()
+{
+	return aucError_;
+}
+
+/**
+ * Curve class getOperatingPoints method is used to receive operating points of the curve
+ * @return EER, max F1, Youden J, TPR at low FPR and break-even point, NaN where not available
+ */
+OperatingPoints Curve::getOperatingPoints()
+{
+	return operating_;
+}
+
 /**
  * Curve class getColor method is used to receive a color of the curve
  * @return curve color
@@ -106,10 +177,111 @@ bool Curve::isAttached()
 }
 
 /**
-* Curve class getIndex method is used to receive an index of a curve in plot curve vector
- * @return curve index
+* Curve class getId method is used to receive an identifier of a curve.
+* Identifiers are unique in the process and do not change while the curve exists.
+ * @return curve identifier
+*/
+int Curve::getId()
+{
+	return uid_;
+}
+
+/**
+* Curve class getCurveData method gives access to the data displayed by the curve
+* @return curve data, null if the curve is detached
 */
-int Curve::getIndex()
+QSharedPointer<CurveData> Curve::getCurveData()
 {
-	return index_;
-}
\ No newline at end of file
+	return data_;
+}
+
+/**
+* Curve class plotItem method gives access to the curve as a plot item,
+* which is used to find its legend item.
+* @return the curve as a plot item
+*/
+QwtPlotItem* Curve::plotItem()
+{
+	return this;
+}
+
+/**
+* Curve class seriesItem method gives access to the curve as a series item,
+* which is used to paint a part of its samples without replotting.
+* @return the curve as a series item
+*/
+QwtPlotAbstractSeriesItem* Curve::seriesItem()
+{
+	return this;
+}
+
+/**
+* Curve class drawSeries method draws the curve on the canvas. Samples outside of the visible
+* x interval are skipped when x values of the curve are monotone. When the visible range holds
+* many more samples than pixels, only samples chosen by the pyramid of the curve data
+* are drawn, which gives the same picture for the current zoom. Other curves, and curves
+* drawn with symbols or a brush, are drawn by QwtPlotCurve.
+* @param _painter painter of the canvas
+* @param _xMap map of x values to canvas coordinates
+* @param _yMap map of y values to canvas coordinates
+* @param _canvasRect contents rect of the canvas
+* @param _from index of the first sample to be drawn
+* @param _to index of the last sample to be drawn, -1 for the last sample of the curve
+*/
+void Curve::drawSeries(QPainter *_painter, const QwtScaleMap &_xMap, const QwtScaleMap &_yMap,
+	const QRectF &_canvasRect, int _from, int _to) const
+{
+	if (_to < 0) {
+		_to = int(dataSize()) - 1;
+	}
+
+	///series of a curve with data are created by CurveData, curves with monotone x
+	///values draw only the samples inside the visible x interval
+	const FunctionData *series = data_ ? static_cast<const FunctionData*>(data()) : 0;
+	if (series && series->isMonotone()) {
+		int from, to;
+		if (!series->visibleRange(_xMap.s1(), _xMap.s2(), from, to)) {
+			return;
+		}
+		_from = qMax(_from, from);
+		_to = qMin(_to, to);
+		if (_from > _to) {
+			return;
+		}
+	}
+
+	const CurvePyramid *pyramid = data_ ? data_->getPyramid() : 0;
+	double width = qMax(1.0, _canvasRect.width());
+	if (!pyramid || pyramid->levelCount() == 0 || style() != Lines || symbol() != NULL
+		|| brush().style() != Qt::NoBrush || _from < 0 || _to - _from < 4 * width) {
+		QwtPlotCurve::drawSeries(_painter, _xMap, _yMap, _canvasRect, _from, _to);
+		return;
+	}
+
+	QVector<int> indices;
+	pyramid->select(*data(), _xMap, _from, _to, width, indices);
+
+	///map selected samples the way QwtPlotCurve does it
+	bool doAlign = QwtPainter::roundingAlignment(_painter);
+	QPolygonF polyline(indices.size());
+	for (int i = 0; i < indices.size(); i++) {
+		QPointF point = sample(indices[i]);
+		double x = _xMap.transform(point.x());
+		double y = _yMap.transform(point.y());
+		if (doAlign) {
+			x = qRound(x);
+			y = qRound(y);
+		}
+		polyline[i] = QPointF(x, y);
+	}
+
+	if (testPaintAttribute(ClipPolygons)) {
+		qreal penWidth = qMax(qreal(1.0), pen().widthF());
+		polyline = QwtClipper::clipPolygonF(_canvasRect.adjusted(-penWidth, -penWidth, penWidth, penWidth), polyline);
+	}
+
+	_painter->save();
+	_painter->setPen(pen());
+	QwtPainter::drawPolyline(_painter, polyline);
+	_painter->restore();
+}
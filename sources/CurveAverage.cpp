@@ -0,0 +1,381 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/CurveAverage.h"
+#include "../headers/Metrics.h"
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <limits>
+
+/**
+ * Fold processed by one thread, with the averaging it is prepared for
+ */
+struct AverageTask {
+	AverageFold *fold;
+	int type;
+	int mode;
+	const QVector<double> *thresholds;
+};
+
+/**
+ * Resamples the curve of a fold onto the x grid. Every grid point takes the segment
+ * starting at the last point not right of it, so vertical runs give their upper end.
+ * @param _task fold
+ */
+static void resampleVertical(AverageTask &_task)
+{
+	AverageFold &fold = *_task.fold;
+	int count = CurveAverage::GRID_POINTS;
+	fold.x.resize(count);
+	fold.y.resize(count);
+	QVector<quint32> segments(count);
+
+	quint32 last = quint32(fold.points.size()) - 1, s = 0;
+	for (int g = 0; g < count; g++) {
+		fold.x[g] = double(g) / (count - 1);
+		while (s + 1 < last && fold.points[s + 1].x() <= fold.x[g]) {
+			s++;
+		}
+		segments[g] = s;
+	}
+	Metrics::interpolate(fold.points.constData(), segments.constData(), fold.x.constData(), count, fold.y.data());
+}
+
+/**
+ * Sorts scores of a fold and sums weights of its examples in that order,
+ * so that the point of the fold at any threshold is found by binary search
+ * @param _task fold
+ */
+static void prepareThresholds(AverageTask &_task)
+{
+	AverageFold &fold = *_task.fold;
+	if (!fold.sorted.isEmpty()) {
+		return;
+	}
+	const ScoreSet &set = *fold.scores;
+	int count = int(set.size());
+	const float *scores = set.getScores();
+	const quint8 *labels = set.getLabels();
+	const float *weights = set.getWeights();
+	const quint32 *order = set.getOrder();
+
+	fold.sorted.resize(count);
+	fold.hits.resize(count + 1);
+	fold.misses.resize(count + 1);
+	fold.hits[0] = fold.misses[0] = 0.0;
+	for (int i = 0; i < count; i++) {
+		quint32 k = order[i];
+		double w = weights ? weights[k] : 1.0;
+		fold.sorted[i] = scores[k];
+		fold.hits[i + 1] = fold.hits[i] + (labels[k] ? w : 0.0);
+		fold.misses[i + 1] = fold.misses[i] + (labels[k] ? 0.0 : w);
+	}
+}
+
+/**
+ * Finds points of a fold at the common thresholds: (FPR, TPR) for ROC curves,
+ * (recall, precision) for PR curves
+ * @param _task fold
+ */
+static void sampleThresholds(AverageTask &_task)
+{
+	AverageFold &fold = *_task.fold;
+	const QVector<double> &thresholds = *_task.thresholds;
+	int count = thresholds.size(), n = fold.sorted.size();
+	double positives = fold.hits[n], negatives = fold.misses[n];
+	fold.x.resize(count);
+	fold.y.resize(count);
+
+	for (int t = 0; t < count; t++) {
+		///examples scored at least the threshold come first in descending order
+		int k = int(std::upper_bound(fold.sorted.constBegin(), fold.sorted.constEnd(),
+			float(thresholds[t]), std::greater<float>()) - fold.sorted.constBegin());
+		double tp = fold.hits[k], fp = fold.misses[k];
+		if (_task.type == ScoreSet::PR_CURVE) {
+			fold.x[t] = tp / positives;
+			fold.y[t] = tp + fp > 0.0 ? tp / (tp + fp) : 1.0;
+		}
+		else {
+			fold.x[t] = fp / negatives;
+			fold.y[t] = tp / positives;
+		}
+	}
+}
+
+/**
+ * Prepares a fold for the current averaging and releases its points, which are not needed any more
+ * @param _task fold
+ */
+static void prepareFold(AverageTask &_task)
+{
+	if (_task.mode == CurveAverage::ThresholdAveraging) {
+		prepareThresholds(_task);
+	}
+	else {
+		resampleVertical(_task);
+	}
+	_task.fold->points = QVector<QPointF>();
+}
+
+/**
+ * Constructor of CurveAverage class
+ * @param _type ScoreSet::ROC_CURVE or ScoreSet::PR_CURVE
+ */
+CurveAverage::CurveAverage(int _type):
+	type(_type), mode(VerticalAveraging), band(MinMaxBand), auc(0.0)
+{
+}
+
+/**
+ * Chooses averaging and band, folds are prepared again by the next update.
+ * Points of prepared folds are released, so they have to be added again when the averaging changes.
+ * @param _mode VerticalAveraging or ThresholdAveraging
+ * @param _band MinMaxBand or DeviationBand (mean plus and minus one standard deviation)
+ */
+void CurveAverage::setMode(int _mode, int _band)
+{
+	if (_mode != mode) {
+		pending.unite(folds);
+		folds.clear();
+	}
+	mode = _mode;
+	band = _band;
+}
+
+/**
+ * @return VerticalAveraging or ThresholdAveraging
+ */
+int CurveAverage::getMode() const
+{
+	return mode;
+}
+
+/**
+ * Adds a fold, which is prepared by the next update. A fold waiting for the update
+ * only gets its points again, so that its sorted scores are kept.
+ * @param _id identifier of the fold curve
+ * @param _points points of the curve
+ * @param _scores examples the curve was built from, null for curve files
+ */
+void CurveAverage::add(int _id, const QVector<QPointF> &_points, QSharedPointer<ScoreSet> _scores)
+{
+	if (folds.contains(_id)) {
+		return;
+	}
+	AverageFold &fold = pending[_id];
+	fold.points = _points;
+	if (!fold.scores && _scores && !_scores->isStreamed()) {
+		fold.scores = _scores;
+	}
+}
+
+/**
+ * Removes a fold, the average changes with the next update
+ * @param _id identifier of the fold curve
+ */
+void CurveAverage::remove(int _id)
+{
+	folds.remove(_id);
+	pending.remove(_id);
+}
+
+/**
+ * Removes all folds
+ */
+void CurveAverage::clear()
+{
+	folds.clear();
+	pending.clear();
+	update();
+}
+
+/**
+ * @param _id identifier of a curve
+ * @return true if the curve is a fold of the average
+ */
+bool CurveAverage::contains(int _id) const
+{
+	return folds.contains(_id) || pending.contains(_id);
+}
+
+/**
+ * @return number of folds
+ */
+int CurveAverage::size() const
+{
+	return folds.size() + pending.size();
+}
+
+/**
+ * @return identifiers of the fold curves
+ */
+QList<int> CurveAverage::ids() const
+{
+	return folds.keys() + pending.keys();
+}
+
+/**
+ * Prepares added folds in parallel and computes the mean curve and its band again.
+ * Folds with less than two points are dropped.
+ * @throw 1015 threshold averaging of a fold which is not built from a score file kept in memory,
+ * such folds are dropped (see getDropped) and the average of the other folds is computed before the error is thrown
+ */
+void CurveAverage::update()
+{
+	dropped.clear();
+	QHash<int, AverageFold>::iterator it;
+	for (it = pending.begin(); it != pending.end(); ) {
+		if (it->points.size() < 2) {
+			it = pending.erase(it);
+		}
+		else if (mode == ThresholdAveraging && !it->scores) {
+			dropped.append(it.key());
+			it = pending.erase(it);
+		}
+		else {
+			++it;
+		}
+	}
+
+	QVector<AverageTask> tasks;
+	for (it = pending.begin(); it != pending.end(); ++it) {
+		AverageTask task = { &it.value(), type, mode, &thresholds };
+		tasks.append(task);
+	}
+	QtConcurrent::blockingMap(tasks, prepareFold);
+	folds.unite(pending);
+	pending.clear();
+
+	///common thresholds depend on all folds, their points are found again for every change
+	if (mode == ThresholdAveraging) {
+		computeThresholds();
+		tasks.clear();
+		for (it = folds.begin(); it != folds.end(); ++it) {
+			AverageTask task = { &it.value(), type, mode, &thresholds };
+			tasks.append(task);
+		}
+		QtConcurrent::blockingMap(tasks, sampleThresholds);
+	}
+	aggregate();
+	if (!dropped.isEmpty()) {
+		throw 1015;
+	}
+}
+
+/**
+ * @return identifiers of the fold curves dropped by the last update with error 1015
+ */
+const QList<int>& CurveAverage::getDropped() const
+{
+	return dropped;
+}
+
+/**
+ * Chooses GRID_POINTS common thresholds: one above all scores, so that curves start
+ * with no example accepted, and the others evenly spread over the quantiles of scores of all folds
+ */
+void CurveAverage::computeThresholds()
+{
+	QVector<double> quantiles;
+	QHash<int, AverageFold>::const_iterator it;
+	for (it = folds.constBegin(); it != folds.constEnd(); ++it) {
+		int n = it->sorted.size();
+		for (int g = 0; g < GRID_POINTS && n > 0; g++) {
+			quantiles.append(it->sorted[int(qint64(g) * (n - 1) / (GRID_POINTS - 1))]);
+		}
+	}
+	std::sort(quantiles.begin(), quantiles.end(), std::greater<double>());
+
+	thresholds.clear();
+	thresholds.append(std::numeric_limits<double>::infinity());
+	int n = quantiles.size();
+	for (int g = 0; g + 1 < GRID_POINTS && n > 0; g++) {
+		thresholds.append(quantiles[int(qint64(g) * (n - 1) / (GRID_POINTS - 2))]);
+	}
+}
+
+/**
+ * Averages the folds at every grid point and computes the band and the AUC of the mean curve
+ */
+void CurveAverage::aggregate()
+{
+	mean.clear();
+	spread.clear();
+	auc = 0.0;
+	int count = folds.size();
+	if (count == 0) {
+		return;
+	}
+
+	int points = folds.constBegin()->x.size();
+	mean.reserve(points);
+	spread.reserve(points);
+	for (int g = 0; g < points; g++) {
+		double x = 0.0, y = 0.0, squares = 0.0;
+		double low = folds.constBegin()->y[g], high = low;
+		QHash<int, AverageFold>::const_iterator it;
+		for (it = folds.constBegin(); it != folds.constEnd(); ++it) {
+			x += it->x[g];
+			y += it->y[g];
+			squares += it->y[g] * it->y[g];
+			low = qMin(low, it->y[g]);
+			high = qMax(high, it->y[g]);
+		}
+		x /= count;
+		y /= count;
+		if (band == DeviationBand) {
+			double deviation = count > 1 ? std::sqrt(qMax(0.0, (squares - count * y * y) / (count - 1))) : 0.0;
+			low = y - deviation;
+			high = y + deviation;
+		}
+		mean.append(QPointF(x, y));
+		spread.append(QwtIntervalSample(x, low, high));
+	}
+	auc = Metrics::auc(mean.constData(), mean.size());
+}
+
+/**
+ * @return points of the mean curve
+ */
+const QVector<QPointF>& CurveAverage::getMean() const
+{
+	return mean;
+}
+
+/**
+ * @return band of the folds around the mean curve, spread of y at every point
+ */
+const QVector<QwtIntervalSample>& CurveAverage::getBand() const
+{
+	return spread;
+}
+
+/**
+ * @return area under the mean curve
+ */
+double CurveAverage::getAUC() const
+{
+	return auc;
+}
@@ -0,0 +1,127 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/CurveBuilder.h"
+
+/**
+ * Constructor of CurveBuilder class.
+ * Examples with equal scores form one threshold, so a group of tied positive
+ * and negative examples gives a diagonal segment, as expected of ROC curves.
+ * Points lying inside a vertical or horizontal run of segments are not stored,
+ * as they do not change the curve. With a tolerance, points closer than it to
+ * the previous point are dropped as well. AUC is computed exactly from the
+ * weights of every threshold, it does not depend on the tolerance.
+ * @param _positives total weight of positive examples
+ * @param _negatives total weight of negative examples
+ * @param _tolerance smallest distance between kept points on both axes, 0 keeps all of them
+ */
+CurveBuilder::CurveBuilder(double _positives, double _negatives, double _tolerance):
+	positives(_positives), negatives(_negatives), tolerance(_tolerance),
+	tp(0.0), fp(0.0), groupTp(0.0), groupFp(0.0), groupScore(0.0f), group(false),
+	rocRun(NoRun), prRun(NoRun)
+{
+	roc.append(QPointF(0.0, 0.0));
+}
+
+/**
+ * Adds an example, its score must not be higher than the score of the previous one
+ * @param _score score of the example
+ * @param _positive label of the example
+ * @param _weight weight of the example
+ */
+void CurveBuilder::add(float _score, bool _positive, double _weight)
+{
+	if (group && _score != groupScore) {
+		closeGroup();
+	}
+	group = true;
+	groupScore = _score;
+	if (_positive) {
+		groupTp += _weight;
+	}
+	else {
+		groupFp += _weight;
+	}
+}
+
+/**
+ * Adds the last threshold
+ * @return area under the ROC curve
+ */
+double CurveBuilder::finish()
+{
+	if (group) {
+		closeGroup();
+	}
+	roc.squeeze();
+	pr.squeeze();
+	return area.result() / (2.0 * positives * negatives);
+}
+
+/**
+ * Adds points of the threshold made of the examples added since the last one
+ */
+void CurveBuilder::closeGroup()
+{
+	area.add(groupFp * (2.0 * tp + groupTp));
+	tp += groupTp;
+	fp += groupFp;
+
+	int direction = groupFp == 0.0 ? VerticalRun : (groupTp == 0.0 ? HorizontalRun : DiagonalRun);
+	appendPoint(roc, QPointF(fp / negatives, tp / positives), rocRun, direction);
+
+	///PR curve starts at recall 0 with the precision of the first threshold
+	QPointF prPoint(tp / positives, (tp + fp) > 0.0 ? tp / (tp + fp) : 1.0);
+	if (pr.isEmpty()) {
+		pr.append(QPointF(0.0, prPoint.y()));
+	}
+	appendPoint(pr, prPoint, prRun, groupTp == 0.0 ? VerticalRun : DiagonalRun);
+
+	groupTp = groupFp = 0.0;
+	group = false;
+}
+
+/**
+ * Adds a point to a curve, or moves the last point if it is not needed
+ * @param _curve curve points
+ * @param _point new point
+ * @param _run direction of the last segment of the curve, updated
+ * @param _direction direction of the new segment
+ */
+void CurveBuilder::appendPoint(QVector<QPointF> &_curve, const QPointF &_point, int &_run, int _direction)
+{
+	int n = _curve.size();
+	if (_direction == _run && _direction != DiagonalRun) {
+		_curve.last() = _point;
+	}
+	else if (n >= 2 && qAbs(_curve[n - 1].x() - _curve[n - 2].x()) < tolerance
+			&& qAbs(_curve[n - 1].y() - _curve[n - 2].y()) < tolerance) {
+		///the last point is too close to its predecessor, the new segment starts at the predecessor
+		_curve.last() = _point;
+		_direction = NoRun;
+	}
+	else {
+		_curve.append(_point);
+	}
+	_run = _direction;
+}
@@ -0,0 +1,265 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/CurveCache.h"
+#include "../headers/fileProxy.h"
+#include <QFileInfo>
+#include <QDateTime>
+#include <QMutexLocker>
+
+/**
+ * CurveCache class constructor. Default budget is 512 MB.
+ */
+CurveCache::CurveCache():
+	budget(Q_INT64_C(512) * 1024 * 1024)
+{
+}
+
+/**
+ * @return the process wide cache
+ */
+CurveCache* CurveCache::instance()
+{
+	static CurveCache cache;
+	return &cache;
+}
+
+/**
+ * Builds the identity of a file, which changes whenever the file is modified.
+ * Storage mode is a part of it, data loaded in another precision is not reused.
+ * Curves of a score file are identified by the score file and the curve type.
+ * @param _path path of the file
+ * @return canonical path, size and modification time of the file and storage mode
+ */
+QString CurveCache::identity(QString _path)
+{
+	QString file = _path, fragment;
+	int type;
+	if (ScoreSet::splitCurvePath(_path, file, type)) {
+		fragment = _path.mid(file.size());
+	}
+	QFileInfo info(file);
+	QString path = info.canonicalFilePath();
+	if (path.isEmpty()) {
+		path = info.absoluteFilePath();
+	}
+	return QString("%1%2|%3|%4|%5").arg(path).arg(fragment).arg(info.size()).arg(info.lastModified().toMSecsSinceEpoch()).arg(int(CurveData::getStorageMode()));
+}
+
+/**
+ * Returns data of a file, loading it only if no copy is held in memory.
+ * When the same file is requested by several threads at once, it is loaded only
+ * by the first of them and the others wait for the result. Safe to call from any thread.
+ * @param _path path of the file
+ * @param _observer optional object notified about loading progress
+ * @return shared, immutable data of the file
+ * @throw 1004 loading was cancelled by the observer
+ * @throw 1001, 1002, 1005, 1006 see CurveData::load
+ */
+QSharedPointer<CurveData> CurveCache::acquire(QString _path, LoadObserver *_observer)
+{
+	QString key = identity(_path);
+	QMutexLocker locker(&mutex);
+
+	forever {
+		QSharedPointer<CurveData> data = entries.value(key).toStrongRef();
+		if (data) {
+			///data is in use again, it does not have to be retained any more
+			retained.removeOne(data);
+			return data;
+		}
+		if (!loading.contains(key)) {
+			break;
+		}
+		loaded.wait(&mutex, 100);
+		if (_observer && !_observer->progress(0, 1)) {
+			throw 1004;
+		}
+	}
+
+	loading.insert(key);
+	locker.unlock();
+
+	QSharedPointer<CurveData> data;
+	try {
+		data = CurveData::load(_path, _observer);
+	}
+	catch(int) {
+		locker.relock();
+		loading.remove(key);
+		loaded.wakeAll();
+		throw;
+	}
+
+	locker.relock();
+	loading.remove(key);
+	entries.insert(key, data.toWeakRef());
+	loaded.wakeAll();
+	return data;
+}
+
+/**
+ * Returns examples of a score file, loading them only if no copy is held in memory.
+ * Works like acquire, the examples stay in memory as long as a curve built from them exists.
+ * @param _path path of the score file
+ * @param _observer optional object notified about loading progress
+ * @return shared, immutable examples of the file
+ * @throw 1004 loading was cancelled by the observer
+ * @throw 1001, 1002, 1008 see ScoreSet::load
+ */
+QSharedPointer<ScoreSet> CurveCache::acquireScores(QString _path, LoadObserver *_observer)
+{
+	QString key = "scores|" + identity(_path);
+	QMutexLocker locker(&mutex);
+
+	forever {
+		QSharedPointer<ScoreSet> scores = scoreEntries.value(key).toStrongRef();
+		if (scores) {
+			return scores;
+		}
+		if (!loading.contains(key)) {
+			break;
+		}
+		loaded.wait(&mutex, 100);
+		if (_observer && !_observer->progress(0, 1)) {
+			throw 1004;
+		}
+	}
+
+	loading.insert(key);
+	locker.unlock();
+
+	QSharedPointer<ScoreSet> scores;
+	try {
+		scores = ScoreSet::load(_path, _observer);
+	}
+	catch(int) {
+		locker.relock();
+		loading.remove(key);
+		loaded.wakeAll();
+		throw;
+	}
+
+	locker.relock();
+	loading.remove(key);
+	///drop entries of released examples
+	QHash<QString, QWeakPointer<ScoreSet> >::iterator it = scoreEntries.begin();
+	while (it != scoreEntries.end()) {
+		if (it.value().toStrongRef()) {
+			++it;
+		}
+		else {
+			it = scoreEntries.erase(it);
+		}
+	}
+	scoreEntries.insert(key, scores.toWeakRef());
+	loaded.wakeAll();
+	return scores;
+}
+
+/**
+ * Keeps data of a detached curve in memory, so that it is not loaded again
+ * when the curve is reattached. Least recently retained data is released
+ * when the memory used by the cache exceeds the budget.
+ * @param _data data which is not used by any attached curve
+ */
+void CurveCache::retain(QSharedPointer<CurveData> _data)
+{
+	if (!_data) {
+		return;
+	}
+	QMutexLocker locker(&mutex);
+	retained.removeOne(_data);
+	retained.append(_data);
+	evict();
+}
+
+/**
+ * Sets memory budget of the cache and releases retained data exceeding it
+ * @param _bytes budget in bytes
+ */
+void CurveCache::setBudget(qint64 _bytes)
+{
+	QMutexLocker locker(&mutex);
+	budget = _bytes;
+	evict();
+}
+
+/**
+ * @return memory budget of the cache in bytes
+ */
+qint64 CurveCache::getBudget()
+{
+	QMutexLocker locker(&mutex);
+	return budget;
+}
+
+/**
+ * @return memory used by all data held in memory, both attached and retained
+ */
+qint64 CurveCache::memoryUsage()
+{
+	QMutexLocker locker(&mutex);
+	return usage();
+}
+
+/**
+ * Sums memory used by all data held in memory. Has to be called with the mutex locked.
+ * @return memory usage in bytes
+ */
+qint64 CurveCache::usage()
+{
+	qint64 usage = 0;
+	QHash<QString, QWeakPointer<CurveData> >::iterator it = entries.begin();
+	while (it != entries.end()) {
+		QSharedPointer<CurveData> data = it.value().toStrongRef();
+		if (data) {
+			usage += data->memoryUsage();
+			++it;
+		}
+		else {
+			///drop entries of released data
+			it = entries.erase(it);
+		}
+	}
+	return usage;
+}
+
+/**
+ * Releases least recently retained data until the cache fits in the budget.
+ * Has to be called with the mutex locked.
+ */
+void CurveCache::evict()
+{
+	qint64 usage = this->usage();
+	while (usage > budget && !retained.isEmpty()) {
+		QWeakPointer<CurveData> oldest = retained.first().toWeakRef();
+		qint64 size = retained.first()->memoryUsage();
+		retained.removeFirst();
+
+		///data shared with an attached curve stays in memory
+		if (!oldest.toStrongRef()) {
+			usage -= size;
+		}
+	}
+}
@@ -0,0 +1,406 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/CurveData.h"
+#include "../headers/CurveLoader.h"
+#include "../headers/FunctionData.h"
+#include "../headers/fileProxy.h"
+#include "../headers/CurveCache.h"
+#include "../headers/ScoreSketch.h"
+#include <QFileInfo>
+#include <QScopedPointer>
+#include <QAtomicInt>
+
+///precision in which points of text files are kept, changed from the GUI thread
+static QAtomicInt storageMode(QuantizedPoints::DoublePrecision);
+
+///checksums of binary files are verified only on demand
+static QAtomicInt verifyChecksums(0);
+
+/**
+ * Constructor of CurveData class
+ * @param _path path of the loaded file
+ */
+CurveData::CurveData(QString _path):
+	path(_path), monotone(false), auc(0.0), aucError(0.0), error(0)
+{
+}
+
+/**
+ * Loads a curve file. Binary files are only mapped and their AUC, operating points
+ * and pyramid are read from the file, text files are parsed and their AUC is computed.
+ * Curves of score files are built from the examples of the file, which are loaded once for both curves.
+ * Curves of score sketches are built from their histograms, ROC AUC comes with its error bound.
+ * A curve which has too little points is still loaded, error 1003 is stored instead of AUC.
+ * Operating points are found together with the AUC, before points of text files are quantized.
+ * Curves which are only measured skip quantization and the pyramid used for drawing.
+ * @param _path path of the file
+ * @param _observer optional object notified about loading progress
+ * @param _forDisplay false if only the AUC and operating points of the curve are needed
+ * @return loaded curve data
+ * @throw 1001, 1002, 1004, 1005, 1006 see RealFile and BinaryCurveFile
+ * @throw 1008 see ScoreSet::load
+ * @throw 1005, 1006, 1008 see ScoreSketch
+ */
+QSharedPointer<CurveData> CurveData::load(QString _path, LoadObserver *_observer, bool _forDisplay)
+{
+	QSharedPointer<CurveData> data(new CurveData(_path));
+	QString scoreFile;
+	int curveType;
+
+	if (ScoreSet::splitCurvePath(_path, scoreFile, curveType)) {
+		if (ScoreSketch::isSketchFile(scoreFile)) {
+			ScoreSketch sketch = ScoreSketch::load(scoreFile, _observer);
+			QVector<QPointF> roc, pr;
+			double rocAuc = sketch.buildCurves(roc, pr);
+			data->points = curveType == ScoreSet::PR_CURVE ? pr : roc;
+			if (curveType == ScoreSet::ROC_CURVE) {
+				data->aucError = sketch.aucErrorBound();
+			}
+			data->measureScoreCurve(curveType, rocAuc, sketch.getPositives(), sketch.getNegatives());
+		}
+		else {
+			data->scores = CurveCache::instance()->acquireScores(scoreFile, _observer);
+			data->points = data->scores->getCurve(curveType);
+			data->measureScoreCurve(curveType, data->scores->getAUC(),
+				data->scores->getPositives(), data->scores->getNegatives());
+		}
+		///points of score files are shared with the examples, so they are not quantized
+	}
+	else if (isBinary(_path)) {
+		QSharedPointer<BinaryCurveFile> binary(new BinaryCurveFile(_path));
+		binary->open();
+		if (getVerifyChecksums()) {
+			binary->verify(_observer);
+		}
+		data->binary = binary;
+
+		///everything computed from the samples is stored in the file, the samples are not read
+		data->auc = binary->getAUC();
+		data->rect = binary->boundingRect();
+		data->monotone = binary->isMonotone();
+		data->operating = binary->getOperatingPoints();
+		if (_forDisplay) {
+			binary->mapPyramid(data->pyramid);
+		}
+	}
+	else {
+		RealFile file(_path);
+		data->points = *file.getData(_observer);
+
+		///the vector was reserved from an estimate, do not keep the spare capacity
+		if (data->points.capacity() - data->points.size() > data->points.size() / 8) {
+			data->points.squeeze();
+		}
+
+		data->rect = FunctionData::computeBoundingRect(data->points.constData(), data->points.size(), data->monotone);
+
+		try {
+			data->auc = CurveLoader::computeAUC(data->points);
+		}
+		catch(int e) {
+			data->error = e;
+		}
+		data->operating = Metrics::operatingPoints(data->points.constData(), data->points.size(),
+			isPrFile(_path) ? OperatingPointScan::PR_CURVE : OperatingPointScan::ROC_CURVE);
+
+		///AUC, operating points and bounding rect are computed above from the points in full precision
+		QuantizedPoints::Mode mode = getStorageMode();
+		if (_forDisplay && mode != QuantizedPoints::DoublePrecision) {
+			data->quantized.encode(data->points, data->rect, mode);
+			data->points = QVector<QPointF>();
+		}
+	}
+
+	///summary of the points used when the curve is drawn, binary files store it
+	if (_forDisplay && !data->binary) {
+		QScopedPointer<FunctionData> samples(data->createSeriesData());
+		data->pyramid.build(*samples);
+	}
+	return data;
+}
+
+/**
+ * Loads both curves of a score or sketch file, whose examples or histogram are read
+ * only once. Curves are the same as the ones loaded by load for curvePath of the file.
+ * @param _file path of the score or sketch file
+ * @param _observer optional object notified about loading progress
+ * @param _forDisplay false if only the AUC and operating points of the curves are needed
+ * @return ROC curve data followed by PR curve data
+ * @throw 1008, 1017 see ScoreSet::load
+ * @throw 1005, 1006, 1008 see ScoreSketch
+ */
+QVector<QSharedPointer<CurveData> > CurveData::loadScoreCurves(QString _file, LoadObserver *_observer, bool _forDisplay)
+{
+	QVector<QSharedPointer<CurveData> > curves;
+	QSharedPointer<CurveData> roc(new CurveData(ScoreSet::curvePath(_file, ScoreSet::ROC_CURVE)));
+	QSharedPointer<CurveData> pr(new CurveData(ScoreSet::curvePath(_file, ScoreSet::PR_CURVE)));
+	curves << roc << pr;
+
+	if (ScoreSketch::isSketchFile(_file)) {
+		ScoreSketch sketch = ScoreSketch::load(_file, _observer);
+		double rocAuc = sketch.buildCurves(roc->points, pr->points);
+		roc->aucError = sketch.aucErrorBound();
+		roc->measureScoreCurve(ScoreSet::ROC_CURVE, rocAuc, sketch.getPositives(), sketch.getNegatives());
+		pr->measureScoreCurve(ScoreSet::PR_CURVE, rocAuc, sketch.getPositives(), sketch.getNegatives());
+	}
+	else {
+		QSharedPointer<ScoreSet> scores = CurveCache::instance()->acquireScores(_file, _observer);
+		int types[2] = { ScoreSet::ROC_CURVE, ScoreSet::PR_CURVE };
+		for (int c = 0; c < curves.size(); c++) {
+			curves[c]->scores = scores;
+			curves[c]->points = scores->getCurve(types[c]);
+			curves[c]->measureScoreCurve(types[c], scores->getAUC(), scores->getPositives(), scores->getNegatives());
+		}
+	}
+
+	if (_forDisplay) {
+		for (int c = 0; c < curves.size(); c++) {
+			QScopedPointer<FunctionData> samples(curves[c]->createSeriesData());
+			curves[c]->pyramid.build(*samples);
+		}
+	}
+	return curves;
+}
+
+/**
+ * Computes values of a curve of a score or sketch file from its points
+ * @param _type ScoreSet::ROC_CURVE or ScoreSet::PR_CURVE
+ * @param _rocAuc ROC AUC computed from the examples with ties handled
+ * @param _positives weight of positive examples
+ * @param _negatives weight of negative examples
+ */
+void CurveData::measureScoreCurve(int _type, double _rocAuc, double _positives, double _negatives)
+{
+	operating = Metrics::operatingPoints(points.constData(), points.size(),
+		_type, _positives / (_positives + _negatives));
+	rect = FunctionData::computeBoundingRect(points.constData(), points.size(), monotone);
+
+	///ROC AUC is computed from the examples with ties handled
+	if (_type == ScoreSet::ROC_CURVE) {
+		auc = _rocAuc;
+	}
+	else {
+		try {
+			auc = CurveLoader::computeAUC(points);
+		}
+		catch(int e) {
+			error = e;
+		}
+	}
+}
+
+/**
+ * Sets if checksums of binary curve files loaded from now on are verified, which reads
+ * the whole file. They are not verified by default, so that binary files open at once.
+ * @param _verify true to verify checksums
+ */
+void CurveData::setVerifyChecksums(bool _verify)
+{
+	verifyChecksums.fetchAndStoreOrdered(_verify ? 1 : 0);
+}
+
+/**
+ * @return true if checksums of loaded binary curve files are verified
+ */
+bool CurveData::getVerifyChecksums()
+{
+	return int(verifyChecksums) != 0;
+}
+
+/**
+ * Checks if a file is stored in the binary curve format
+ * @param _path path of the file
+ * @return true for .rocb and .prb files
+ */
+bool CurveData::isBinary(QString _path)
+{
+	QString suffix = QFileInfo(_path).suffix();
+	return suffix.compare("rocb", Qt::CaseInsensitive) == 0 || suffix.compare("prb", Qt::CaseInsensitive) == 0;
+}
+
+/**
+ * Checks if a curve file holds a PR curve
+ * @param _path path of the file
+ * @return true for .pr and .prb files
+ */
+bool CurveData::isPrFile(QString _path)
+{
+	QString suffix = QFileInfo(_path).suffix();
+	return suffix.compare("pr", Qt::CaseInsensitive) == 0 || suffix.compare("prb", Qt::CaseInsensitive) == 0;
+}
+
+/**
+ * Sets precision in which points of text files loaded from now on are kept.
+ * Mapped binary files are not affected.
+ * @param _mode storage mode of points
+ */
+void CurveData::setStorageMode(QuantizedPoints::Mode _mode)
+{
+	storageMode.fetchAndStoreOrdered(_mode);
+}
+
+/**
+ * @return precision in which points of loaded text files are kept
+ */
+QuantizedPoints::Mode CurveData::getStorageMode()
+{
+	return QuantizedPoints::Mode(int(storageMode));
+}
+
+/**
+ * Creates series data reading the samples, which is given to Curve::setData.
+ * The series data does not own the samples, the curve has to keep this object alive.
+ * @return samples read from the mapped binary file or from the parsed points
+ */
+FunctionData* CurveData::createSeriesData() const
+{
+	if (binary) {
+		return new MappedFunctionData(binary, monotone);
+	}
+	if (quantized.getMode() != QuantizedPoints::DoublePrecision) {
+		return new QuantizedFunctionData(&quantized, rect, monotone);
+	}
+	return new FunctionData(&points, rect, monotone);
+}
+
+/**
+ * Gives points of the curve in full precision. Parsed points are shared,
+ * points of mapped binary files and quantized points are decoded into a new vector.
+ * @return points of the curve
+ */
+QVector<QPointF> CurveData::getPoints() const
+{
+	if (!binary && quantized.getMode() == QuantizedPoints::DoublePrecision) {
+		return points;
+	}
+	QScopedPointer<FunctionData> samples(createSeriesData());
+	QVector<QPointF> decoded(int(samples->size()));
+	for (size_t i = 0; i < samples->size(); i++) {
+		decoded[int(i)] = samples->sample(i);
+	}
+	return decoded;
+}
+
+/**
+ * @return min/max pyramid of the samples, it has no levels for small curves
+ */
+const CurvePyramid* CurveData::getPyramid() const
+{
+	return &pyramid;
+}
+
+/**
+ * @return examples the curve was built from, null for curve files
+ */
+QSharedPointer<ScoreSet> CurveData::getScores() const
+{
+	return scores;
+}
+
+/**
+ * @return path of the loaded file
+ */
+QString CurveData::getPath() const
+{
+	return path;
+}
+
+/**
+ * @return number of points of the curve
+ */
+size_t CurveData::size() const
+{
+	if (binary) {
+		return binary->size();
+	}
+	if (quantized.getMode() != QuantizedPoints::DoublePrecision) {
+		return quantized.size();
+	}
+	return points.size();
+}
+
+/**
+ * @return area under the curve
+ */
+double CurveData::getAUC() const
+{
+	return auc;
+}
+
+/**
+ * @return largest error of AUC, 0 if it is exact up to rounding
+ */
+double CurveData::getAUCError() const
+{
+	return aucError;
+}
+
+/**
+ * @return operating points of the curve, found at load time
+ */
+const OperatingPoints& CurveData::getOperatingPoints() const
+{
+	return operating;
+}
+
+/**
+ * @return error code raised while computing AUC, 0 if there was no error
+ */
+int CurveData::getError() const
+{
+	return error;
+}
+
+/**
+ * @return precision in which the points are kept
+ */
+QuantizedPoints::Mode CurveData::getMode() const
+{
+	return quantized.getMode();
+}
+
+/**
+ * @return largest difference between a stored coordinate and the one read from the file
+ */
+double CurveData::getMaxError() const
+{
+	return quantized.getMaxError();
+}
+
+/**
+ * Memory taken by the samples and their pyramid. Mapped files are counted at their sample size,
+ * as their pages stay resident while the curve is displayed. Examples of a score file
+ * are shared by two curves, each of them counts a half.
+ * @return size of the samples in bytes
+ */
+qint64 CurveData::memoryUsage() const
+{
+	if (scores) {
+		return scores->memoryUsage() / 2 + pyramid.memoryUsage();
+	}
+	if (binary) {
+		return qint64(binary->size()) * 2 * sizeof(double) + pyramid.memoryUsage();
+	}
+	return qint64(points.capacity()) * sizeof(QPointF) + quantized.memoryUsage() + pyramid.memoryUsage();
+}
@@ -0,0 +1,157 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/CurveLoader.h"
+#include "../headers/Metrics.h"
+
+/**
+ * CurveLoader class constructor. The loader is deleted by its owner,
+ * not by the thread pool.
+ * @param _proxy proxy of the file to be loaded
+ */
+CurveLoader::CurveLoader(QSharedPointer<ProxyFile> _proxy):
+	proxy_(_proxy), path_(_proxy->real_file_path),
+	error_(0), percent_(-1), batch_(0), cancelled_(0)
+{
+	setAutoDelete(false);
+}
+
+/**
+ * Gets data of the file through the curve cache, which loads the file
+ * and computes the area under the curve if no copy is held in memory.
+ * Called by the thread pool, emits loaded or failed signal when done.
+ * A curve which has too little points is still loaded, error 1003 is stored instead of AUC.
+ */
+void CurveLoader::run()
+{
+	try {
+		if (cancelled_) {
+			throw 1004;
+		}
+		data_ = proxy_->getCurveData(this);
+		error_ = data_->getError();
+	}
+	catch(int e) {
+		error_ = e;
+		emit failed(path_, e);
+		return;
+	}
+	emit loaded();
+}
+
+/**
+ * Requests cancellation of the loading. Safe to call from any thread.
+ */
+void CurveLoader::cancel()
+{
+	cancelled_.fetchAndStoreOrdered(1);
+}
+
+/**
+ * Called by RealFile after every parsed chunk of the file.
+ * Emits progressChanged signal whenever the percentage changes.
+ * @param _done number of bytes already parsed
+ * @param _total size of the file
+ * @return false if the loading was cancelled
+ */
+bool CurveLoader::progress(qint64 _done, qint64 _total)
+{
+	int percent = _total > 0 ? int(_done * 100 / _total) : 100;
+	if (percent != percent_) {
+		percent_ = percent;
+		emit progressChanged(path_, percent);
+	}
+	return !cancelled_;
+}
+
+/**
+ * Computes the area under the curve with the trapezoidal rule, see Metrics::auc
+ * @param _points curve points sorted by x
+ * @return area under the curve
+ * @throw 1003 the curve has less than two points
+ */
+double CurveLoader::computeAUC(const QVector<QPointF>& _points)
+{
+	if (_points.size() < 2) {
+		throw 1003;
+	}
+
+	return Metrics::auc(_points.constData(), _points.size());
+}
+
+/**
+ * @return proxy of the loaded file
+ */
+QSharedPointer<ProxyFile> CurveLoader::getProxy()
+{
+	return proxy_;
+}
+
+/**
+ * @return loaded data, valid after loaded signal was emitted
+ */
+QSharedPointer<CurveData> CurveLoader::getCurveData()
+{
+	return data_;
+}
+
+/**
+ * @return area under the loaded curve
+ */
+double CurveLoader::getAUC()
+{
+	return data_ ? data_->getAUC() : 0.0;
+}
+
+/**
+ * @return error code of the loading, 0 if there was no error
+ */
+int CurveLoader::getError()
+{
+	return error_;
+}
+
+/**
+ * @return path of the loaded file
+ */
+QString CurveLoader::getPath()
+{
+	return path_;
+}
+
+/**
+ * Assigns the loader to a batch of files which are attached together
+ * @param _batch batch identifier
+ */
+void CurveLoader::setBatch(int _batch)
+{
+	batch_ = _batch;
+}
+
+/**
+ * @return identifier of the batch the loader belongs to
+ */
+int CurveLoader::getBatch()
+{
+	return batch_;
+}
@@ -0,0 +1,269 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/CurvePyramid.h"
+#include <qwt_scale_map.h>
+
+/**
+ * Builds all levels of the pyramid. Curves with too little samples
+ * to be summarized get no levels and are drawn point by point.
+ * @param _samples samples of the curve, they have to stay unchanged while the pyramid is used
+ */
+void CurvePyramid::build(const QwtSeriesData<QPointF> &_samples)
+{
+	levels.clear();
+	buckets.clear();
+	sizes.clear();
+	size_t count = _samples.size();
+	if (count < size_t(2 * BASE_BUCKET)) {
+		return;
+	}
+
+	///level 0 is computed from the samples
+	QVector<Bucket> base(int((count + BASE_BUCKET - 1) / BASE_BUCKET));
+	for (int b = 0; b < base.size(); b++) {
+		size_t first = size_t(b) * BASE_BUCKET;
+		size_t last = qMin(first + BASE_BUCKET, count);
+
+		QPointF point = _samples.sample(first);
+		double minX = point.x(), maxX = point.x(), minY = point.y(), maxY = point.y();
+		Bucket &bucket = base[b];
+		bucket.minX = bucket.maxX = bucket.minY = bucket.maxY = quint32(first);
+
+		for (size_t i = first + 1; i < last; i++) {
+			point = _samples.sample(i);
+			if (point.x() < minX) { minX = point.x(); bucket.minX = quint32(i); }
+			if (point.x() > maxX) { maxX = point.x(); bucket.maxX = quint32(i); }
+			if (point.y() < minY) { minY = point.y(); bucket.minY = quint32(i); }
+			if (point.y() > maxY) { maxY = point.y(); bucket.maxY = quint32(i); }
+		}
+	}
+	levels.append(base);
+
+	///every next level joins FAN_OUT buckets of the previous one
+	while (levels.last().size() > 1) {
+		const QVector<Bucket> &previous = levels.last();
+		QVector<Bucket> next((previous.size() + FAN_OUT - 1) / FAN_OUT);
+		for (int b = 0; b < next.size(); b++) {
+			int first = b * FAN_OUT;
+			int last = qMin(first + int(FAN_OUT), previous.size());
+			next[b] = previous[first];
+			for (int i = first + 1; i < last; i++) {
+				join(_samples, next[b], previous[i]);
+			}
+		}
+		levels.append(next);
+	}
+
+	for (int l = 0; l < levels.size(); l++) {
+		buckets.append(levels[l].constData());
+		sizes.append(levels[l].size());
+	}
+}
+
+/**
+ * Gives all levels one after another, in the layout read by map
+ * @return levels of the pyramid, empty if the curve is not summarized
+ */
+QByteArray CurvePyramid::save() const
+{
+	QByteArray data;
+	for (int l = 0; l < buckets.size(); l++) {
+		data.append(reinterpret_cast<const char*>(buckets[l]), sizes[l] * int(sizeof(Bucket)));
+	}
+	return data;
+}
+
+/**
+ * Uses levels saved by save without copying them. Sizes of the levels follow
+ * from the number of samples, the data has to stay mapped while the pyramid is used.
+ * @param _data levels saved for the samples, storedSize bytes, aligned to 4 bytes
+ * @param _count number of samples the pyramid was built from
+ */
+void CurvePyramid::map(const uchar *_data, size_t _count)
+{
+	levels.clear();
+	buckets.clear();
+	sizes = levelSizes(_count);
+	const Bucket *bucket = reinterpret_cast<const Bucket*>(_data);
+	for (int l = 0; l < sizes.size(); l++) {
+		buckets.append(bucket);
+		bucket += sizes[l];
+	}
+}
+
+/**
+ * @param _count number of samples
+ * @return size in bytes of the levels saved for a curve of given number of samples
+ */
+qint64 CurvePyramid::storedSize(size_t _count)
+{
+	QVector<int> levelSize = levelSizes(_count);
+	qint64 size = 0;
+	for (int l = 0; l < levelSize.size(); l++) {
+		size += qint64(levelSize[l]) * sizeof(Bucket);
+	}
+	return size;
+}
+
+/**
+ * Tells how many buckets every level built for a curve has
+ * @param _count number of samples
+ * @return number of buckets of every level, empty for curves which are not summarized
+ */
+QVector<int> CurvePyramid::levelSizes(size_t _count)
+{
+	QVector<int> levelSize;
+	if (_count < size_t(2 * BASE_BUCKET)) {
+		return levelSize;
+	}
+	levelSize.append(int((_count + BASE_BUCKET - 1) / BASE_BUCKET));
+	while (levelSize.last() > 1) {
+		levelSize.append((levelSize.last() + FAN_OUT - 1) / FAN_OUT);
+	}
+	return levelSize;
+}
+
+/**
+ * Selects samples which have to be drawn to render a range of the curve as exactly
+ * as drawing all of its samples. A bucket is replaced by its first, last and extreme
+ * points only when all its samples fall into the same pixel column, so that the line drawn
+ * through them covers the same pixels. Other buckets are split into smaller ones.
+ * Search starts at the level whose buckets hold about as many samples as one pixel column.
+ * @param _samples samples the pyramid was built from
+ * @param _xMap map of x values to canvas coordinates
+ * @param _from index of the first sample of the range
+ * @param _to index of the last sample of the range
+ * @param _width width of the range on the canvas in pixels
+ * @param _indices receives indices of the selected samples in ascending order
+ */
+void CurvePyramid::select(const QwtSeriesData<QPointF> &_samples, const QwtScaleMap &_xMap,
+	int _from, int _to, double _width, QVector<int> &_indices) const
+{
+	_indices.clear();
+	if (_to < _from) {
+		return;
+	}
+
+	int count = int(_samples.size());
+	double perPixel = (_to - _from + 1) / qMax(1.0, _width);
+	int top = -1;
+	while (top + 1 < buckets.size() && bucketSize(top + 1) <= perPixel) {
+		top++;
+	}
+
+	int i = _from;
+	while (i <= _to) {
+		int level = top;
+		for (; level >= 0; level--) {
+			int size = bucketSize(level);
+			int last = qMin(i + size, count) - 1;
+			if (i % size != 0 || last > _to) {
+				continue;
+			}
+
+			const Bucket &bucket = buckets[level][i / size];
+			int left = qRound(_xMap.transform(_samples.sample(bucket.minX).x()));
+			int right = qRound(_xMap.transform(_samples.sample(bucket.maxX).x()));
+			if (left != right) {
+				continue;
+			}
+
+			///the line through the extremes in their order covers the whole column
+			int low = qMin(bucket.minY, bucket.maxY);
+			int high = qMax(bucket.minY, bucket.maxY);
+			_indices.append(i);
+			if (low != i && low != last) {
+				_indices.append(low);
+			}
+			if (high != low && high != last) {
+				_indices.append(high);
+			}
+			if (last != i) {
+				_indices.append(last);
+			}
+			i = last + 1;
+			break;
+		}
+
+		if (level < 0) {
+			_indices.append(i);
+			i++;
+		}
+	}
+}
+
+/**
+ * @return number of levels, 0 if the curve is not summarized
+ */
+int CurvePyramid::levelCount() const
+{
+	return buckets.size();
+}
+
+/**
+ * @return memory taken by built levels in bytes, mapped levels are counted with their file
+ */
+qint64 CurvePyramid::memoryUsage() const
+{
+	qint64 usage = 0;
+	for (int l = 0; l < levels.size(); l++) {
+		usage += qint64(levels[l].capacity()) * sizeof(Bucket);
+	}
+	return usage;
+}
+
+/**
+ * @param _level level of the pyramid
+ * @return number of samples in a bucket of given level
+ */
+int CurvePyramid::bucketSize(int _level) const
+{
+	int size = BASE_BUCKET;
+	for (int l = 0; l < _level; l++) {
+		size *= FAN_OUT;
+	}
+	return size;
+}
+
+/**
+ * Extends a bucket by the extremes of another one
+ * @param _samples samples of the curve
+ * @param _bucket bucket to be extended
+ * @param _part bucket to be joined
+ */
+void CurvePyramid::join(const QwtSeriesData<QPointF> &_samples, Bucket &_bucket, const Bucket &_part) const
+{
+	if (_samples.sample(_part.minX).x() < _samples.sample(_bucket.minX).x()) {
+		_bucket.minX = _part.minX;
+	}
+	if (_samples.sample(_part.maxX).x() > _samples.sample(_bucket.maxX).x()) {
+		_bucket.maxX = _part.maxX;
+	}
+	if (_samples.sample(_part.minY).y() < _samples.sample(_bucket.minY).y()) {
+		_bucket.minY = _part.minY;
+	}
+	if (_samples.sample(_part.maxY).y() > _samples.sample(_bucket.maxY).y()) {
+		_bucket.maxY = _part.maxY;
+	}
+}
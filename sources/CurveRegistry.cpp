@@ -0,0 +1,122 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/CurveRegistry.h"
+
+/**
+ * Registers a curve under its id and the path of its file
+ * @param _curve curve to be registered
+ * @param _proxy proxy of the curve file, may be null for curves not backed by a file
+ */
+void CurveRegistry::insert(QSharedPointer<Curve> _curve, QSharedPointer<ProxyFile> _proxy)
+{
+	Entry entry;
+	entry.curve = _curve;
+	entry.proxy = _proxy;
+	if (!entries.contains(_curve->getId())) {
+		order.append(_curve->getId());
+	}
+	entries.insert(_curve->getId(), entry);
+	if (_proxy) {
+		paths.insert(_proxy->real_file_path, _curve->getId());
+	}
+}
+
+/**
+ * Removes a curve from the registry
+ * @param _id curve identifier
+ */
+void CurveRegistry::remove(int _id)
+{
+	QHash<int, Entry>::iterator it = entries.find(_id);
+	if (it == entries.end()) {
+		return;
+	}
+	if (it.value().proxy) {
+		paths.remove(it.value().proxy->real_file_path);
+	}
+	entries.erase(it);
+	order.removeOne(_id);
+}
+
+/**
+ * Removes all curves from the registry
+ */
+void CurveRegistry::clear()
+{
+	entries.clear();
+	order.clear();
+	paths.clear();
+}
+
+/**
+ * @param _id curve identifier
+ * @return curve with given id or null pointer
+ */
+QSharedPointer<Curve> CurveRegistry::curve(int _id) const
+{
+	return entries.value(_id).curve;
+}
+
+/**
+ * @param _id curve identifier
+ * @return proxy of the file of a curve with given id or null pointer
+ */
+QSharedPointer<ProxyFile> CurveRegistry::proxy(int _id) const
+{
+	return entries.value(_id).proxy;
+}
+
+/**
+ * @param _path path of a curve file
+ * @return curve loaded from given file or null pointer
+ */
+QSharedPointer<Curve> CurveRegistry::findPath(const QString &_path) const
+{
+	QHash<QString, int>::const_iterator it = paths.find(_path);
+	if (it == paths.end()) {
+		return QSharedPointer<Curve>();
+	}
+	return curve(it.value());
+}
+
+/**
+ * @return all registered curves in the order of registration
+ */
+QList<QSharedPointer<Curve> > CurveRegistry::curves() const
+{
+	QList<QSharedPointer<Curve> > result;
+	result.reserve(order.size());
+	for (int i = 0; i < order.size(); i++) {
+		result.append(entries.value(order[i]).curve);
+	}
+	return result;
+}
+
+/**
+ * @return number of registered curves
+ */
+int CurveRegistry::size() const
+{
+	return entries.size();
+}
@@ -0,0 +1,206 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+#include "../headers/CurveTail.h"
+#include "../headers/DataParser.h"
+#include "../headers/CurveData.h"
+#include "../headers/ScoreSet.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QByteArray>
+#include <cstring>
+
+/**
+ * Constructor of CurveTail class, nothing is parsed until the first update
+ * @param _path path of a text curve file
+ * @param _type OperatingPointScan::ROC_CURVE or OperatingPointScan::PR_CURVE
+ */
+CurveTail::CurveTail(QString _path, int _type):
+	path(_path), type(_type), scan(_type)
+{
+	restart();
+}
+
+/**
+ * Parses lines appended to the file since the last update. A line which is not
+ * complete yet is left for the next update, empty lines are skipped.
+ * @return true if points were added, or the file was rewritten and parsed again
+ * @throw 1001 unsupported structure of a line
+ * @throw 1002 number conversion failed
+ */
+bool CurveTail::update()
+{
+	QFile file(path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		return false;
+	}
+	restarted = false;
+	if (file.size() < offset) {
+		restart();
+		restarted = true;
+	}
+	if (file.size() == offset || !file.seek(offset)) {
+		return restarted;
+	}
+
+	QByteArray appended = file.read(file.size() - offset);
+	const char *begin = appended.constData();
+	const char *end = begin + appended.size();
+	while (end > begin && *(end - 1) != '\n') {
+		--end;
+	}
+
+	int from = points.size();
+	const char *p = begin;
+	while (p < end) {
+		bool finished;
+		p = DataParser::parsePoints(p, end, points, finished);
+	}
+	offset += end - begin;
+	append(from);
+	return restarted || points.size() > from;
+}
+
+/**
+ * @return true if the last update found the file rewritten, so its points were replaced
+ */
+bool CurveTail::wasRestarted() const
+{
+	return restarted;
+}
+
+/**
+ * @return path of the followed file
+ */
+QString CurveTail::getPath() const
+{
+	return path;
+}
+
+/**
+ * @return points parsed so far, the vector stays at the same address while the tail exists
+ */
+const QVector<QPointF>* CurveTail::getPoints() const
+{
+	return &points;
+}
+
+/**
+ * @return number of points parsed so far
+ */
+size_t CurveTail::size() const
+{
+	return points.size();
+}
+
+/**
+ * @return bounding rect of the points parsed so far
+ */
+QRectF CurveTail::boundingRect() const
+{
+	if (points.isEmpty()) {
+		return QRectF();
+	}
+	return QRectF(left, top, right - left, bottom - top);
+}
+
+/**
+ * @return true if x values of the points do not decrease
+ */
+bool CurveTail::isMonotone() const
+{
+	return monotone;
+}
+
+/**
+ * @return area under the points parsed so far, 0 for less than two points
+ */
+double CurveTail::getAUC() const
+{
+	return 0.5 * area.result();
+}
+
+/**
+ * @return operating points of the points parsed so far
+ */
+OperatingPoints CurveTail::getOperatingPoints() const
+{
+	return scan.result();
+}
+
+/**
+ * Checks if a curve can be followed, only text curve files grow line by line
+ * @param _path path of the curve
+ * @return true for .roc and .pr files
+ */
+bool CurveTail::canFollow(QString _path)
+{
+	QString file;
+	int type;
+	if (ScoreSet::splitCurvePath(_path, file, type) || CurveData::isBinary(_path)) {
+		return false;
+	}
+	QString suffix = QFileInfo(_path).suffix();
+	return suffix.compare("roc", Qt::CaseInsensitive) == 0 || suffix.compare("pr", Qt::CaseInsensitive) == 0;
+}
+
+/**
+ * Forgets all parsed points, the file is parsed again from its beginning
+ */
+void CurveTail::restart()
+{
+	offset = 0;
+	restarted = false;
+	points.clear();
+	area = CompensatedSum();
+	scan = OperatingPointScan(type);
+	left = right = top = bottom = 0.0;
+	monotone = true;
+}
+
+/**
+ * Adds new points to the area, the operating points and the bounding rect
+ * @param _from index of the first new point
+ */
+void CurveTail::append(int _from)
+{
+	if (_from >= points.size()) {
+		return;
+	}
+	if (_from == 0) {
+		left = right = points[0].x();
+		top = bottom = points[0].y();
+	}
+	for (int i = qMax(_from, 1); i < points.size(); i++) {
+		const QPointF &previous = points[i - 1];
+		const QPointF &point = points[i];
+		area.add((previous.y() + point.y()) * (point.x() - previous.x()));
+		monotone = monotone && point.x() >= previous.x();
+	}
+	for (int i = _from; i < points.size(); i++) {
+		left = qMin(left, points[i].x());
+		right = qMax(right, points[i].x());
+		top = qMin(top, points[i].y());
+		bottom = qMax(bottom, points[i].y());
+	}
+	scan.add(points.constData() + _from, points.size() - _from);
+}
@@ -0,0 +1,374 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/DataParser.h"
+#include <QByteArray>
+#include <cstring>
+#include <cfloat>
+
+///powers of ten which are exactly representable as double
+static const double exactPowers[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static inline bool isBlank(char c)
+{
+	return c == ' ' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * Converts text to a double value without consulting the current locale.
+ * Leading and trailing blanks are accepted, the same as QString::toDouble does.
+ * Plain decimal numbers with up to 19 significant digits are converted directly,
+ * anything else (inf, nan, very long mantissas, huge exponents) is handed over
+ * to QByteArray::toDouble.
+ * @param begin first character of the number
+ * @param end one past the last character of the number
+ * @param value converted value
+ * @return true if the conversion succeeded
+ */
+bool DataParser::toDouble(const char *begin, const char *end, double &value)
+{
+	while (begin < end && isBlank(*begin))
+		++begin;
+	while (end > begin && isBlank(*(end - 1)))
+		--end;
+	if (begin == end)
+		return false;
+
+	const char *p = begin;
+	bool negative = false;
+	if (*p == '-' || *p == '+') {
+		negative = (*p == '-');
+		++p;
+	}
+
+	quint64 mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	bool anyDigit = false;
+
+	///skip leading zeros, they do not count as significant digits
+	while (p < end && *p == '0') {
+		anyDigit = true;
+		++p;
+	}
+	while (p < end && *p >= '0' && *p <= '9') {
+		if (digits < 19)
+			mantissa = mantissa * 10 + (*p - '0');
+		else
+			++exponent;
+		++digits;
+		anyDigit = true;
+		++p;
+	}
+	if (p < end && *p == '.') {
+		++p;
+		if (digits == 0) {
+			while (p < end && *p == '0') {
+				--exponent;
+				anyDigit = true;
+				++p;
+			}
+		}
+		while (p < end && *p >= '0' && *p <= '9') {
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*p - '0');
+				--exponent;
+			}
+			++digits;
+			anyDigit = true;
+			++p;
+		}
+	}
+	if (!anyDigit) {
+		///inf, nan and the like
+		bool ok;
+		value = QByteArray(begin, end - begin).toDouble(&ok);
+		return ok;
+	}
+
+	if (p < end && (*p == 'e' || *p == 'E')) {
+		++p;
+		bool negativeExp = false;
+		if (p < end && (*p == '-' || *p == '+')) {
+			negativeExp = (*p == '-');
+			++p;
+		}
+		if (p == end || *p < '0' || *p > '9')
+			return false;
+		int e = 0;
+		while (p < end && *p >= '0' && *p <= '9') {
+			if (e < 100000)
+				e = e * 10 + (*p - '0');
+			++p;
+		}
+		exponent += negativeExp ? -e : e;
+	}
+	if (p != end)
+		return false;
+
+	if (digits <= 19 && exponent >= -22 && exponent <= 22) {
+		///both operands are exact, so the single rounding of the division
+		///or multiplication gives the correctly rounded result
+		if (mantissa < (Q_UINT64_C(1) << 53)) {
+			double result = double(mantissa);
+			if (exponent < 0)
+				result /= exactPowers[-exponent];
+			else
+				result *= exactPowers[exponent];
+			value = negative ? -result : result;
+			return true;
+		}
+#if LDBL_MANT_DIG >= 64
+		///extended precision holds any 19 digit mantissa exactly
+		long double result = (long double)mantissa;
+		if (exponent < 0)
+			result /= (long double)exactPowers[-exponent];
+		else
+			result *= (long double)exactPowers[exponent];
+		value = double(negative ? -result : result);
+		return true;
+#endif
+	}
+	if (mantissa == 0) {
+		value = negative ? -0.0 : 0.0;
+		return true;
+	}
+
+	bool ok;
+	value = QByteArray(begin, end - begin).toDouble(&ok);
+	return ok;
+}
+
+/**
+ * Splits a single line on tab characters. Empty fields are skipped,
+ * the same as QString::split with QString::SkipEmptyParts does.
+ * @param begin first character of the line
+ * @param end one past the last character of the line (without the newline)
+ * @param fields array receiving beginnings of the fields
+ * @param ends array receiving ends of the fields
+ * @param maxFields capacity of fields and ends arrays
+ * @return number of fields found, maxFields + 1 if there are more of them
+ */
+int DataParser::splitFields(const char *begin, const char *end, const char **fields, const char **ends, int maxFields)
+{
+	int count = 0;
+	const char *p = begin;
+	while (p < end) {
+		const char *tab = static_cast<const char*>(memchr(p, '\t', end - p));
+		if (!tab)
+			tab = end;
+		if (tab != p) {
+			if (count == maxFields)
+				return maxFields + 1;
+			fields[count] = p;
+			ends[count] = tab;
+			++count;
+		}
+		p = tab + 1;
+	}
+	return count;
+}
+
+/**
+ * Estimates number of lines in a buffer from the line length of its beginning.
+ * Used to reserve the output vector before parsing.
+ * @param begin beginning of the buffer
+ * @param end end of the buffer
+ * @return estimated number of lines
+ */
+int DataParser::estimateLines(const char *begin, const char *end)
+{
+	const qint64 sampleSize = 64 * 1024;
+	qint64 size = end - begin;
+	qint64 sample = size < sampleSize ? size : sampleSize;
+	if (sample == 0)
+		return 0;
+
+	qint64 lines = 0;
+	const char *p = begin;
+	const char *sampleEnd = begin + sample;
+	while ((p = static_cast<const char*>(memchr(p, '\n', sampleEnd - p))) != 0) {
+		++lines;
+		++p;
+	}
+	if (lines == 0)
+		return 1;
+
+	///leave a little headroom so that one reallocation is unlikely
+	qint64 estimate = lines * size / sample + lines * size / sample / 16 + 1;
+	return estimate > 0x7fffffff ? 0x7fffffff : int(estimate);
+}
+
+/**
+ * Parses tab separated (x, y) pairs. Every line has to contain exactly two
+ * fields, an empty line ends the data.
+ * @param begin beginning of the buffer
+ * @param end end of the buffer
+ * @param points vector the parsed points are appended to
+ * @param finished set to true if parsing was stopped by an empty line
+ * @return pointer past the last consumed line
+ * @throw 1001 unsupported structure of a line
+ * @throw 1002 number conversion failed
+ */
+const char* DataParser::parsePoints(const char *begin, const char *end, QVector<QPointF> &points, bool &finished)
+{
+	const char *fields[2];
+	const char *ends[2];
+	const char *p = begin;
+	finished = false;
+
+	while (p < end) {
+		const char *lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+		const char *next = lineEnd ? lineEnd + 1 : end;
+		if (!lineEnd)
+			lineEnd = end;
+		if (lineEnd > p && *(lineEnd - 1) == '\r')
+			--lineEnd;
+
+		int count = splitFields(p, lineEnd, fields, ends, 2);
+		if (count != 2) {
+			if (count == 0) {
+				finished = true;
+				return next;
+			}
+			throw 1001;
+		}
+
+		double x, y;
+		if (!toDouble(fields[0], ends[0], x) || !toDouble(fields[1], ends[1], y)) {
+			throw 1002;
+		}
+		points.append(QPointF(x, y));
+		p = next;
+	}
+	return p;
+}
+
+/**
+ * Parses tab separated (score, label) or (score, label, weight) rows of classifier output.
+ * A label different from 0 marks a positive example, rows without a weight get weight 1.
+ * Empty lines are skipped.
+ * @param begin beginning of the buffer, it has to start at a line boundary
+ * @param end end of the buffer
+ * @param scores vector the parsed scores are appended to
+ * @param labels vector the parsed labels are appended to, 1 for positive examples
+ * @param weights vector the weights are appended to, also for rows without a weight
+ * @param weighted set to true if any row has a weight
+ * @throw 1001 unsupported structure of a line
+ * @throw 1002 number conversion failed, the score is not a number or the weight is negative
+ */
+void DataParser::parseScores(const char *begin, const char *end, QVector<float> &scores, QVector<quint8> &labels,
+	QVector<float> &weights, bool &weighted)
+{
+	const char *fields[3];
+	const char *ends[3];
+	const char *p = begin;
+
+	while (p < end) {
+		const char *lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+		const char *next = lineEnd ? lineEnd + 1 : end;
+		if (!lineEnd)
+			lineEnd = end;
+		if (lineEnd > p && *(lineEnd - 1) == '\r')
+			--lineEnd;
+
+		int count = splitFields(p, lineEnd, fields, ends, 3);
+		if (count == 0) {
+			p = next;
+			continue;
+		}
+		if (count < 2 || count > 3) {
+			throw 1001;
+		}
+
+		double score, label, weight = 1.0;
+		if (!toDouble(fields[0], ends[0], score) || !toDouble(fields[1], ends[1], label)
+			|| (count == 3 && !toDouble(fields[2], ends[2], weight))) {
+			throw 1002;
+		}
+		if (score != score || label != label || !(weight >= 0.0)) {
+			throw 1002;
+		}
+		weighted = weighted || count == 3;
+
+		scores.append(float(score));
+		labels.append(label != 0.0 ? 1 : 0);
+		weights.append(float(weight));
+		p = next;
+	}
+}
+
+/**
+ * Parses tab separated (score, positives, negatives) rows of an aggregate shard, where
+ * every row holds the total weight of positive and negative examples sharing a score.
+ * Empty lines are skipped.
+ * @param begin beginning of the buffer, it has to start at a line boundary
+ * @param end end of the buffer
+ * @param scores vector the parsed scores are appended to
+ * @param positives vector the weights of positive examples are appended to
+ * @param negatives vector the weights of negative examples are appended to
+ * @throw 1001 unsupported structure of a line
+ * @throw 1002 number conversion failed, the score is not a number or a weight is negative
+ */
+void DataParser::parseAggregates(const char *begin, const char *end, QVector<float> &scores,
+	QVector<double> &positives, QVector<double> &negatives)
+{
+	const char *fields[3];
+	const char *ends[3];
+	const char *p = begin;
+
+	while (p < end) {
+		const char *lineEnd = static_cast<const char*>(memchr(p, '\n', end - p));
+		const char *next = lineEnd ? lineEnd + 1 : end;
+		if (!lineEnd)
+			lineEnd = end;
+		if (lineEnd > p && *(lineEnd - 1) == '\r')
+			--lineEnd;
+
+		int count = splitFields(p, lineEnd, fields, ends, 3);
+		if (count == 0) {
+			p = next;
+			continue;
+		}
+		if (count != 3) {
+			throw 1001;
+		}
+
+		double score, positive, negative;
+		if (!toDouble(fields[0], ends[0], score) || !toDouble(fields[1], ends[1], positive)
+			|| !toDouble(fields[2], ends[2], negative)) {
+			throw 1002;
+		}
+		if (score != score || !(positive >= 0.0) || !(negative >= 0.0)) {
+			throw 1002;
+		}
+
+		scores.append(float(score));
+		positives.append(positive);
+		negatives.append(negative);
+		p = next;
+	}
+}
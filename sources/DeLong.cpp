@@ -0,0 +1,267 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/DeLong.h"
+#include "../headers/ScoreSet.h"
+#include "../headers/Metrics.h"
+#include <QtConcurrentMap>
+#include <cmath>
+#include <cstring>
+
+/**
+ * Placement values of one classifier, indexed by the class index of every example
+ */
+struct DeLongModel {
+	const ScoreSet *set;
+	const quint32 *classIndex;			///< index of every example within its class, shared
+	double *positives;					///< placement of positive examples among negatives
+	double *negatives;					///< placement of negative examples among positives
+	quint32 positiveCount;
+	quint32 negativeCount;
+	double auc;
+};
+
+/**
+ * One row of the covariance matrix, from the diagonal to the end
+ */
+struct DeLongRow {
+	const QVector<DeLongModel> *models;
+	double *covariance;
+	int row;
+};
+
+/**
+ * Computes placement values of a classifier in one walk over its sorted examples.
+ * A positive example is placed at the fraction of negatives scored lower, a negative
+ * example at the fraction of positives scored higher, ties count as halves.
+ * @param _model classifier
+ */
+static void computePlacements(DeLongModel &_model)
+{
+	const ScoreSet &set = *_model.set;
+	const float *scores = set.getScores();
+	const quint8 *labels = set.getLabels();
+	const quint32 *order = set.getOrder();
+	quint32 count = quint32(set.size());
+	double m = _model.positiveCount, n = _model.negativeCount;
+
+	CompensatedSum area;
+	quint32 positivesBefore = 0, negativesBefore = 0;
+	quint32 begin = 0;
+	while (begin < count) {
+		float score = scores[order[begin]];
+		quint32 end = begin, groupPositives = 0, groupNegatives = 0;
+		for (; end < count && scores[order[end]] == score; end++) {
+			if (labels[order[end]]) {
+				groupPositives++;
+			}
+			else {
+				groupNegatives++;
+			}
+		}
+		double positivePlacement = (n - negativesBefore - 0.5 * groupNegatives) / n;
+		double negativePlacement = (positivesBefore + 0.5 * groupPositives) / m;
+		for (quint32 i = begin; i < end; i++) {
+			quint32 k = order[i];
+			if (labels[k]) {
+				_model.positives[_model.classIndex[k]] = positivePlacement;
+			}
+			else {
+				_model.negatives[_model.classIndex[k]] = negativePlacement;
+			}
+		}
+		area.add(groupPositives * positivePlacement);
+		positivesBefore += groupPositives;
+		negativesBefore += groupNegatives;
+		begin = end;
+	}
+	_model.auc = area.result() / m;
+}
+
+/**
+ * Computes covariances of one classifier with itself and all following classifiers
+ * @param _row row of the covariance matrix
+ */
+static void computeCovarianceRow(DeLongRow &_row)
+{
+	const QVector<DeLongModel> &models = *_row.models;
+	int count = models.size();
+	const DeLongModel &a = models[_row.row];
+	double m = a.positiveCount, n = a.negativeCount;
+
+	for (int column = _row.row; column < count; column++) {
+		const DeLongModel &b = models[column];
+		CompensatedSum positives, negatives;
+		for (quint32 i = 0; i < a.positiveCount; i++) {
+			positives.add((a.positives[i] - a.auc) * (b.positives[i] - b.auc));
+		}
+		for (quint32 j = 0; j < a.negativeCount; j++) {
+			negatives.add((a.negatives[j] - a.auc) * (b.negatives[j] - b.auc));
+		}
+		double value = positives.result() / ((m - 1.0) * m) + negatives.result() / ((n - 1.0) * n);
+		_row.covariance[_row.row * count + column] = value;
+		_row.covariance[column * count + _row.row] = value;
+	}
+}
+
+/**
+ * DeLong class constructor
+ * @param _count number of compared classifiers
+ */
+DeLong::DeLong(int _count): count(_count), aucs(_count), covariance(_count * _count)
+{
+}
+
+/**
+ * Computes AUCs of classifiers and their covariance matrix. All score sets must hold
+ * the same examples: equal labels in the same order. Weights are not used by the test.
+ * @param _sets score sets of the classifiers, kept in memory
+ * @return AUCs and their covariances
+ * @throw 1008 there are less than two positive or negative examples
+ * @throw 1013 less than two score sets, or a set is streamed or weighted
+ * @throw 1014 score sets have different labels
+ */
+QSharedPointer<DeLong> DeLong::compare(const QList<QSharedPointer<ScoreSet> > &_sets)
+{
+	int count = _sets.size();
+	if (count < 2) {
+		throw 1013;
+	}
+	for (int s = 0; s < count; s++) {
+		if (_sets[s]->isStreamed() || _sets[s]->getWeights()) {
+			throw 1013;
+		}
+	}
+
+	///class index of every example is computed once, labels of all sets must agree
+	const ScoreSet &first = *_sets[0];
+	size_t examples = first.size();
+	const quint8 *labels = first.getLabels();
+	for (int s = 1; s < count; s++) {
+		if (_sets[s]->size() != examples
+				|| memcmp(_sets[s]->getLabels(), labels, examples * sizeof(quint8)) != 0) {
+			throw 1014;
+		}
+	}
+	QVector<quint32> classIndex(examples);
+	quint32 positiveCount = 0, negativeCount = 0;
+	for (size_t i = 0; i < examples; i++) {
+		classIndex[i] = labels[i] ? positiveCount++ : negativeCount++;
+	}
+	if (positiveCount < 2 || negativeCount < 2) {
+		throw 1008;
+	}
+
+	///placements of every classifier have their own buffer, all of them together exceed an int
+	QVector<QVector<double> > placements(count);
+	QVector<DeLongModel> models(count);
+	for (int s = 0; s < count; s++) {
+		placements[s].resize(int(examples));
+		models[s].set = _sets[s].data();
+		models[s].classIndex = classIndex.constData();
+		models[s].positives = placements[s].data();
+		models[s].negatives = models[s].positives + positiveCount;
+		models[s].positiveCount = positiveCount;
+		models[s].negativeCount = negativeCount;
+	}
+	QtConcurrent::blockingMap(models, computePlacements);
+
+	QSharedPointer<DeLong> result(new DeLong(count));
+	QVector<DeLongRow> rows(count);
+	for (int s = 0; s < count; s++) {
+		result->aucs[s] = models[s].auc;
+		rows[s].models = &models;
+		rows[s].covariance = result->covariance.data();
+		rows[s].row = s;
+	}
+	QtConcurrent::blockingMap(rows, computeCovarianceRow);
+	return result;
+}
+
+/**
+ * @return number of compared classifiers
+ */
+int DeLong::size() const
+{
+	return count;
+}
+
+/**
+ * @param _model classifier index
+ * @return area under the ROC curve of the classifier, ties counted as halves
+ */
+double DeLong::getAUC(int _model) const
+{
+	return aucs[_model];
+}
+
+/**
+ * @param _first classifier index
+ * @param _second classifier index
+ * @return estimated covariance of AUCs of the classifiers
+ */
+double DeLong::getCovariance(int _first, int _second) const
+{
+	return covariance[_first * count + _second];
+}
+
+/**
+ * @param _first classifier index
+ * @param _second classifier index
+ * @return difference of AUCs divided by its standard error, 0 if the error is 0
+ */
+double DeLong::zScore(int _first, int _second) const
+{
+	double variance = getCovariance(_first, _first) + getCovariance(_second, _second)
+		- 2.0 * getCovariance(_first, _second);
+	if (!(variance > 0.0)) {
+		return 0.0;
+	}
+	return (aucs[_first] - aucs[_second]) / std::sqrt(variance);
+}
+
+/**
+ * @param _first classifier index
+ * @param _second classifier index
+ * @return two-sided p-value of the hypothesis that both AUCs are equal
+ */
+double DeLong::pValue(int _first, int _second) const
+{
+	return 2.0 * normalTail(std::fabs(zScore(_first, _second)));
+}
+
+/**
+ * Computes the upper tail of the standard normal distribution with the Chebyshev
+ * approximation of the complementary error function, relative error below 1.2e-7
+ * @param _z value
+ * @return probability that a standard normal variable exceeds the value
+ */
+double DeLong::normalTail(double _z)
+{
+	double x = std::fabs(_z) / std::sqrt(2.0);
+	double t = 1.0 / (1.0 + 0.5 * x);
+	double erfc = t * std::exp(-x * x - 1.26551223 + t * (1.00002368 + t * (0.37409196
+		+ t * (0.09678418 + t * (-0.18628806 + t * (0.27886807 + t * (-1.13520398
+		+ t * (1.48851587 + t * (-0.82215223 + t * 0.17087277)))))))));
+	return _z >= 0.0 ? 0.5 * erfc : 1.0 - 0.5 * erfc;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+#include "../headers/ErrorCodes.h"
+
+/**
+ * Describes an error code raised while opening, loading or writing a file
+ * @param _code error code
+ * @return message shown to the user, empty for an unknown code
+ */
+QString ErrorCodes::message(int _code)
+{
+	QString message;
+	if (_code==1000)
+		message = "error. unknown file extension";
+	else if (_code==1001)
+		message = "error parsing the file. unsupported structure of file";
+	else if (_code==1002)
+		message = "error parsing the file. data conversion failed";
+	else if (_code==1003)
+		message = "error parsing the file. to little data points";
+	else if (_code==1005)
+		message = "error. not a valid binary curve file";
+	else if (_code==1006)
+		message = "error. binary curve file is corrupted (checksum mismatch)";
+	else if (_code==1007)
+		message = "error. unable to write the file";
+	else if (_code==1008)
+		message = "error. score file needs both positive and negative examples";
+	else if (_code==1009)
+		message = "error. score sketches have different bins and cannot be merged";
+	else if (_code==1010)
+		message = "error. score shard is not sorted by descending score";
+	else if (_code==1011)
+		message = "error. shard manifest or one of its shards cannot be read";
+	else if (_code==1012)
+		message = "error. confidence bands need a score file whose examples fit in memory";
+	else if (_code==1013)
+		message = "error. significance test needs two or more unweighted score files whose examples fit in memory";
+	else if (_code==1014)
+		message = "error. compared score files must have the same examples with the same labels";
+	else if (_code==1015)
+		message = "error. threshold averaging needs curves of score files whose examples fit in memory, other curves were left out";
+	else if (_code==1016)
+		message = "error. invalid options of batch rendering";
+	else if (_code==1017)
+		message = "error. unable to read the file";
+	return message;
+}
@@ -25,10 +25,12 @@
 
 /**
  * Constructor of FunctionData class
- * @param _dataPoints vector of points to be displayed in the plot
+ * @param _dataPoints vector of points to be displayed in the plot, null for derived classes providing own samples
+ * @param _rect bounding rect of the points computed at load time
+ * @param _monotone true if x values of the points do not decrease
  */
-FunctionData::FunctionData(QVector<QPointF> *_dataPoints){
-	dataPoints=_dataPoints;
+FunctionData::FunctionData(const QVector<QPointF> *_dataPoints, QRectF _rect, bool _monotone):
+	dataPoints(_dataPoints), rect(_rect), monotone(_monotone) {
 }
      
 /**
@@ -48,11 +50,145 @@ size_t FunctionData::size() const{
 }
 
 /**
- *
- * @return
+ * Return bounding rect cached at load time
+ * @return bounding rect of all points
  */
 QRectF FunctionData::boundingRect() const
 {
-	return QRectF();
+	return rect;
+}
+
+/**
+ * @return true if x values of the points do not decrease
+ */
+bool FunctionData::isMonotone() const{
+	return monotone;
+}
+
+/**
+ * Finds samples which have to be drawn to show the curve between two x values.
+ * The range includes one sample on each side of the interval, so that the lines
+ * crossing its borders are drawn. Only curves with monotone x values can be searched.
+ * @param _left lower bound of the interval
+ * @param _right upper bound of the interval
+ * @param _from receives index of the first sample to be drawn
+ * @param _to receives index of the last sample to be drawn
+ * @return false if the curve is not monotone or no sample is visible
+ */
+bool FunctionData::visibleRange(double _left, double _right, int &_from, int &_to) const{
+	size_t count = size();
+	if (!monotone || count == 0) {
+		return false;
+	}
+	if (_left > _right) {
+		qSwap(_left, _right);
+	}
+
+	size_t first = lowerBound(_left);
+	size_t last = upperBound(_right);
+
+	///the interval lies between two samples, draw the line joining them
+	if (first > 0) {
+		first--;
+	}
+	if (last < count) {
+		last++;
+	}
+	if (first >= last) {
+		return false;
+	}
+	_from = int(first);
+	_to = int(last) - 1;
+	return true;
 }
 
+/**
+ * Computes bounding rect of points in one pass, which also checks if their x values do not decrease.
+ * Extremes are kept in separate variables without branches, which lets the compiler vectorize the loop.
+ * @param _points points of a curve
+ * @param _count number of points
+ * @param _monotone receives true if x values do not decrease
+ * @return bounding rect of the points
+ */
+QRectF FunctionData::computeBoundingRect(const QPointF *_points, size_t _count, bool &_monotone){
+	_monotone = true;
+	if (_count == 0) {
+		return QRectF();
+	}
+
+	double left = _points[0].x(), right = left;
+	double top = _points[0].y(), bottom = top;
+	double previous = left;
+	bool decreasing = false;
+	for (size_t i = 1; i < _count; i++) {
+		double x = _points[i].x();
+		double y = _points[i].y();
+		left = x < left ? x : left;
+		right = x > right ? x : right;
+		top = y < top ? y : top;
+		bottom = y > bottom ? y : bottom;
+		decreasing |= x < previous;
+		previous = x;
+	}
+	_monotone = !decreasing;
+	return QRectF(left, top, right - left, bottom - top);
+}
+
+/**
+ * Checks if x values of samples do not decrease
+ * @param _samples samples of a curve
+ * @return true if x values do not decrease
+ */
+bool FunctionData::checkMonotone(const QwtSeriesData<QPointF> &_samples){
+	size_t count = _samples.size();
+	if (count == 0) {
+		return true;
+	}
+	double previous = _samples.sample(0).x();
+	for (size_t i = 1; i < count; i++) {
+		double x = _samples.sample(i).x();
+		if (x < previous) {
+			return false;
+		}
+		previous = x;
+	}
+	return true;
+}
+
+/**
+ * @param _x searched value
+ * @return index of the first sample whose x is not less than given value
+ */
+size_t FunctionData::lowerBound(double _x) const{
+	size_t first = 0, count = size();
+	while (count > 0) {
+		size_t step = count / 2;
+		if (sample(first + step).x() < _x) {
+			first += step + 1;
+			count -= step + 1;
+		}
+		else {
+			count = step;
+		}
+	}
+	return first;
+}
+
+/**
+ * @param _x searched value
+ * @return index of the first sample whose x is greater than given value
+ */
+size_t FunctionData::upperBound(double _x) const{
+	size_t first = 0, count = size();
+	while (count > 0) {
+		size_t step = count / 2;
+		if (!(_x < sample(first + step).x())) {
+			first += step + 1;
+			count -= step + 1;
+		}
+		else {
+			count = step;
+		}
+	}
+	return first;
+}
@@ -0,0 +1,690 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/Metrics.h"
+#include <cmath>
+#include <limits>
+
+///vector kernels are compiled for x86 with function level target attributes,
+///so the rest of the program does not depend on the instruction set
+#if (defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__ >= 409) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+#define METRICS_X86
+#define METRICS_TARGET(name) __attribute__((target(name)))
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#define METRICS_X86
+#define METRICS_TARGET(name)
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+/**
+ * Adds a value and keeps the rounding error of the addition
+ * @param _value value to be added
+ */
+void CompensatedSum::add(double _value)
+{
+	double t = sum + _value;
+	if (std::fabs(sum) >= std::fabs(_value)) {
+		compensation += (sum - t) + _value;
+	}
+	else {
+		compensation += (_value - t) + sum;
+	}
+	sum = t;
+}
+
+/**
+ * @return the sum corrected by the accumulated rounding errors
+ */
+double CompensatedSum::result() const
+{
+	return sum + compensation;
+}
+
+/**
+ * Computes the area under a curve with the trapezoidal rule, using the fastest kernel
+ * supported by the processor. Segments going back in x give negative area.
+ * @param _points curve points sorted by x
+ * @param _count number of points
+ * @return area under the curve, 0 for less than two points
+ */
+double Metrics::auc(const QPointF *_points, size_t _count)
+{
+	static const Kernel kernel = bestKernel();
+	return auc(_points, _count, kernel);
+}
+
+/**
+ * Computes the area under a curve with a chosen kernel.
+ * Kernels differ only in the order of additions, the results agree to a few ulps.
+ * @param _points curve points
+ * @param _count number of points
+ * @param _kernel kernel to be used, it has to be supported by the processor
+ * @return area under the curve, 0 for less than two points
+ */
+double Metrics::auc(const QPointF *_points, size_t _count, Kernel _kernel)
+{
+	if (_count < 2) {
+		return 0.0;
+	}
+	switch (_kernel) {
+	case AVX:
+		return avxAuc(_points, _count);
+	case SSE2:
+		return sse2Auc(_points, _count);
+	default:
+		return scalarAuc(_points, _count);
+	}
+}
+
+/**
+ * Computes the area under a part of a curve between two x values (partial AUC).
+ * The curve is interpolated linearly at the borders of the interval,
+ * which is limited to the x range of the curve.
+ * @param _points curve points, x values must not decrease
+ * @param _count number of points
+ * @param _from lower bound of the interval, e.g. the lowest false positive rate
+ * @param _to upper bound of the interval
+ * @return area under the curve inside the interval
+ */
+double Metrics::partialAuc(const QPointF *_points, size_t _count, double _from, double _to)
+{
+	if (_count < 2) {
+		return 0.0;
+	}
+	_from = qMax(_from, _points[0].x());
+	_to = qMin(_to, _points[_count - 1].x());
+	if (!(_from < _to)) {
+		return 0.0;
+	}
+
+	///first point right of the lower bound and first point not left of the upper bound
+	size_t first = 0, count = _count;
+	while (count > 0) {
+		size_t step = count / 2;
+		if (!(_from < _points[first + step].x())) {
+			first += step + 1;
+			count -= step + 1;
+		}
+		else {
+			count = step;
+		}
+	}
+	size_t end = 0;
+	count = _count;
+	while (count > 0) {
+		size_t step = count / 2;
+		if (_points[end + step].x() < _to) {
+			end += step + 1;
+			count -= step + 1;
+		}
+		else {
+			count = step;
+		}
+	}
+
+	///both borders lie inside segments of non-zero width
+	const QPointF &a = _points[first - 1], &b = _points[first];
+	double yFrom = a.y() + (b.y() - a.y()) * (_from - a.x()) / (b.x() - a.x());
+	const QPointF &c = _points[end - 1], &d = _points[end];
+	double yTo = c.y() + (d.y() - c.y()) * (_to - c.x()) / (d.x() - c.x());
+
+	if (first >= end) {
+		return 0.5 * (yFrom + yTo) * (_to - _from);
+	}
+
+	CompensatedSum area;
+	area.add(0.5 * (yFrom + b.y()) * (b.x() - _from));
+	area.add(auc(_points + first, end - first));
+	area.add(0.5 * (c.y() + yTo) * (_to - c.x()));
+	return area.result();
+}
+
+/**
+ * Finds operating points of a curve in one pass, see OperatingPointScan
+ * @param _points curve points in the order of decreasing threshold
+ * @param _count number of points
+ * @param _type OperatingPointScan::ROC_CURVE or OperatingPointScan::PR_CURVE
+ * @param _prevalence fraction of positive examples, 0 if unknown
+ * @return operating points of the curve
+ */
+OperatingPoints Metrics::operatingPoints(const QPointF *_points, size_t _count, int _type, double _prevalence)
+{
+	OperatingPointScan scan(_type, _prevalence);
+	scan.add(_points, _count);
+	return scan.result();
+}
+
+/**
+ * Derives a PR curve from a ROC curve. Recall is TPR and precision is
+ * pi TPR / (pi TPR + (1 - pi) FPR) for prevalence pi of positive examples.
+ * Points at the origin of the ROC curve have no precision, they take the precision
+ * of the first threshold, as PR curves built from scores do.
+ * Segments are mapped through their ends, the curve is not interpolated between them.
+ * @param _roc points of the ROC curve
+ * @param _count number of points
+ * @param _prevalence fraction of positive examples, between 0 and 1
+ * @param _pr receives _count points of the PR curve, may not overlap _roc
+ */
+void Metrics::precisionRecall(const QPointF *_roc, size_t _count, double _prevalence, QPointF *_pr)
+{
+	static const Kernel kernel = bestKernel();
+	if (kernel == Scalar) {
+		scalarPrecision(_roc, _count, _prevalence, _pr);
+	}
+	else {
+		sse2Precision(_roc, _count, _prevalence, _pr);
+	}
+
+	size_t first = 0;
+	while (first < _count && _roc[first].x() == 0.0 && _roc[first].y() == 0.0) {
+		first++;
+	}
+	double precision = first < _count ? _pr[first].y() : 1.0;
+	for (size_t i = 0; i < first; i++) {
+		_pr[i].setY(precision);
+	}
+}
+
+/**
+ * Interpolates a curve linearly at given x values. Segment s of the curve runs from
+ * point s to point s+1, values outside a segment take its nearer end, and vertical
+ * segments give their upper end.
+ * @param _points curve points
+ * @param _segments index of the segment used for every x value, the curve has more points
+ * @param _x x values
+ * @param _count number of x values
+ * @param _y receives _count interpolated y values
+ */
+void Metrics::interpolate(const QPointF *_points, const quint32 *_segments, const double *_x, size_t _count, double *_y)
+{
+	static const Kernel kernel = bestKernel();
+	if (kernel == Scalar) {
+		scalarInterpolate(_points, _segments, _x, _count, _y);
+	}
+	else {
+		sse2Interpolate(_points, _segments, _x, _count, _y);
+	}
+}
+
+/**
+ * Checks which kernels the processor and the operating system support
+ * @return the fastest supported kernel
+ */
+Metrics::Kernel Metrics::bestKernel()
+{
+	///vector kernels read QPointF as pairs of doubles
+	if (sizeof(QPointF) != 2 * sizeof(double)) {
+		return Scalar;
+	}
+#if defined(METRICS_X86) && defined(_MSC_VER)
+	int info[4];
+	__cpuid(info, 1);
+	bool osAvx = (info[2] & (1 << 27)) && (_xgetbv(0) & 6) == 6;
+	if ((info[2] & (1 << 28)) && osAvx) {
+		return AVX;
+	}
+	if (info[3] & (1 << 26)) {
+		return SSE2;
+	}
+#elif defined(METRICS_X86)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx")) {
+		return AVX;
+	}
+	if (__builtin_cpu_supports("sse2")) {
+		return SSE2;
+	}
+#endif
+	return Scalar;
+}
+
+/**
+ * @param _kernel kernel
+ * @return name of the kernel
+ */
+const char* Metrics::kernelName(Kernel _kernel)
+{
+	switch (_kernel) {
+	case AVX:
+		return "AVX";
+	case SSE2:
+		return "SSE2";
+	default:
+		return "scalar";
+	}
+}
+
+/**
+ * Reference kernel of PR curve derivation, see precisionRecall
+ * @param _roc points of the ROC curve
+ * @param _count number of points
+ * @param _prevalence fraction of positive examples
+ * @param _pr receives points of the PR curve
+ */
+void Metrics::scalarPrecision(const QPointF *_roc, size_t _count, double _prevalence, QPointF *_pr)
+{
+	double negative = 1.0 - _prevalence;
+	for (size_t i = 0; i < _count; i++) {
+		double hits = _prevalence * _roc[i].y();
+		double predicted = hits + negative * _roc[i].x();
+		_pr[i] = QPointF(_roc[i].y(), predicted > 0.0 ? hits / predicted : 1.0);
+	}
+}
+
+/**
+ * Reference kernel of linear interpolation, see interpolate
+ * @param _points curve points
+ * @param _segments segment of every x value
+ * @param _x x values
+ * @param _count number of x values
+ * @param _y receives interpolated y values
+ */
+void Metrics::scalarInterpolate(const QPointF *_points, const quint32 *_segments, const double *_x, size_t _count, double *_y)
+{
+	for (size_t i = 0; i < _count; i++) {
+		const QPointF &a = _points[_segments[i]];
+		const QPointF &b = _points[_segments[i] + 1];
+		double width = b.x() - a.x();
+		double t = width > 0.0 ? (_x[i] - a.x()) / width : 1.0;
+		t = qMin(qMax(t, 0.0), 1.0);
+		_y[i] = a.y() + (b.y() - a.y()) * t;
+	}
+}
+
+/**
+ * Reference kernel, adds doubled trapezoids one by one
+ * @param _points curve points
+ * @param _count number of points, at least 2
+ * @return area under the curve
+ */
+double Metrics::scalarAuc(const QPointF *_points, size_t _count)
+{
+	CompensatedSum area;
+	for (size_t i = 0; i + 1 < _count; i++) {
+		area.add((_points[i].y() + _points[i + 1].y()) * (_points[i + 1].x() - _points[i].x()));
+	}
+	return 0.5 * area.result();
+}
+
+/**
+ * Constructor of OperatingPoints structure, no value is available
+ */
+OperatingPoints::OperatingPoints():
+	eer(std::numeric_limits<double>::quiet_NaN()), maxF1(eer), youden(eer),
+	tprAt1e3(eer), tprAt1e4(eer), breakEven(eer)
+{
+}
+
+/**
+ * @param _value value of an operating point
+ * @return false if the value cannot be read from the curve (NaN)
+ */
+bool OperatingPoints::isAvailable(double _value)
+{
+	return _value == _value;
+}
+
+/**
+ * @param _current current maximum, NaN if there is none yet
+ * @param _value new value
+ * @return the larger value
+ */
+static inline double keepMax(double _current, double _value)
+{
+	return _current >= _value ? _current : _value;
+}
+
+/**
+ * @param _from start of a segment
+ * @param _to end of the segment
+ * @param _t position on the segment, 0 at its start
+ * @return point of the segment
+ */
+static inline QPointF interpolate(const QPointF &_from, const QPointF &_to, double _t)
+{
+	return QPointF(_from.x() + _t * (_to.x() - _from.x()), _from.y() + _t * (_to.y() - _from.y()));
+}
+
+/**
+ * Constructor of OperatingPointScan class
+ * @param _type ROC_CURVE or PR_CURVE
+ * @param _prevalence fraction of positive examples, 0 if unknown
+ */
+OperatingPointScan::OperatingPointScan(int _type, double _prevalence):
+	type(_type), prevalence(_prevalence), started(false)
+{
+	OperatingPoints none;
+	eer = maxF1 = youden = tprAt1e3 = tprAt1e4 = breakEven = none.eer;
+}
+
+/**
+ * Adds the next block of points of the curve
+ * @param _points points in the order of decreasing threshold
+ * @param _count number of points
+ */
+void OperatingPointScan::add(const QPointF *_points, size_t _count)
+{
+	if (type == PR_CURVE) {
+		addPr(_points, _count);
+	}
+	else {
+		addRoc(_points, _count);
+	}
+}
+
+/**
+ * Adds points of a ROC curve. Values at a given FPR are interpolated on the segment
+ * containing it, crossings are interpolated on the segment where they occur.
+ * With known prevalence pi, F1 = 2 pi TPR / (pi TPR + pi + (1 - pi) FPR) and precision
+ * equals recall where pi TPR + (1 - pi) FPR = pi, which is linear on every segment.
+ * @param _points points of the curve
+ * @param _count number of points
+ */
+void OperatingPointScan::addRoc(const QPointF *_points, size_t _count)
+{
+	const double low[2] = { 1e-3, 1e-4 };
+	double *tpr[2] = { &tprAt1e3, &tprAt1e4 };
+	double pi = prevalence;
+
+	for (size_t i = 0; i < _count; i++) {
+		const QPointF &p = _points[i];
+		youden = keepMax(youden, p.y() - p.x());
+		if (pi > 0.0) {
+			double denominator = pi * p.y() + pi + (1.0 - pi) * p.x();
+			maxF1 = keepMax(maxF1, denominator > 0.0 ? 2.0 * pi * p.y() / denominator : 0.0);
+		}
+
+		if (!started) {
+			started = true;
+			for (int k = 0; k < 2; k++) {
+				if (p.x() <= low[k]) {
+					*tpr[k] = p.y();
+				}
+			}
+			if (p.x() + p.y() >= 1.0) {
+				eer = p.x();
+			}
+			last = p;
+			continue;
+		}
+
+		for (int k = 0; k < 2; k++) {
+			if (last.x() <= low[k]) {
+				double y = p.x() <= low[k] ? p.y() : interpolate(last, p, (low[k] - last.x()) / (p.x() - last.x())).y();
+				*tpr[k] = keepMax(*tpr[k], y);
+			}
+		}
+
+		///FNR = 1 - TPR falls below FPR on this segment
+		double before = last.x() + last.y() - 1.0, after = p.x() + p.y() - 1.0;
+		if (!OperatingPoints::isAvailable(eer) && after >= 0.0) {
+			eer = interpolate(last, p, before < 0.0 ? -before / (after - before) : 0.0).x();
+		}
+
+		if (pi > 0.0 && !OperatingPoints::isAvailable(breakEven)) {
+			before = pi * last.y() + (1.0 - pi) * last.x() - pi;
+			after = pi * p.y() + (1.0 - pi) * p.x() - pi;
+			if (after >= 0.0) {
+				breakEven = interpolate(last, p, before < 0.0 ? -before / (after - before) : 0.0).y();
+			}
+		}
+		last = p;
+	}
+}
+
+/**
+ * Adds points of a PR curve, x is recall and y is precision
+ * @param _points points of the curve
+ * @param _count number of points
+ */
+void OperatingPointScan::addPr(const QPointF *_points, size_t _count)
+{
+	for (size_t i = 0; i < _count; i++) {
+		const QPointF &p = _points[i];
+		double sum = p.x() + p.y();
+		maxF1 = keepMax(maxF1, sum > 0.0 ? 2.0 * p.x() * p.y() / sum : 0.0);
+
+		///precision falls to recall on this segment
+		if (started && !OperatingPoints::isAvailable(breakEven)) {
+			double before = last.y() - last.x(), after = p.y() - p.x();
+			if (before > 0.0 && after <= 0.0) {
+				breakEven = interpolate(last, p, before / (before - after)).x();
+			}
+		}
+		started = true;
+		last = p;
+	}
+}
+
+/**
+ * @return operating points found in the points added so far
+ */
+OperatingPoints OperatingPointScan::result() const
+{
+	OperatingPoints points;
+	points.eer = eer;
+	points.maxF1 = maxF1;
+	points.youden = youden;
+	points.tprAt1e3 = tprAt1e3;
+	points.tprAt1e4 = tprAt1e4;
+	points.breakEven = breakEven;
+	return points;
+}
+
+#ifdef METRICS_X86
+
+/**
+ * SSE2 kernel, computes two trapezoids at once. Every lane keeps a Kahan sum,
+ * the lanes are joined in the scalar compensated sum together with the remaining segments.
+ * @param _points curve points
+ * @param _count number of points, at least 2
+ * @return area under the curve
+ */
+METRICS_TARGET("sse2")
+double Metrics::sse2Auc(const QPointF *_points, size_t _count)
+{
+	const double *p = reinterpret_cast<const double*>(_points);
+	__m128d sum = _mm_setzero_pd();
+	__m128d compensation = _mm_setzero_pd();
+
+	size_t i = 0;
+	for (; i + 2 < _count; i += 2) {
+		///a, b, c hold points i, i+1, i+2 as (x, y)
+		__m128d a = _mm_loadu_pd(p + 2 * i);
+		__m128d b = _mm_loadu_pd(p + 2 * i + 2);
+		__m128d c = _mm_loadu_pd(p + 2 * i + 4);
+		__m128d dx = _mm_unpacklo_pd(_mm_sub_pd(b, a), _mm_sub_pd(c, b));
+		__m128d sy = _mm_unpackhi_pd(_mm_add_pd(a, b), _mm_add_pd(b, c));
+		__m128d term = _mm_sub_pd(_mm_mul_pd(dx, sy), compensation);
+		__m128d t = _mm_add_pd(sum, term);
+		compensation = _mm_sub_pd(_mm_sub_pd(t, sum), term);
+		sum = t;
+	}
+
+	double sums[2], compensations[2];
+	_mm_storeu_pd(sums, sum);
+	_mm_storeu_pd(compensations, compensation);
+
+	CompensatedSum area;
+	for (int lane = 0; lane < 2; lane++) {
+		area.add(sums[lane]);
+		area.add(-compensations[lane]);
+	}
+	for (; i + 1 < _count; i++) {
+		area.add((_points[i].y() + _points[i + 1].y()) * (_points[i + 1].x() - _points[i].x()));
+	}
+	return 0.5 * area.result();
+}
+
+/**
+ * AVX kernel, computes four trapezoids at once in the same way as the SSE2 kernel.
+ * Only double precision AVX instructions are used, no FMA, so products are rounded
+ * exactly as in the other kernels.
+ * @param _points curve points
+ * @param _count number of points, at least 2
+ * @return area under the curve
+ */
+METRICS_TARGET("avx")
+double Metrics::avxAuc(const QPointF *_points, size_t _count)
+{
+	const double *p = reinterpret_cast<const double*>(_points);
+	__m256d sum = _mm256_setzero_pd();
+	__m256d compensation = _mm256_setzero_pd();
+
+	size_t i = 0;
+	for (; i + 4 < _count; i += 4) {
+		///a holds points i, i+1, b holds points i+2, i+3, the shifted vectors start one point later
+		__m256d a = _mm256_loadu_pd(p + 2 * i);
+		__m256d a1 = _mm256_loadu_pd(p + 2 * i + 2);
+		__m256d b = _mm256_loadu_pd(p + 2 * i + 4);
+		__m256d b1 = _mm256_loadu_pd(p + 2 * i + 6);
+		__m256d dx = _mm256_unpacklo_pd(_mm256_sub_pd(a1, a), _mm256_sub_pd(b1, b));
+		__m256d sy = _mm256_unpackhi_pd(_mm256_add_pd(a, a1), _mm256_add_pd(b, b1));
+		__m256d term = _mm256_sub_pd(_mm256_mul_pd(dx, sy), compensation);
+		__m256d t = _mm256_add_pd(sum, term);
+		compensation = _mm256_sub_pd(_mm256_sub_pd(t, sum), term);
+		sum = t;
+	}
+
+	double sums[4], compensations[4];
+	_mm256_storeu_pd(sums, sum);
+	_mm256_storeu_pd(compensations, compensation);
+	_mm256_zeroupper();
+
+	CompensatedSum area;
+	for (int lane = 0; lane < 4; lane++) {
+		area.add(sums[lane]);
+		area.add(-compensations[lane]);
+	}
+	for (; i + 1 < _count; i++) {
+		area.add((_points[i].y() + _points[i + 1].y()) * (_points[i + 1].x() - _points[i].x()));
+	}
+	return 0.5 * area.result();
+}
+
+/**
+ * SSE2 kernel of PR curve derivation, computes two points at once
+ * @param _roc points of the ROC curve
+ * @param _count number of points
+ * @param _prevalence fraction of positive examples
+ * @param _pr receives points of the PR curve
+ */
+METRICS_TARGET("sse2")
+void Metrics::sse2Precision(const QPointF *_roc, size_t _count, double _prevalence, QPointF *_pr)
+{
+	const double *p = reinterpret_cast<const double*>(_roc);
+	double *q = reinterpret_cast<double*>(_pr);
+	__m128d prevalence = _mm_set1_pd(_prevalence);
+	__m128d negative = _mm_set1_pd(1.0 - _prevalence);
+	__m128d one = _mm_set1_pd(1.0);
+	__m128d zero = _mm_setzero_pd();
+
+	size_t i = 0;
+	for (; i + 2 <= _count; i += 2) {
+		///a and b hold points i and i+1 as (FPR, TPR)
+		__m128d a = _mm_loadu_pd(p + 2 * i);
+		__m128d b = _mm_loadu_pd(p + 2 * i + 2);
+		__m128d fpr = _mm_unpacklo_pd(a, b);
+		__m128d tpr = _mm_unpackhi_pd(a, b);
+		__m128d hits = _mm_mul_pd(prevalence, tpr);
+		__m128d predicted = _mm_add_pd(hits, _mm_mul_pd(negative, fpr));
+		__m128d defined = _mm_cmpgt_pd(predicted, zero);
+		__m128d precision = _mm_div_pd(hits, _mm_or_pd(_mm_and_pd(defined, predicted), _mm_andnot_pd(defined, one)));
+		precision = _mm_or_pd(_mm_and_pd(defined, precision), _mm_andnot_pd(defined, one));
+		_mm_storeu_pd(q + 2 * i, _mm_unpacklo_pd(tpr, precision));
+		_mm_storeu_pd(q + 2 * i + 2, _mm_unpackhi_pd(tpr, precision));
+	}
+	scalarPrecision(_roc + i, _count - i, _prevalence, _pr + i);
+}
+
+/**
+ * SSE2 kernel of linear interpolation, computes two values at once
+ * @param _points curve points
+ * @param _segments segment of every x value
+ * @param _x x values
+ * @param _count number of x values
+ * @param _y receives interpolated y values
+ */
+METRICS_TARGET("sse2")
+void Metrics::sse2Interpolate(const QPointF *_points, const quint32 *_segments, const double *_x, size_t _count, double *_y)
+{
+	const double *p = reinterpret_cast<const double*>(_points);
+	__m128d zero = _mm_setzero_pd();
+	__m128d one = _mm_set1_pd(1.0);
+
+	size_t i = 0;
+	for (; i + 2 <= _count; i += 2) {
+		///a0, b0 and a1, b1 are the ends of both segments as (x, y)
+		__m128d a0 = _mm_loadu_pd(p + 2 * _segments[i]);
+		__m128d b0 = _mm_loadu_pd(p + 2 * _segments[i] + 2);
+		__m128d a1 = _mm_loadu_pd(p + 2 * _segments[i + 1]);
+		__m128d b1 = _mm_loadu_pd(p + 2 * _segments[i + 1] + 2);
+		__m128d ax = _mm_unpacklo_pd(a0, a1), ay = _mm_unpackhi_pd(a0, a1);
+		__m128d bx = _mm_unpacklo_pd(b0, b1), by = _mm_unpackhi_pd(b0, b1);
+		__m128d width = _mm_sub_pd(bx, ax);
+		__m128d sloped = _mm_cmpgt_pd(width, zero);
+		__m128d t = _mm_div_pd(_mm_sub_pd(_mm_loadu_pd(_x + i), ax), _mm_or_pd(_mm_and_pd(sloped, width), _mm_andnot_pd(sloped, one)));
+		t = _mm_or_pd(_mm_and_pd(sloped, t), _mm_andnot_pd(sloped, one));
+		t = _mm_min_pd(_mm_max_pd(t, zero), one);
+		_mm_storeu_pd(_y + i, _mm_add_pd(ay, _mm_mul_pd(_mm_sub_pd(by, ay), t)));
+	}
+	scalarInterpolate(_points, _segments + i, _x + i, _count - i, _y + i);
+}
+
+#else
+
+/**
+ * Processors other than x86 use the scalar kernel
+ */
+void Metrics::sse2Interpolate(const QPointF *_points, const quint32 *_segments, const double *_x, size_t _count, double *_y)
+{
+	scalarInterpolate(_points, _segments, _x, _count, _y);
+}
+
+/**
+ * Processors other than x86 use the scalar kernel
+ */
+void Metrics::sse2Precision(const QPointF *_roc, size_t _count, double _prevalence, QPointF *_pr)
+{
+	scalarPrecision(_roc, _count, _prevalence, _pr);
+}
+
+/**
+ * Processors other than x86 use the scalar kernel
+ */
+double Metrics::sse2Auc(const QPointF *_points, size_t _count)
+{
+	return scalarAuc(_points, _count);
+}
+
+/**
+ * Processors other than x86 use the scalar kernel
+ */
+double Metrics::avxAuc(const QPointF *_points, size_t _count)
+{
+	return scalarAuc(_points, _count);
+}
+
+#endif
@@ -21,6 +21,7 @@
  */
 
 #include "../headers/Panel.h"
+#include "../headers/DeLong.h"
 #include <qlabel.h>
 #include <qcombobox.h>
 #include <qlayout.h>
@@ -28,10 +29,27 @@
 #include <qwt_plot_curve.h>
 #include <qlineedit.h>
 #include <qpushbutton.h>
+#include <qtablewidget.h>
+#include <qheaderview.h>
+#include <qslider.h>
+#include <cmath>
 #include <qcolor.h>
 #include <qcolordialog.h>
 #include <qtextcodec.h>
 
+/**
+ * Table item sorted by a number kept in its user data instead of its text
+ */
+class NumericItem : public QTableWidgetItem {
+
+public:
+	NumericItem(QString _text, double _key): QTableWidgetItem(_text) { setData(Qt::UserRole, _key); }
+	bool operator<(const QTableWidgetItem &_other) const
+	{
+		return data(Qt::UserRole).toDouble() < _other.data(Qt::UserRole).toDouble();
+	}
+};
+
 /**
 * Panel class constructor
 * @param parent QPointer to the parent QWidget
@@ -46,8 +64,11 @@ Panel::Panel(QPointer<QWidget> parent, int _type):
 	///set panel type (ROC, PR)
 	type = _type;
 
-	///add tabs for curve and plot properties
+	///add tabs for curve and plot properties, the DeLong test compares ROC AUCs only
 	addTab(createCurveTab(this), "Curve Properties");
+	if (type == 0) {
+		addTab(createSignificanceTab(this), "Significance");
+	}
 	addTab(createPlotTab(this), "Plot Properties");
 }
 
@@ -91,6 +112,31 @@ QPointer<QWidget> Panel::createCurveTab(QPointer<QWidget> parent)
 	curvesLayout->addWidget(label3, row++, 0);
 	aucLabel = new QLabel();
 	curvesLayout->addWidget(aucLabel, row++, 0);
+	intervalLabel = new QLabel();
+	curvesLayout->addWidget(intervalLabel, row++, 0);
+	metricsLabel = new QLabel();
+	curvesLayout->addWidget(metricsLabel, row++, 0);
+	bootstrapButton = new QPushButton(tr("Confidence bands"));
+	curvesLayout->addWidget(bootstrapButton, row++, 0);
+	followCheckBox = new QCheckBox("Follow file changes", curvesTab);
+	curvesLayout->addWidget(followCheckBox, row++, 0);
+
+	///create widgets averaging chosen curves, e.g. cross-validation folds
+	curvesLayout->addWidget(new QLabel("Average:", curvesTab), row++, 0);
+	averageModeCombo = new QComboBox(curvesTab);
+	averageModeCombo->addItem(tr("Vertical averaging"));
+	averageModeCombo->addItem(tr("Threshold averaging"));
+	curvesLayout->addWidget(averageModeCombo, row++, 0);
+	averageBandCombo = new QComboBox(curvesTab);
+	averageBandCombo->addItem(tr("Min/max band"));
+	averageBandCombo->addItem(tr("Standard deviation band"));
+	curvesLayout->addWidget(averageBandCombo, row++, 0);
+	averageAddButton = new QPushButton(tr("Add to average"));
+	averageRemoveButton = new QPushButton(tr("Remove from average"));
+	curvesLayout->addWidget(averageAddButton, row++, 0);
+	curvesLayout->addWidget(averageRemoveButton, row++, 0);
+	averageLabel = new QLabel();
+	curvesLayout->addWidget(averageLabel, row++, 0);
 
 	///create delete, hideAll and clear buttons
 	deleteButton = new QPushButton(tr("Delete curve"));
@@ -107,6 +153,12 @@ QPointer<QWidget> Panel::createCurveTab(QPointer<QWidget> parent)
 	connect(curvesCombo,	SIGNAL(currentIndexChanged(const QString&)),	SLOT(edited(const QString&)));
 	connect(nameButton,		SIGNAL(clicked()),				this,			SLOT(changeName()));
 	connect(colorButton,	SIGNAL(clicked()),				this,			SLOT(setColor()));
+	connect(bootstrapButton,	SIGNAL(clicked()),			this,			SLOT(requestBootstrap()));
+	connect(followCheckBox,		SIGNAL(stateChanged(int)),	this,			SLOT(requestFollow(int)));
+	connect(averageModeCombo,	SIGNAL(currentIndexChanged(int)),	this,	SLOT(changeAverageMode()));
+	connect(averageBandCombo,	SIGNAL(currentIndexChanged(int)),	this,	SLOT(changeAverageMode()));
+	connect(averageAddButton,	SIGNAL(clicked()),			this,			SLOT(addToAverage()));
+	connect(averageRemoveButton,	SIGNAL(clicked()),		this,			SLOT(removeFromAverage()));
 	connect(deleteButton,	SIGNAL(clicked()),				this,			SLOT(deleteCurve()));
 	connect(hideAllButton,	SIGNAL(clicked()),				this,			SLOT(hideAll()));
 	connect(clearButton,	SIGNAL(clicked()),				this,			SLOT(clearAll()));
@@ -116,6 +168,36 @@ QPointer<QWidget> Panel::createCurveTab(QPointer<QWidget> parent)
 	return curvesTab;
 }
 
+/**
+ * Create tab comparing AUCs of all curves with the DeLong test.
+ * Row i of the table shows AUC of curve i minus AUC of every other curve,
+ * with p-value of the difference. Clicking a header sorts the curves.
+ * @param parent pointer to parent
+ */
+QPointer<QWidget> Panel::createSignificanceTab(QPointer<QWidget> parent)
+{
+	significanceTab = new QWidget(parent);
+	significanceLayout = new QGridLayout(significanceTab);
+
+	int row = 0;
+
+	///create button starting the comparison and table for its results
+	compareButton = new QPushButton(tr("Compare curves"));
+	significanceLayout->addWidget(compareButton, row++, 0);
+	significanceLayout->addWidget(new QLabel("ROC AUC differences (row - column), DeLong p-values:", significanceTab), row++, 0);
+	significanceTable = new QTableWidget(significanceTab);
+	significanceTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+	significanceTable->verticalHeader()->hide();
+	significanceLayout->addWidget(significanceTable, row++, 0);
+
+	significanceLayout->setRowStretch(row - 1, 20);
+
+	///connect signals to the slots
+	connect(compareButton,	SIGNAL(clicked()),	this,	SIGNAL(significanceRequested()));
+
+	return significanceTab;
+}
+
 /**
  * Create first of the tabs with options of current curve
  * It creates widgets, sets tab layout and connect Panel classes signals to the slots
@@ -162,6 +244,41 @@ QPointer<QWidget> Panel::createPlotTab(QPointer<QWidget> parent)
 	gridCheckBox->setChecked(true);
 	plotLayout->addWidget(gridCheckBox, row++, 0);
 
+	///ROC panel draws convex hulls and iso-performance lines of a chosen slope
+	if (type == 0) {
+		hullCheckBox = new QCheckBox("Convex hulls", plotTab);
+		plotLayout->addWidget(hullCheckBox, row++, 0);
+		isoCheckBox = new QCheckBox("Iso-performance line", plotTab);
+		plotLayout->addWidget(isoCheckBox, row++, 0);
+		slopeLabel = new QLabel(plotTab);
+		plotLayout->addWidget(slopeLabel, row++, 0);
+		slopeSlider = new QSlider(Qt::Horizontal, plotTab);
+		slopeSlider->setRange(0, SLOPE_STEPS);
+		slopeSlider->setValue(SLOPE_STEPS / 2);
+		plotLayout->addWidget(slopeSlider, row++, 0);
+		slopeLabel->setText(QString("Slope: %1").arg(slope()));
+
+		connect(hullCheckBox,	SIGNAL(stateChanged(int)),	this,	SLOT(changeHulls()));
+		connect(isoCheckBox,	SIGNAL(stateChanged(int)),	this,	SLOT(changeHulls()));
+		connect(slopeSlider,	SIGNAL(valueChanged(int)),	this,	SLOT(changeHulls()));
+	}
+
+	///PR panel derives PR curves from ROC curves for a chosen prevalence
+	if (type == 1) {
+		deriveCheckBox = new QCheckBox("Derive from ROC curves", plotTab);
+		plotLayout->addWidget(deriveCheckBox, row++, 0);
+		prevalenceLabel = new QLabel(plotTab);
+		plotLayout->addWidget(prevalenceLabel, row++, 0);
+		prevalenceSlider = new QSlider(Qt::Horizontal, plotTab);
+		prevalenceSlider->setRange(0, PREVALENCE_STEPS);
+		prevalenceSlider->setValue(PREVALENCE_STEPS * 3 / 4);
+		plotLayout->addWidget(prevalenceSlider, row++, 0);
+		prevalenceLabel->setText(QString("Prevalence: %1").arg(prevalence()));
+
+		connect(deriveCheckBox,		SIGNAL(stateChanged(int)),	this,	SLOT(changePrevalence()));
+		connect(prevalenceSlider,	SIGNAL(valueChanged(int)),	this,	SLOT(changePrevalence()));
+	}
+
 	plotLayout->setColumnStretch(1, 10);
     plotLayout->setRowStretch(row, 20);
 
@@ -174,62 +291,296 @@ QPointer<QWidget> Panel::createPlotTab(QPointer<QWidget> parent)
 	return plotTab;
 }
 
+/**
+ * Panel class currentCurve method is used to get the curve chosen in combo box.
+ * Combo box items keep identifiers of curves, which do not change when other curves are deleted.
+ * @return identifier of the chosen curve, -1 if there is no curve
+ */
+int Panel::currentCurve()
+{
+	int index = curvesCombo->currentIndex();
+	if(index < 0) {
+		return -1;
+	}
+	return curvesCombo->itemData(index).toInt();
+}
+
+/**
+ * Panel class formatAuc method builds the text of AUC label.
+ * AUC of a curve built from a score sketch is followed by its error bound.
+ * @param _auc area under the curve
+ * @param _aucError largest error of the AUC, 0 if it is exact
+ * @return text of the label
+ */
+QString Panel::formatAuc(double _auc, double _aucError)
+{
+	if (_aucError > 0.0) {
+		return QString("%1 (max error %2)").arg(_auc).arg(_aucError);
+	}
+	return QString("%1").arg(_auc);
+}
+
+/**
+ * Panel class formatOperatingPoints method builds the text of operating points label.
+ * Values which cannot be read from the curve are left out.
+ * @param _points operating points of a curve
+ * @return text of the label, one value in a line
+ */
+QString Panel::formatOperatingPoints(const OperatingPoints &_points)
+{
+	const char *names[] = { "EER", "Max F1", "Youden J", "TPR at FPR 1e-3", "TPR at FPR 1e-4", "Break-even" };
+	double values[] = { _points.eer, _points.maxF1, _points.youden, _points.tprAt1e3, _points.tprAt1e4, _points.breakEven };
+	QStringList lines;
+	for (int i = 0; i < 6; i++) {
+		if (OperatingPoints::isAvailable(values[i])) {
+			lines << QString("%1: %2").arg(names[i]).arg(values[i]);
+		}
+	}
+	return lines.join("\n");
+}
+
+/**
+ * Panel class showCurve method fills the curve tab with color, AUC and operating points
+ * of a curve, kept since the curve was added
+ * @param _id curve identifier
+ */
+void Panel::showCurve(int _id)
+{
+	QHash<int, CurveInfo>::const_iterator info = curveInfo.constFind(_id);
+	if (info == curveInfo.constEnd()) {
+		return;
+	}
+
+	///fill color label with a color of the curve
+	colorLabel->setPalette(QPalette(info->color));
+	colorLabel->setAutoFillBackground(true);
+
+	///fill AUC labels with an area under the curve, its interval and operating points
+	aucLabel->setText(formatAuc(info->auc, info->aucError));
+	intervalLabel->setText(intervals.value(_id));
+	metricsLabel->setText(formatOperatingPoints(info->operating));
+
+	///show if the file of the curve is followed, without asking for it again
+	followCheckBox->blockSignals(true);
+	followCheckBox->setChecked(followed.contains(_id));
+	followCheckBox->blockSignals(false);
+
+	curvesTab->repaint();
+}
+
 /**
  * Panel class addCurve slot is called while adding curve to a plot.
  * The curve is also added to a curve panel.
+ * @param _id curve identifier
  * @param _name curve name to be displayed in the legend
  * @param _color curve color
  * @param _auc area under the curve
+ * @param _aucError largest error of the AUC, 0 if it is exact
+ * @param _operating operating points of the curve
  */
-void Panel::addCurve(QString _name, QColor _color, double _auc)
+void Panel::addCurve(int _id, QString _name, QColor _color, double _auc, double _aucError, OperatingPoints _operating)
 {
+	///keep values of the curve, they are displayed whenever it is chosen
+	CurveInfo info;
+	info.color = _color;
+	info.auc = _auc;
+	info.aucError = _aucError;
+	info.operating = _operating;
+	curveInfo.insert(_id, info);
+
 	///add item to the combo box
-	curvesCombo->addItem(_name);
+	curvesCombo->addItem(_name, _id);
 	curvesCombo->setCurrentIndex(curvesCombo->count() - 1);
 	lineEdit->setText(_name);
-	
-	///fill color label with a color of the curve which was added
-	colorLabel->setPalette(QPalette(_color));
-	colorLabel->setAutoFillBackground(true);
-
-	///fill AUC label with a value of an area under the curve which was added
-	QString auc = QString("%1").arg(_auc);
-	aucLabel->clear();
-	aucLabel->setText(auc);
-
-	curvesTab->repaint();
+	showCurve(_id);
 }
 
 /**
  * Panel class edited slot is called while switching value of combo box.
- * It emits getColorAuc signal due to get an information about color and AUC from Plot
+ * It displays color, AUC and operating points of the chosen curve.
  * @param which An index of the chosen option in combo box
  */
 void Panel::edited(const QString& which)
 {
 	lineEdit->setText(which);
-	int index = curvesCombo->currentIndex();
-	emit getColorAuc(index);
+	int id = currentCurve();
+	if(id < 0) {
+		return;
+	}
+	showCurve(id);
 }
 
 /**
- * Panel class readColorAuc slot is called while information about color and AUC
- * of the specified curve are available
- * @param _color A color of the curve
- * @param _auc An area under the curve
+ * Panel class showAucInterval slot is called whenever bootstrap of a curve
+ * finishes another round of replicates. The interval is kept for the curve
+ * and displayed under its AUC.
+ * @param _id curve identifier
+ * @param _low lower end of the 95% confidence interval of AUC
+ * @param _high upper end of the interval
+ * @param _replicates number of replicates the interval was computed from
  */
-void Panel::readColorAuc(QColor _color, double _auc)
+void Panel::showAucInterval(int _id, double _low, double _high, int _replicates)
 {
-	///fill color label with a color of the curve
-	colorLabel->setPalette(QPalette(_color));
-	colorLabel->setAutoFillBackground(true);
+	intervals.insert(_id, QString("95% CI [%1, %2] (%3 replicates)").arg(_low).arg(_high).arg(_replicates));
+	if (_id == currentCurve()) {
+		intervalLabel->setText(intervals.value(_id));
+	}
+}
 
-	///fill AUC label with a value of an area under the curve
-	QString auc = QString("%1").arg(_auc);
-	aucLabel->clear();
-	aucLabel->setText(auc);
+/**
+ * Panel class requestFollow slot is called when follow file changes box was switched.
+ * It emits followRequested signal with the identifier of the current curve.
+ * @param _state state of the check box
+ */
+void Panel::requestFollow(int _state)
+{
+	int id = currentCurve();
+	if (id >= 0) {
+		emit followRequested(id, _state == Qt::Checked);
+	}
+}
 
-	curvesTab->repaint();
+/**
+ * Panel class showFollowed slot is called when following of a file started or stopped,
+ * also when a plot could not follow it
+ * @param _id curve identifier
+ * @param _followed true if the file of the curve is followed
+ */
+void Panel::showFollowed(int _id, bool _followed)
+{
+	if (_followed) {
+		followed.insert(_id);
+	}
+	else {
+		followed.remove(_id);
+	}
+	if (_id == currentCurve()) {
+		showCurve(_id);
+	}
+}
+
+/**
+ * Panel class updateCurve slot is called when a followed curve grew
+ * @param _id curve identifier
+ * @param _auc area under the curve
+ * @param _operating operating points of the curve
+ */
+void Panel::updateCurve(int _id, double _auc, OperatingPoints _operating)
+{
+	QHash<int, CurveInfo>::iterator info = curveInfo.find(_id);
+	if (info == curveInfo.end()) {
+		return;
+	}
+	info->auc = _auc;
+	info->operating = _operating;
+	if (_id == currentCurve()) {
+		showCurve(_id);
+	}
+}
+
+/**
+ * Panel class requestBootstrap slot is called when confidence bands button was clicked.
+ * It emits bootstrapRequested signal with the identifier of the current curve.
+ */
+void Panel::requestBootstrap()
+{
+	int id = currentCurve();
+	if (id >= 0) {
+		emit bootstrapRequested(id);
+	}
+}
+
+/**
+ * Panel class addToAverage slot is called when add to average button was clicked.
+ * It emits averageAdd signal with the identifier of the current curve.
+ */
+void Panel::addToAverage()
+{
+	int id = currentCurve();
+	if (id >= 0) {
+		emit averageAdd(id);
+	}
+}
+
+/**
+ * Panel class removeFromAverage slot is called when remove from average button was clicked.
+ * It emits averageRemove signal with the identifier of the current curve.
+ */
+void Panel::removeFromAverage()
+{
+	int id = currentCurve();
+	if (id >= 0) {
+		emit averageRemove(id);
+	}
+}
+
+/**
+ * Panel class changeAverageMode slot is called when averaging or band was chosen.
+ * It emits averageModeChange signal with indices of both, see CurveAverage.
+ */
+void Panel::changeAverageMode()
+{
+	emit averageModeChange(averageModeCombo->currentIndex(), averageBandCombo->currentIndex());
+}
+
+/**
+ * Panel class showAverage slot is called whenever the average curve changes
+ * @param _folds number of averaged curves, 0 if there is no average
+ * @param _auc area under the average curve
+ */
+void Panel::showAverage(int _folds, double _auc)
+{
+	if (_folds == 0) {
+		averageLabel->clear();
+		return;
+	}
+	averageLabel->setText(QString("%1 folds, AUC %2").arg(_folds).arg(_auc));
+}
+
+/**
+ * Panel class showSignificance slot fills the significance table with the results
+ * of the DeLong test. Differences significant at the 0.05 level are shown in bold.
+ * @param _names names of the compared curves
+ * @param _result AUCs and their covariances, in the order of names
+ */
+void Panel::showSignificance(QStringList _names, QSharedPointer<DeLong> _result)
+{
+	if (!significanceTable) {
+		return;
+	}
+	int count = _result->size();
+	significanceTable->setSortingEnabled(false);
+	significanceTable->clear();
+	significanceTable->setRowCount(count);
+	significanceTable->setColumnCount(count + 2);
+
+	QStringList headers;
+	headers << "Curve" << "AUC";
+	significanceTable->setHorizontalHeaderLabels(headers + _names);
+
+	for (int i = 0; i < count; i++) {
+		significanceTable->setItem(i, 0, new QTableWidgetItem(_names[i]));
+		significanceTable->setItem(i, 1, new NumericItem(QString::number(_result->getAUC(i)), _result->getAUC(i)));
+		for (int j = 0; j < count; j++) {
+			double difference = _result->getAUC(i) - _result->getAUC(j);
+			if (i == j) {
+				significanceTable->setItem(i, j + 2, new NumericItem("-", 0.0));
+				continue;
+			}
+			double p = _result->pValue(i, j);
+			NumericItem *item = new NumericItem(QString("%1 (p=%2)").arg(difference, 0, 'f', 4).arg(p, 0, 'g', 3), difference);
+			item->setToolTip(QString("z = %1, p = %2").arg(_result->zScore(i, j)).arg(p));
+			if (p < 0.05) {
+				QFont font = item->font();
+				font.setBold(true);
+				item->setFont(font);
+			}
+			significanceTable->setItem(i, j + 2, item);
+		}
+	}
+	significanceTable->setSortingEnabled(true);
+	significanceTable->resizeColumnsToContents();
+	setCurrentWidget(significanceTab);
 }
 
 /**
@@ -248,7 +599,7 @@ void Panel::changeName()
 	QString name = lineEdit->text();
 	curvesCombo->setItemText(index, name);
 	nameButton->setChecked(false);
-	emit nameChange(index, name);
+	emit nameChange(currentCurve(), name);
 }
 
 /**
@@ -285,6 +636,52 @@ void Panel::changeGrid(int _state)
 	emit gridChange(_state);
 }
 
+/**
+ * Panel class prevalence method maps the position of the prevalence slider
+ * to a prevalence on a logarithmic scale from 1e-4 to 1
+ * @return prevalence of positive examples chosen with the slider
+ */
+double Panel::prevalence() const
+{
+	double position = double(prevalenceSlider->value()) / PREVALENCE_STEPS;
+	return qMin(std::pow(10.0, 4.0 * (position - 1.0)), 0.999);
+}
+
+/**
+ * Panel class changePrevalence slot is called while the prevalence slider is moved
+ * or PR curve derivation is switched. It emits prevalenceChanged signal with the
+ * chosen prevalence, or 0 if PR curves are not derived.
+ */
+void Panel::changePrevalence()
+{
+	prevalenceLabel->setText(QString("Prevalence: %1").arg(prevalence()));
+	emit prevalenceChanged(deriveCheckBox->isChecked() ? prevalence() : 0.0);
+}
+
+/**
+ * Panel class slope method maps the position of the slope slider to a slope
+ * of iso-performance lines on a logarithmic scale from 1e-2 to 1e2.
+ * The slope is the cost of a false positive times the number of negative examples
+ * over the cost of a false negative times the number of positive examples.
+ * @return slope chosen with the slider
+ */
+double Panel::slope() const
+{
+	double position = double(slopeSlider->value()) / SLOPE_STEPS;
+	return std::pow(10.0, 4.0 * position - 2.0);
+}
+
+/**
+ * Panel class changeHulls slot is called while convex hulls or the iso-performance
+ * line are switched or the slope slider is moved. It emits hullsChanged signal
+ * with the state of hulls and the chosen slope, or 0 if no line is drawn.
+ */
+void Panel::changeHulls()
+{
+	slopeLabel->setText(QString("Slope: %1").arg(slope()));
+	emit hullsChanged(hullCheckBox->isChecked(), isoCheckBox->isChecked() ? slope() : 0.0);
+}
+
 /**
 * Panel class setColor slot is called while color button was checked. It opens a color dialog.
 * While clicking a button in this dialog, colorChange signal is emited.
@@ -305,11 +702,13 @@ void Panel::setColor()
     if (color.isValid()) {
         colorLabel->setPalette(QPalette(color));
         colorLabel->setAutoFillBackground(true);
+		if (curveInfo.contains(currentCurve())) {
+			curveInfo[currentCurve()].color = color;
+		}
     }
 
-	int index = curvesCombo->currentIndex();
 	colorButton->setChecked(false);
-	emit colorChange(index, color);
+	emit colorChange(currentCurve(), color);
  }
 
 /**
@@ -336,8 +735,7 @@ void Panel::setBcgColor()
 /**
 * Panel class deleteCurve slot is called while delete curve button was checked.
 * It emits curveDelete signal, which is used to delete curve from plot and legend.
-* It emits getColotAuc signal, which is used to get color and AUC of a curve,
-* which will be displayed in a panel
+* Color, AUC and operating points of the next curve are displayed in a panel
 */
 void Panel::deleteCurve()
 {
@@ -347,16 +745,21 @@ void Panel::deleteCurve()
 	}
 
 	///emit a signal for Plot
-	int index = curvesCombo->currentIndex();
-	curvesCombo->removeItem(index);
+	int id = currentCurve();
+	curvesCombo->removeItem(curvesCombo->currentIndex());
 	deleteButton->setChecked(false);
-	emit curveDelete(index);
+	intervals.remove(id);
+	curveInfo.remove(id);
+	followed.remove(id);
+	emit curveDelete(id);
 
 	///clear panel if it was an only curve
 	if(curvesCombo->count() == 0) {
 		lineEdit->clear();
 		colorLabel->setPalette(QPalette(Qt::white));
 		aucLabel->clear();
+		intervalLabel->clear();
+		metricsLabel->clear();
 		return;
 	}
 	
@@ -364,7 +767,7 @@ void Panel::deleteCurve()
 	curvesCombo->setCurrentIndex(0);
 	QString which = curvesCombo->currentText();
 	lineEdit->setText(which);
-	emit getColorAuc(index);
+	showCurve(currentCurve());
 }
 
 /**
@@ -374,9 +777,8 @@ void Panel::deleteCurve()
 */
 void Panel::hideAll()
 {
-	int index = curvesCombo->currentIndex();
 	hideAllButton->setChecked(false);
-	emit hideAllExceptOfThis(index);
+	emit hideAllExceptOfThis(currentCurve());
 }
 
 /**
@@ -390,5 +792,16 @@ void Panel::clearAll()
 	lineEdit->clear();
 	colorLabel->setPalette(QPalette(Qt::white));
 	aucLabel->clear();
+	intervalLabel->clear();
+	metricsLabel->clear();
+	averageLabel->clear();
+	intervals.clear();
+	curveInfo.clear();
+	followed.clear();
+	if (significanceTable) {
+		significanceTable->clear();
+		significanceTable->setRowCount(0);
+		significanceTable->setColumnCount(0);
+	}
 	emit clearPlot();
 }
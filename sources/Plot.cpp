@@ -25,8 +25,17 @@
 #include "../headers/Plot.h"
 #include "../headers/FunctionData.h"
 #include "../headers/Curve.h"
+#include "../headers/CurveLoader.h"
+#include "../headers/CurveCache.h"
+#include "../headers/Bootstrap.h"
+#include "../headers/AverageUpdater.h"
+#include "../headers/DeLong.h"
+#include "../headers/Metrics.h"
+#include "../headers/RocHull.h"
+#include "../headers/CurveTail.h"
 
 #include <iostream>
+#include <qthreadpool.h>
 #include <qstring.h>
 #include <qtextcodec.h>
 #include <qwt_plot_panner.h>
@@ -34,6 +43,7 @@
 #include <qwt_plot_canvas.h>
 #include <qwt_plot_magnifier.h>
 #include <qwt_plot_curve.h>
+#include <qwt_plot_intervalcurve.h>
 #include <qwt_plot_marker.h>
 #include <qwt_plot_zoomer.h>
 #include <qwt_plot_grid.h>
@@ -41,10 +51,26 @@
 #include <qwt_legend_item.h>
 #include <qevent.h>
 #include <qmessagebox.h>
+#include <qapplication.h>
 #include <qerrormessage.h>
+#include <qfilesystemwatcher.h>
+#include <qtimer.h>
+#include <qfile.h>
+#include <qwt_plot_directpainter.h>
+#include <qpainter.h>
+#include <qmath.h>
 
 using namespace std;
 
+/**
+* Colors given to curves in turn, as they are added to a plot
+*/
+const Qt::GlobalColor Plot::QtColors[] = {
+	Qt::black, Qt::red, Qt::darkRed, Qt::green, Qt::darkGreen, Qt::blue, Qt::darkBlue, Qt::cyan,
+	Qt::darkCyan, Qt::magenta, Qt::darkMagenta, Qt::yellow, Qt::darkYellow, Qt::gray, Qt::darkGray, Qt::lightGray
+};
+const int Plot::QtColorsCount = sizeof(Plot::QtColors) / sizeof(Plot::QtColors[0]);
+
 /**
 * Grid class inherits from QwtPlotGrid and specify grid properties for a plot.
 */
@@ -108,8 +134,23 @@ public:
 * @param _type Plot type 
 */
 Plot::Plot(QPointer<QWidget> parent, int _type):
-    QwtPlot( parent ), type(_type)
+    QwtPlot( parent ), type(_type), prevalence_(0.0), average_(_type),
+	averageUpdater_(NULL), averageDirty_(false), averageCurve_(NULL), averageBand_(NULL),
+	hullsShown_(false), isoSlope_(0.0), unionHull_(NULL), isoLine_(NULL),
+	updateDepth_(0), replotRequested_(false), replotCount_(0), requestCount_(0),
+	activeItem_(NULL)
 {
+	///Replots requested in a burst of changes are done once, when the event loop gets back
+	replotTimer_ = new QTimer(this);
+	replotTimer_->setSingleShot(true);
+	replotTimer_->setInterval(FRAME_INTERVAL);
+	connect(replotTimer_, SIGNAL(timeout()), this, SLOT(flushReplot()));
+
+	///Items are drawn in cached layers, see drawItems
+	layers_.resize(LAYER_COUNT);
+	layerItems_.resize(LAYER_COUNT);
+	layerValid_.fill(false, LAYER_COUNT);
+
 	QTextCodec::setCodecForCStrings(QTextCodec::codecForName("Windows-1250"));
 	setObjectName("Porwnanie krzywych");
 
@@ -128,22 +169,19 @@ Plot::Plot(QPointer<QWidget> parent, int _type):
 		QMessageBox::about(this, tr("Nieznany typ wykresu"), w);
 	}
 
-	///Initialize table containing color values
-	const int qtc[] = { 3, 2, 7, 13, 8, 14, 9, 15, 10, 16, 11, 17, 12, 18, 5, 4, 6, 19, 0, 1 };
+	///Start from the first color of QtColors table
 	itColor = 0;
-	QtColors = qtc;
 
-	///Set background properties
-    setAutoFillBackground(true);
-    setPalette(QPalette(QColor(185, 213, 248)));
+	///Set background, axis ranges and canvas
+	applyStyle(this);
 
 	///Insert legend
 	legend = QPointer<QwtLegend> (new QwtLegend);
     legend->setItemMode(QwtLegend::CheckableItem);
     insertLegend(legend, QwtPlot::RightLegend);
 
-	///Auto replot after legend modification
-    connect(this, SIGNAL(legendChecked(QPointer<QwtPlotItem>, bool)), SLOT(showItem(QPointer<QwtPlotItem>, bool)));
+	///Legend check boxes show and hide their items
+    connect(this, SIGNAL(legendChecked(QwtPlotItem*, bool)), SLOT(showItem(QwtPlotItem*, bool)));
     setAutoReplot(true);
 
     ///Set axis name 
@@ -165,12 +203,8 @@ Plot::Plot(QPointer<QWidget> parent, int _type):
 		QMessageBox::about(this, tr("Nieznany typ wykresu"), w);
 	}
 
-	///Set axis ranges
-	setAxisScale(xBottom, 0.0, 1.0);
-    setAxisScale(yLeft, 0.0, 1.0);
-
 	///Set grid
-	grid = new Grid;
+	grid = createGrid();
     grid->attach(this);
 
 	///Set zoomer properties
@@ -188,130 +222,1332 @@ Plot::Plot(QPointer<QWidget> parent, int _type):
 	QPointer<QwtPlotPanner> panner = new QwtPlotPanner(canvas());
     panner->setMouseButton(Qt::MidButton);
 
-	///Set plot canvas
-    canvas()->setLineWidth(1);
-    canvas()->setFrameStyle(QFrame::Box | QFrame::Plain);
-    canvas()->setBorderRadius(15);
-
-	///Set canvas color
-    QPalette canvasPalette(Qt::white);
-    canvasPalette.setColor(QPalette::Foreground, QColor(133, 190, 232));
-    canvas()->setPalette(canvasPalette);
+	///The rubber band and the tracker of the zoomer are painted over the cached canvas
+    canvas()->setPaintAttribute(QwtPlotCanvas::PaintCached, true);
 
 	///Install event filter
 	QWidget::setMouseTracking(true);
 	installEventFilter(this);
 	
-	///Initialize curve counter
+	///Initialize curve, batch and name counters
 	curve_counter = 0;
+	batch_counter = 0;
+	name_counter = 0;
+
+	///Changes of followed files are collected and applied at most once per TAIL_INTERVAL
+	watcher_ = new QFileSystemWatcher(this);
+	connect(watcher_, SIGNAL(fileChanged(QString)), this, SLOT(tailChanged(QString)));
+	tailTimer_ = new QTimer(this);
+	tailTimer_->setSingleShot(true);
+	tailTimer_->setInterval(TAIL_INTERVAL);
+	connect(tailTimer_, SIGNAL(timeout()), this, SLOT(updateTails()));
+	directPainter_ = new QwtPlotDirectPainter(this);
+
+	///Loadings, bootstraps and updates of the average run in its own pool, so that closing the plot waits only for them
+	pool_ = new QThreadPool(this);
+}
+
+/**
+* Plot class destructor cancels loadings and bootstraps which are still in progress
+* and waits for them and for an update of the average, as they report back to this object.
+* Work of other plots is not waited for.
+*/
+Plot::~Plot()
+{
+	QHash<QString, CurveLoader*>::const_iterator it;
+	for(it = loaders_.constBegin(); it != loaders_.constEnd(); ++it) {
+		it.value()->cancel();
+	}
+	QHash<int, Bootstrap*>::const_iterator bootstrap;
+	for(bootstrap = bootstraps_.constBegin(); bootstrap != bootstraps_.constEnd(); ++bootstrap) {
+		bootstrap.value()->cancel();
+	}
+	pool_->waitForDone();
+	qDeleteAll(loaders_);
+	qDeleteAll(bootstraps_);
+	delete averageUpdater_;
+	qDeleteAll(tails_);
+}
+
+/**
+* Plot class beginUpdate method starts a transaction of changes. Replots requested
+* by the changes, explicitly or by auto replot, are postponed until the outermost
+* transaction ends. Transactions may be nested.
+*/
+void Plot::beginUpdate()
+{
+	updateDepth_++;
+}
+
+/**
+* Plot class endUpdate method ends a transaction of changes. If any replot was requested
+* during the outermost transaction, one replot is scheduled.
+*/
+void Plot::endUpdate()
+{
+	if (--updateDepth_ == 0 && replotRequested_) {
+		replotTimer_->start();
+	}
+}
+
+/**
+* Plot class replotCount method tells how many times the plot was really redrawn,
+* to compare with requestCount
+* @return number of replots done
+*/
+int Plot::replotCount() const
+{
+	return replotCount_;
+}
+
+/**
+* Plot class requestCount method tells how many replots were requested, explicitly
+* or by auto replot, including those merged into one redraw
+* @return number of replots requested
+*/
+int Plot::requestCount() const
+{
+	return requestCount_;
+}
+
+/**
+* Plot class replot slot requests a replot, which is done after FRAME_INTERVAL, so that
+* any burst of requests, e.g. auto replot of every changed item, gives one replot per frame.
+* Replots requested inside a transaction wait until it ends.
+* Only the cached layers invalidated by invalidateItem or forgetItem, or the layers whose
+* visible items changed, are drawn again; items changed in place have to be invalidated.
+*/
+void Plot::replot()
+{
+	requestReplot();
+}
+
+/**
+* Plot class requestReplot method requests a replot, see replot
+*/
+void Plot::requestReplot()
+{
+	requestCount_++;
+	replotRequested_ = true;
+	if (updateDepth_ == 0 && !replotTimer_->isActive()) {
+		replotTimer_->start();
+	}
+}
+
+/**
+* Plot class flushReplot slot redraws the plot once for all requests collected so far
+*/
+void Plot::flushReplot()
+{
+	if (updateDepth_ > 0 || !replotRequested_) {
+		return;
+	}
+	replotRequested_ = false;
+	replotCount_++;
+	QwtPlot::replot();
+}
+
+/**
+* Plot class assignLayers method tells in which cached layer every item is drawn. Items below
+* curves (grid, confidence bands) and above them (markers) have a layer each. Curves are split
+* into at most CURVE_LAYERS contiguous runs of itemList, which is sorted by z, so layers keep
+* the order in which curves are stacked. A curve keeps its layer until it is forgotten, so attaching
+* or detaching curves does not move the others; a new curve joins the layer of the curve below it
+* until that layer holds its share of all curves, then it opens the next layer.
+* The topmost curve is drawn alone in ACTIVE_LAYER once it was changed.
+* Hidden curves keep their layers, so showing or hiding a curve does not move the others.
+* @return layer of every item of itemList
+*/
+QVector<int> Plot::assignLayers() const
+{
+	const QwtPlotItemList &list = itemList();
+	QVector<int> layers(list.size());
+	int last = -1;
+	int count = 0;
+	for (int i = 0; i < list.size(); i++) {
+		if (list[i]->z() < CURVE_Z) {
+			layers[i] = BELOW_LAYER;
+		}
+		else if (list[i]->z() > CURVE_Z) {
+			layers[i] = ABOVE_LAYER;
+		}
+		else {
+			last = i;
+			count++;
+		}
+	}
+	if (count > 0 && list[last] == activeItem_) {
+		layers[last] = ACTIVE_LAYER;
+		count--;
+	}
+
+	int share = qMax(1, (count + CURVE_LAYERS - 1) / CURVE_LAYERS);
+	int layer = FIRST_CURVE_LAYER;
+	int filled = 0;
+	for (int i = 0; i < list.size() && count > 0; i++) {
+		if (list[i]->z() != CURVE_Z || layers[i] == ACTIVE_LAYER) {
+			continue;
+		}
+		count--;
+		///a kept layer below the curve under it, e.g. of a curve attached again, would break the stacking
+		QHash<const QwtPlotItem*, int>::const_iterator kept = curveLayers_.constFind(list[i]);
+		if (kept != curveLayers_.constEnd() && kept.value() >= layer) {
+			filled = kept.value() == layer ? filled + 1 : 1;
+			layer = kept.value();
+		}
+		else {
+			if (filled >= share && layer < FIRST_CURVE_LAYER + CURVE_LAYERS - 1) {
+				layer++;
+				filled = 0;
+			}
+			filled++;
+			curveLayers_.insert(list[i], layer);
+		}
+		layers[i] = layer;
+	}
+	return layers;
+}
+
+/**
+* Plot class invalidateItem method is called when an item was changed in place, e.g. recolored.
+* The layer of the item is drawn again by the next replot. The topmost curve is moved
+* to ACTIVE_LAYER, so that its later changes redraw it alone; its former layer is drawn
+* once more without it. Other curves stay in their layer, as moving them would bring them to the front.
+* @param _item changed plot item
+*/
+void Plot::invalidateItem(const QwtPlotItem *_item)
+{
+	const QwtPlotItemList &list = itemList();
+	int index = list.indexOf(const_cast<QwtPlotItem*>(_item));
+	if (index < 0) {
+		return;
+	}
+	layerValid_[assignLayers()[index]] = false;
+	bool topmost = _item->z() == CURVE_Z && (index + 1 == list.size() || list[index + 1]->z() > CURVE_Z);
+	if (topmost) {
+		activeItem_ = _item;
+		layerValid_[ACTIVE_LAYER] = false;
+	}
+}
+
+/**
+* Plot class forgetItem method is called before an item is detached for good or deleted.
+* Layers which were drawn with the item are drawn again, so that an item allocated
+* later at the same address is not taken for it.
+* @param _item removed plot item
+*/
+void Plot::forgetItem(const QwtPlotItem *_item)
+{
+	for (int layer = 0; layer < LAYER_COUNT; layer++) {
+		if (layerItems_[layer].removeAll(_item) > 0) {
+			layerValid_[layer] = false;
+		}
+	}
+	curveLayers_.remove(_item);
+	if (activeItem_ == _item) {
+		activeItem_ = NULL;
+	}
+}
+
+/**
+* Plot class drawItems method draws items of the canvas from cached layers. Every layer is
+* a pixmap of its items, which is drawn again only if it was invalidated or its visible
+* items changed; the others are only copied. Only resizing, zooming and panning, which change
+* the geometry or the scales, invalidate all layers. Pixmaps are kept only for layers holding
+* visible items. Only painting of the canvas, directly or into its paint cache, is cached;
+* rendering to files, printers and other pixmaps draws the items directly.
+* @param painter Painter of the canvas
+* @param canvasRect Contents rectangle of the canvas
+* @param maps Scale maps of the axes
+*/
+void Plot::drawItems(QPainter *painter, const QRectF &canvasRect, const QwtScaleMap maps[axisCnt]) const
+{
+	const QPaintDevice *device = painter->device();
+	if (device != canvas() && device != canvas()->paintCache()) {
+		QwtPlot::drawItems(painter, canvasRect, maps);
+		return;
+	}
+
+	QVector<double> key;
+	key << canvasRect.x() << canvasRect.y() << canvasRect.width() << canvasRect.height();
+	for (int axis = 0; axis < axisCnt; axis++) {
+		key << maps[axis].s1() << maps[axis].s2() << maps[axis].p1() << maps[axis].p2();
+	}
+	if (key != layerKey_) {
+		layerKey_ = key;
+		layerValid_.fill(false);
+	}
+
+	///visible items of every layer, in the order of their z values
+	QVector<QList<const QwtPlotItem*> > items(LAYER_COUNT);
+	const QwtPlotItemList &list = itemList();
+	QVector<int> layerOfItem = assignLayers();
+	for (int i = 0; i < list.size(); i++) {
+		if (list[i]->isVisible()) {
+			items[layerOfItem[i]].append(list[i]);
+		}
+	}
+
+	QSize size(qCeil(canvasRect.width()), qCeil(canvasRect.height()));
+	for (int layer = 0; layer < LAYER_COUNT; layer++) {
+		if (items[layer].isEmpty()) {
+			layers_[layer] = QPixmap();
+			layerItems_[layer].clear();
+			layerValid_[layer] = true;
+			continue;
+		}
+
+		///items shown, hidden, attached or detached change the items of a layer
+		if (!layerValid_[layer] || items[layer] != layerItems_[layer] || layers_[layer].size() != size) {
+			QPixmap &pixmap = layers_[layer];
+			if (pixmap.size() != size) {
+				pixmap = QPixmap(size);
+			}
+			pixmap.fill(Qt::transparent);
+			QPainter layerPainter(&pixmap);
+			layerPainter.translate(-canvasRect.topLeft());
+			for (int i = 0; i < items[layer].size(); i++) {
+				const QwtPlotItem *item = items[layer][i];
+				layerPainter.save();
+				layerPainter.setRenderHint(QPainter::Antialiasing, item->testRenderHint(QwtPlotItem::RenderAntialiased));
+				item->draw(&layerPainter, maps[item->xAxis()], maps[item->yAxis()], canvasRect);
+				layerPainter.restore();
+			}
+			layerItems_[layer] = items[layer];
+			layerValid_[layer] = true;
+		}
+		painter->drawPixmap(canvasRect.topLeft(), layers_[layer]);
+	}
 }
 
 /**
-* Plot class addCurve method is called while adding a curve to the plot
-* It emits curveAdded signal with color, AUC and color as parameters, while curve is added
+* Plot class addCurve method is called while adding a single curve to the plot.
 * @param fileName n of a file containing curve points
 * @param _type type of a curve (ROC, PR)
-* @param _auc area under the curve
 */
 int Plot::addCurve(QString fileName, int _type)
 {		
-	double _auc = 0.0;
-
-	QSharedPointer<ProxyFile> _proxy;
-	QColor color;
-	QString name;
-	QSharedPointer<Curve> curve;
+	addCurves(QStringList(fileName));
+	return 0;
+}
 
-	///check if requested curve already exists
-	bool exists=false;
+/**
+* Plot class addCurves method is called while adding curves to the plot.
+* Files are loaded concurrently in worker threads and their curves are attached together,
+* when the last of them is ready. Deleted curves stay registered and are reattached with their
+* name and color, their data is loaded again.
+* Data of files which were opened before, here or in another plot, is taken from the curve cache.
+* It emits loadStarted signal for every file which begins loading.
+* @param fileNames names of files containing curve points
+* @return number of files which started loading
+*/
+int Plot::addCurves(QStringList fileNames)
+{
+	QList<CurveLoader*> started;
+	int batch = ++batch_counter;
 
-	for (int i=0; i<proxies_.size(); i++)
+	for (int f = 0; f < fileNames.size(); f++)
 	{
-		if ((proxies_[i])->real_file_path==fileName) {
-			//qDebug()<<"already exists";
-			curve=(curves_[i]);
-			
-			///check if requested curve is already attached to a plot
-			if (curve->isAttached()) {
-				return 0;
+		const QString &fileName = fileNames[f];
+
+		///check if requested curve already exists
+		QSharedPointer<Curve> known = registry_.findPath(fileName);
+		bool exists = known && known->isAttached();
+
+		///check if requested curve is already being loaded
+		if (exists || loaders_.contains(fileName)) {
+			continue;
+		}
+
+		///load data and count AUC in a worker thread
+		CurveLoader *loader = new CurveLoader(QSharedPointer<ProxyFile> (new ProxyFile(fileName)));
+		loader->setBatch(batch);
+		connect(loader, SIGNAL(progressChanged(QString, int)), this, SIGNAL(loadProgress(QString, int)));
+		connect(loader, SIGNAL(loaded()), this, SLOT(curveLoaded()));
+		connect(loader, SIGNAL(failed(QString, int)), this, SLOT(curveFailed(QString, int)));
+		loaders_.insert(fileName, loader);
+		started.push_back(loader);
+	}
+
+	if (!started.isEmpty()) {
+		batchPending_.insert(batch, started.size());
+		for (int i = 0; i < started.size(); i++) {
+			emit loadStarted(started[i]->getPath());
+			pool_->start(started[i]);
+		}
+	}
+	return started.size();
+}
+
+/**
+* Plot class curveLoaded slot is called when a worker thread finished loading a file.
+* It creates the curve, or gives the data back to the deleted curve of the file, which
+* keeps its name and color. The curve is attached when the whole batch is loaded.
+*/
+void Plot::curveLoaded()
+{
+	CurveLoader *loader = qobject_cast<CurveLoader*>(sender());
+	if (!loader || loaders_.value(loader->getPath()) != loader) {
+		return;
+	}
+	loaders_.remove(loader->getPath());
+	loader->deleteLater();
+
+	///reattach a known curve
+	QSharedPointer<Curve> known = registry_.findPath(loader->getPath());
+	if (known) {
+		///the file may have changed since it was loaded before
+		known->setCurveData(loader->getCurveData());
+		known->init(loader->getAUC(), known->getColor());
+		known->setAUCError(loader->getCurveData()->getAUCError());
+		known->setOperatingPoints(loader->getCurveData()->getOperatingPoints());
+		known->setAttached(true);
+		batchCurves_[loader->getBatch()].push_back(known);
+		emit loadFinished(loader->getPath());
+		if (loader->getError() != 0) {
+			emit loadFailed(loader->getPath(), loader->getError());
+		}
+		finishBatchItem(loader->getBatch());
+		return;
+	}
+
+	///generate curve properties
+	QString name = generateName();
+	QSharedPointer<Curve> curve = QSharedPointer<Curve> (new Curve(name));
+	curve->setAttached(true);
+	curve->setRenderHint(QwtPlotItem::RenderAntialiased);
+
+	///generate color
+	QColor color = generateColor();
+	curve->setPen(QPen(color));
+
+	curve->setCurveData(loader->getCurveData());
+
+	///initialize curve
+	curve->init(loader->getAUC(), color);
+	curve->setAUCError(loader->getCurveData()->getAUCError());
+	curve->setOperatingPoints(loader->getCurveData()->getOperatingPoints());
+
+	registry_.insert(curve, loader->getProxy());
+	batchCurves_[loader->getBatch()].push_back(curve);
+
+	emit loadFinished(loader->getPath());
+
+	///report precision of points kept in compact form
+	QSharedPointer<CurveData> data = loader->getCurveData();
+	if (data->getMode() != QuantizedPoints::DoublePrecision) {
+		emit loadReport(loader->getPath(), QString("stored in %1, max error %2")
+			.arg(QuantizedPoints::modeName(data->getMode())).arg(data->getMaxError()));
+	}
+	if (loader->getError() != 0) {
+		emit loadFailed(loader->getPath(), loader->getError());
+	}
+
+	finishBatchItem(loader->getBatch());
+}
+
+/**
+* Plot class curveFailed slot is called when a worker thread failed to load a file
+* or the loading was cancelled. It emits loadFailed signal.
+* @param _path path of the file
+* @param _error error code
+*/
+void Plot::curveFailed(QString _path, int _error)
+{
+	CurveLoader *loader = qobject_cast<CurveLoader*>(sender());
+	if (!loader || loaders_.value(_path) != loader) {
+		return;
+	}
+	loaders_.remove(_path);
+	loader->deleteLater();
+
+	emit loadFinished(_path);
+	emit loadFailed(_path, _error);
+
+	finishBatchItem(loader->getBatch());
+}
+
+/**
+* Plot class finishBatchItem method counts down files of a batch
+* and attaches its curves after the last one was loaded
+* @param _batch batch identifier
+*/
+void Plot::finishBatchItem(int _batch)
+{
+	QHash<int, int>::iterator pending = batchPending_.find(_batch);
+	if (pending == batchPending_.end() || --pending.value() > 0) {
+		return;
+	}
+	batchPending_.erase(pending);
+	attachCurves(batchCurves_.take(_batch));
+}
+
+/**
+* Plot class cancelLoad slot requests cancellation of a file which is being loaded.
+* The loader reports back with error 1004 when it stops.
+* @param _path path of the file
+*/
+void Plot::cancelLoad(QString _path)
+{
+	CurveLoader *loader = loaders_.value(_path);
+	if (loader) {
+		loader->cancel();
+	}
+}
+
+/**
+* Plot class bootstrapCurve slot starts computing confidence intervals of a curve
+* in the thread pool. Only curves built from score files kept in memory can be resampled,
+* error 1012 is reported for other curves.
+* @param _id Curve identifier
+*/
+void Plot::bootstrapCurve(int _id)
+{
+	QSharedPointer<Curve> curve = registry_.curve(_id);
+	if (!curve || !curve->isAttached() || bootstraps_.contains(_id)) {
+		return;
+	}
+	QSharedPointer<CurveData> data = curve->getCurveData();
+	QSharedPointer<ScoreSet> scores;
+	if (data) {
+		scores = data->getScores();
+	}
+	if (!scores || scores->isStreamed()) {
+		emit loadFailed(data ? data->getPath() : curve->getTitle().text(), 1012);
+		return;
+	}
+
+	Bootstrap *bootstrap = new Bootstrap(scores, type);
+	bootstrap->setCurveId(_id);
+	connect(bootstrap, SIGNAL(progressChanged(int, int)), this, SLOT(bootstrapProgress()));
+	connect(bootstrap, SIGNAL(finished()), this, SLOT(bootstrapFinished()));
+	bootstraps_.insert(_id, bootstrap);
+	pool_->start(bootstrap);
+}
+
+/**
+* Plot class setSourcePlot method sets the plot of ROC curves from which this plot derives PR curves.
+* Derived curves follow changes of the points of their ROC curves.
+* @param _source plot of ROC curves
+*/
+void Plot::setSourcePlot(Plot *_source)
+{
+	source_ = _source;
+	connect(_source, SIGNAL(curveUpdated(int, double, OperatingPoints)), this, SLOT(sourceCurveChanged(int)));
+}
+
+/**
+* Plot class attachedCurves method gives curves which are displayed on the plot
+* @return attached curves
+*/
+QList<QSharedPointer<Curve> > Plot::attachedCurves() const
+{
+	QList<QSharedPointer<Curve> > attached;
+	QList<QSharedPointer<Curve> > curves = registry_.curves();
+	for (int i = 0; i < curves.size(); i++) {
+		if (curves[i]->isAttached()) {
+			attached.append(curves[i]);
+		}
+	}
+	return attached;
+}
+
+/**
+* Plot class derivePrCurves slot draws a PR curve for every curve of the source plot,
+* computed from its ROC points for the given prevalence of positive examples.
+* ROC points are read from the samples the ROC curve draws, no copy of them is kept.
+* Derived curves are dashed and drawn in the color of their ROC curve.
+* @param _prevalence fraction of positive examples, 0 removes derived curves
+*/
+void Plot::derivePrCurves(double _prevalence)
+{
+	prevalence_ = _prevalence;
+	beginUpdate();
+
+	QList<QSharedPointer<Curve> > curves;
+	if (source_ && _prevalence > 0.0) {
+		curves = source_->attachedCurves();
+	}
+
+	QHash<int, QwtPlotCurve*> kept;
+	for (int i = 0; i < curves.size(); i++) {
+		int id = curves[i]->getId();
+		if (curves[i]->data()->size() == 0) {
+			continue;
+		}
+		QwtPlotCurve *curve = derived_.take(id);
+		if (!curve) {
+			curve = new QwtPlotCurve(curves[i]->getTitle().text() + " (from ROC)");
+			curve->attach(this);
+		}
+		deriveCurve(curves[i], curve);
+		kept.insert(id, curve);
+	}
+
+	///curves removed from the source plot lose their derived curves
+	QList<int> removed = derived_.keys();
+	for (int i = 0; i < removed.size(); i++) {
+		forgetItem(derived_.value(removed[i]));
+	}
+	qDeleteAll(derived_);
+	derived_ = kept;
+
+	legend->repaint();
+	endUpdate();
+}
+
+/**
+* Plot class deriveCurve method computes the points of a derived PR curve for the current prevalence.
+* ROC samples are read in blocks from the series of the ROC curve, which reads mapped,
+* quantized or parsed points as they are stored.
+* @param _roc ROC curve of the source plot
+* @param _pr derived curve
+*/
+void Plot::deriveCurve(QSharedPointer<Curve> _roc, QwtPlotCurve *_pr)
+{
+	const QwtSeriesData<QPointF> *samples = _roc->data();
+	size_t count = samples->size();
+	QVector<QPointF> pr(int(count));
+	QPointF block[4096];
+	size_t origin = 0;
+	for (size_t begin = 0; begin < count; begin += 4096) {
+		size_t end = qMin(count, begin + 4096);
+		for (size_t i = begin; i < end; i++) {
+			block[i - begin] = samples->sample(i);
+			if (origin == i && block[i - begin] == QPointF(0.0, 0.0)) {
+				origin++;
 			}
+		}
+		Metrics::precisionRecall(block, end - begin, prevalence_, pr.data() + begin);
+	}
 
-			exists=true;
-			_proxy=proxies_[i];
-			(curves_[i])->attach(this);
-			color = (curves_[i])->getColor();
-			_auc = (curves_[i])->getAUC();
-			name = ((curves_[i])->getTitle()).text();
-			curve->setAttached(true);
+	///points at the origin take the precision of the first threshold, which may be in a later block
+	for (size_t i = 0; i < origin && origin < count; i++) {
+		pr[int(i)].setY(pr[int(origin)].y());
+	}
+
+	_pr->setPen(QPen(_roc->getColor(), 1, Qt::DashLine));
+	_pr->setSamples(pr);
+	invalidateItem(_pr);
+}
+
+/**
+* Plot class sourceCurveChanged slot derives the PR curve of a ROC curve of the source plot
+* again after its points changed, e.g. its followed file grew
+* @param _id identifier of the ROC curve
+*/
+void Plot::sourceCurveChanged(int _id)
+{
+	QwtPlotCurve *curve = derived_.value(_id);
+	if (!curve || !source_ || !(prevalence_ > 0.0)) {
+		return;
+	}
+	QSharedPointer<Curve> roc = source_->registry_.curve(_id);
+	if (!roc || !roc->isAttached()) {
+		return;
+	}
+	deriveCurve(roc, curve);
+	requestReplot();
+}
+
+/**
+* Plot class addToAverage slot adds a curve to the folds of the average curve
+* @param _id Curve identifier
+*/
+void Plot::addToAverage(int _id)
+{
+	QSharedPointer<Curve> curve = registry_.curve(_id);
+	if (!curve || !curve->isAttached() || average_.contains(_id)) {
+		return;
+	}
+	if (addFold(_id)) {
+		updateAverage();
+	}
+}
+
+/**
+* Plot class removeFromAverage slot removes a curve from the folds of the average curve
+* @param _id Curve identifier
+*/
+void Plot::removeFromAverage(int _id)
+{
+	if (!average_.contains(_id)) {
+		return;
+	}
+	average_.remove(_id);
+	updateAverage();
+}
+
+/**
+* Plot class setAverageMode slot chooses how folds are averaged, see CurveAverage
+* @param _mode CurveAverage::VerticalAveraging or CurveAverage::ThresholdAveraging
+* @param _band CurveAverage::MinMaxBand or CurveAverage::DeviationBand
+*/
+void Plot::setAverageMode(int _mode, int _band)
+{
+	bool modeChanged = _mode != average_.getMode();
+	average_.setMode(_mode, _band);
+	///prepared folds do not keep their points, they are taken from the curves again
+	if (modeChanged) {
+		QList<int> ids = average_.ids();
+		for (int i = 0; i < ids.size(); i++) {
+			addFold(ids[i]);
 		}
 	}
+	updateAverage();
+}
 
-	///load new curve
-	if(exists==false) {
+/**
+* Plot class addFold method gives the average the points of a curve: its loaded data,
+* or the points parsed so far if its file is followed, which are averaged without scores
+* @param _id Curve identifier
+* @return false if the curve has no points
+*/
+bool Plot::addFold(int _id)
+{
+	CurveTail *tail = tails_.value(_id);
+	if (tail) {
+		average_.add(_id, *tail->getPoints(), QSharedPointer<ScoreSet>());
+		return true;
+	}
+	QSharedPointer<Curve> curve = registry_.curve(_id);
+	QSharedPointer<CurveData> data = curve ? curve->getCurveData() : QSharedPointer<CurveData>();
+	if (!data) {
+		return false;
+	}
+	average_.add(_id, data->getPoints(), data->getScores());
+	return true;
+}
 
-		///generate curve properties
-		name = generateName();
-		curve = QSharedPointer<Curve> (new Curve(name));
-		curve->setAttached(true);
-		curve->setRenderHint(QwtPlotItem::RenderAntialiased);
+/**
+* Plot class updateAverage method starts computing the average curve in the thread pool
+* after its folds or mode changed, see averageUpdated. If an update is already running,
+* another one is started when it finishes, so changes made meanwhile are not lost.
+*/
+void Plot::updateAverage()
+{
+	if (averageUpdater_) {
+		averageDirty_ = true;
+		return;
+	}
+	averageDirty_ = false;
+	averageUpdater_ = new AverageUpdater(average_);
+	connect(averageUpdater_, SIGNAL(finished()), this, SLOT(averageUpdated()));
+	pool_->start(averageUpdater_);
+}
 
-		///generate color
-		color = generateColor();
-		curve->setPen(QPen(color));
-		curve->attach(this);
-		
-		///register new proxy
-		_proxy = QSharedPointer<ProxyFile> (new ProxyFile(fileName));
+/**
+* Plot class averageUpdated slot takes the computed average curve and draws it with its band,
+* or removes it if it has no folds. A result computed before the folds or mode changed
+* again is dropped and the average is computed once more.
+* It emits averageChanged signal with the number of folds and the AUC of the average,
+* and loadFailed signal for every fold which cannot be averaged.
+*/
+void Plot::averageUpdated()
+{
+	AverageUpdater *updater = qobject_cast<AverageUpdater*>(sender());
+	if (!updater || updater != averageUpdater_) {
+		return;
+	}
+	averageUpdater_ = NULL;
+	updater->deleteLater();
+	if (averageDirty_) {
+		updateAverage();
+		return;
+	}
+	average_ = updater->getAverage();
 
-		///load data
-		QVector<QPointF>* dPoints;
-		dPoints=_proxy->getData();
+	if (average_.size() == 0) {
+		if (averageCurve_) {
+			forgetItem(averageCurve_);
+			forgetItem(averageBand_);
+		}
+		delete averageCurve_;
+		delete averageBand_;
+		averageCurve_ = NULL;
+		averageBand_ = NULL;
+	}
+	else {
+		if (!averageCurve_) {
+			averageBand_ = new QwtPlotIntervalCurve();
+			averageBand_->setItemAttribute(QwtPlotItem::Legend, false);
+			averageBand_->setStyle(QwtPlotIntervalCurve::Tube);
+			averageBand_->setPen(Qt::NoPen);
+			QColor color(Qt::darkGray);
+			color.setAlpha(BAND_ALPHA);
+			averageBand_->setBrush(color);
+			averageBand_->attach(this);
+			averageCurve_ = new QwtPlotCurve();
+			averageCurve_->setPen(QPen(Qt::black, 2));
+			averageCurve_->attach(this);
+		}
+		averageCurve_->setTitle(QString("Average of %1 folds").arg(average_.size()));
+		averageCurve_->setSamples(average_.getMean());
+		averageBand_->setSamples(average_.getBand());
+		invalidateItem(averageCurve_);
+		invalidateItem(averageBand_);
+	}
+	legend->repaint();
+	replot();
 
-		///count AUC
-		try {
-			if (dPoints->size()<2){
-				throw 1003;
+	emit averageChanged(average_.size(), average_.getAUC());
+	if (updater->getError() != 0) {
+		const QList<int> &dropped = average_.getDropped();
+		for (int i = 0; i < dropped.size(); i++) {
+			QSharedPointer<Curve> curve = registry_.curve(dropped[i]);
+			QSharedPointer<CurveData> data = curve ? curve->getCurveData() : QSharedPointer<CurveData>();
+			QString source = data ? data->getPath() : (curve ? curve->getTitle().text() : title().text());
+			emit loadFailed(source, updater->getError());
+		}
+	}
+}
+
+/**
+* Plot class setHullOverlay slot shows or hides ROC convex hulls of attached curves,
+* the hull of all of them and the iso-performance line touching that hull.
+* @param _shown true if hulls are drawn
+* @param _slope slope of iso-performance lines, 0 if no line is drawn
+*/
+void Plot::setHullOverlay(bool _shown, double _slope)
+{
+	if (type != ROC_CURVE) {
+		return;
+	}
+	hullsShown_ = _shown;
+	isoSlope_ = _slope;
+	updateHulls();
+	legend->repaint();
+	replot();
+}
+
+/**
+* Plot class updateHulls method draws ROC convex hulls after curves were attached, detached,
+* shown or hidden. The hull of a curve is built once, when the curve is first drawn with hulls,
+* and kept until it is detached or its points change; the hull of all visible curves unites the kept hulls.
+* Hulls are dotted and drawn in the color of their curve.
+*/
+void Plot::updateHulls()
+{
+	QList<QSharedPointer<Curve> > curves;
+	if (hullsShown_) {
+		curves = attachedCurves();
+	}
+
+	QHash<int, QwtPlotCurve*> kept;
+	QList<QVector<QPointF> > visible;
+	QList<QSharedPointer<Curve> > owners;
+	for (int i = 0; i < curves.size(); i++) {
+		int id = curves[i]->getId();
+		QHash<int, QVector<QPointF> >::iterator hull = hulls_.find(id);
+		bool built = hull == hulls_.end();
+		if (built) {
+			///a followed curve has no data, its points are parsed by its tail
+			CurveTail *tail = tails_.value(id);
+			QSharedPointer<CurveData> data = curves[i]->getCurveData();
+			if (!tail && !data) {
+				continue;
 			}
-			else{
-				for (int i=0; i<dPoints->size()-1; i++){
-					_auc+=1.0/2.0*( (*dPoints)[i].y()+(*dPoints)[i+1].y() ) * ( (*dPoints)[i+1].x()-(*dPoints)[i].x() );
-				}
+			QVector<QPointF> points = tail ? *tail->getPoints() : data->getPoints();
+			hull = hulls_.insert(id, RocHull::hull(points.constData(), points.size()));
+		}
+
+		QwtPlotCurve *curve = hullCurves_.take(id);
+		if (!curve) {
+			curve = new QwtPlotCurve();
+			curve->setItemAttribute(QwtPlotItem::Legend, false);
+			curve->attach(this);
+			built = true;
+		}
+		if (built) {
+			curve->setSamples(*hull);
+			invalidateItem(curve);
+		}
+		///a hull is drawn again only if its curve was recolored
+		QPen pen(curves[i]->getColor(), 1, Qt::DotLine);
+		if (curve->pen() != pen) {
+			curve->setPen(pen);
+			invalidateItem(curve);
+		}
+		curve->setVisible(curves[i]->plotItem()->isVisible());
+		kept.insert(id, curve);
+		if (curve->isVisible()) {
+			visible.append(*hull);
+			owners.append(curves[i]);
+		}
+	}
+
+	///curves detached from the plot lose their hulls
+	QList<int> removed = hullCurves_.keys();
+	for (int i = 0; i < removed.size(); i++) {
+		hulls_.remove(removed[i]);
+		forgetItem(hullCurves_.value(removed[i]));
+	}
+	qDeleteAll(hullCurves_);
+	hullCurves_ = kept;
+
+	QVector<int> vertexOwners;
+	QVector<QPointF> united = RocHull::unite(visible, &vertexOwners);
+	if (united.isEmpty()) {
+		if (unionHull_) {
+			forgetItem(unionHull_);
+		}
+		delete unionHull_;
+		unionHull_ = NULL;
+	}
+	else {
+		if (!unionHull_) {
+			unionHull_ = new QwtPlotCurve("ROC convex hull");
+			unionHull_->setPen(QPen(Qt::darkGray, 2, Qt::DashLine));
+			unionHull_->attach(this);
+		}
+		unionHull_->setSamples(united);
+		invalidateItem(unionHull_);
+	}
+
+	///iso-performance line through the optimal vertex, named after the curve it belongs to
+	int vertex = isoSlope_ > 0.0 ? RocHull::optimalVertex(united, isoSlope_) : -1;
+	if (vertex < 0) {
+		if (isoLine_) {
+			forgetItem(isoLine_);
+		}
+		delete isoLine_;
+		isoLine_ = NULL;
+		return;
+	}
+	if (!isoLine_) {
+		isoLine_ = new QwtPlotCurve();
+		isoLine_->setPen(QPen(Qt::black, 1, Qt::DashDotLine));
+		isoLine_->attach(this);
+	}
+	QLineF line = RocHull::isoPerformanceLine(united[vertex], isoSlope_);
+	QVector<QPointF> samples;
+	samples.append(line.p1());
+	samples.append(line.p2());
+	isoLine_->setSamples(samples);
+	QPointF optimum = united[vertex];
+	bool trivial = (optimum == QPointF(0.0, 0.0) || optimum == QPointF(1.0, 1.0));
+	isoLine_->setTitle(trivial ? QString("Iso-performance: trivial classifier")
+		: QString("Iso-performance: %1").arg(owners[vertexOwners[vertex]]->getTitle().text()));
+	invalidateItem(isoLine_);
+}
+
+/**
+* Plot class followCurve slot starts or stops following the file of a curve, which is still
+* being written. A followed curve shows points parsed by CurveTail instead of its loaded data,
+* which is given to the cache. Only text curve files can be followed.
+* It emits curveFollowed signal with the new state and curveUpdated signal with AUC and
+* operating points of the parsed points.
+* @param _id Curve identifier
+* @param _follow true to start following the file
+*/
+void Plot::followCurve(int _id, bool _follow)
+{
+	QSharedPointer<Curve> curve = registry_.curve(_id);
+	if (!curve || !curve->isAttached()) {
+		return;
+	}
+	if (!_follow) {
+		stopFollowing(_id);
+		return;
+	}
+	if (tails_.contains(_id)) {
+		return;
+	}
+	QSharedPointer<CurveData> data = curve->getCurveData();
+	if (!data || !CurveTail::canFollow(data->getPath())) {
+		emit curveFollowed(_id, false);
+		return;
+	}
+
+	///the file is parsed once more to learn where its complete lines end
+	CurveTail *tail = new CurveTail(data->getPath(), type);
+	try {
+		tail->update();
+	}
+	catch(int e) {
+		delete tail;
+		emit curveFollowed(_id, false);
+		emit loadFailed(data->getPath(), e);
+		return;
+	}
+
+	///band was computed from the loaded data, the average and the hull take the parsed points
+	dropBand(_id);
+	hulls_.remove(_id);
+
+	beginUpdate();
+	CurveCache::instance()->retain(curve->releaseCurveData());
+	curve->setData(new FunctionData(tail->getPoints(), tail->boundingRect(), tail->isMonotone()));
+	curve->init(tail->getAUC(), curve->getColor());
+	curve->setOperatingPoints(tail->getOperatingPoints());
+	invalidateItem(curve->plotItem());
+	tails_.insert(_id, tail);
+	watcher_->addPath(tail->getPath());
+	if (hullsShown_) {
+		updateHulls();
+	}
+	if (average_.contains(_id)) {
+		average_.remove(_id);
+		addFold(_id);
+		updateAverage();
+	}
+	endUpdate();
+
+	emit curveFollowed(_id, true);
+	emit curveUpdated(_id, tail->getAUC(), tail->getOperatingPoints());
+}
+
+/**
+* Plot class stopFollowing method stops following the file of a curve. Points parsed
+* so far stay displayed; when the curve is added again, its file is loaded again.
+* It emits curveFollowed signal.
+* @param _id Curve identifier
+*/
+void Plot::stopFollowing(int _id)
+{
+	CurveTail *tail = tails_.take(_id);
+	if (!tail) {
+		return;
+	}
+	changedTails_.remove(_id);
+
+	///the series points into the tail, so it gets a copy of the points
+	QSharedPointer<Curve> curve = registry_.curve(_id);
+	if (curve) {
+		bool doReplot = autoReplot();
+		setAutoReplot(false);
+		curve->setData(new QwtPointSeriesData(*tail->getPoints()));
+		setAutoReplot(doReplot);
+	}
+
+	///the file stays watched while another curve follows it
+	bool watched = false;
+	QHash<int, CurveTail*>::const_iterator it;
+	for (it = tails_.constBegin(); it != tails_.constEnd(); ++it) {
+		watched = watched || it.value()->getPath() == tail->getPath();
+	}
+	if (!watched) {
+		watcher_->removePath(tail->getPath());
+	}
+	delete tail;
+	emit curveFollowed(_id, false);
+}
+
+/**
+* Plot class tailChanged slot is called when a followed file changed. Changes are collected
+* and applied by updateTails when the throttling interval ends.
+* @param _path path of the changed file
+*/
+void Plot::tailChanged(QString _path)
+{
+	QHash<int, CurveTail*>::const_iterator it;
+	for (it = tails_.constBegin(); it != tails_.constEnd(); ++it) {
+		if (it.value()->getPath() == _path) {
+			changedTails_.insert(it.key());
+		}
+	}
+
+	///a file replaced by a new one, e.g. renamed over it, is not watched any more;
+	///if it does not exist yet, updateTails watches it again when it appears
+	if (!watcher_->files().contains(_path) && QFile::exists(_path)) {
+		watcher_->addPath(_path);
+	}
+	if (!changedTails_.isEmpty() && !tailTimer_->isActive()) {
+		tailTimer_->start();
+	}
+}
+
+/**
+* Plot class updateTails slot parses lines appended to changed files. Only the new segments
+* of a grown curve are painted, by the direct painter, without replotting other curves;
+* the plot is replotted only for curves whose files were rewritten or whose hulls are shown.
+* Hulls and the average are computed again from the grown curves, derived PR curves
+* follow curveUpdated signal, which is emitted with AUC and operating points of every grown curve.
+* Files which were replaced and are not watched any more are watched again once they exist.
+*/
+void Plot::updateTails()
+{
+	bool missing = false;
+	QStringList watched = watcher_->files();
+	QHash<int, CurveTail*>::const_iterator it;
+	for (it = tails_.constBegin(); it != tails_.constEnd(); ++it) {
+		QString path = it.value()->getPath();
+		if (watched.contains(path)) {
+			continue;
+		}
+		if (QFile::exists(path)) {
+			watcher_->addPath(path);
+			watched.append(path);
+			changedTails_.insert(it.key());
+		}
+		else {
+			missing = true;
+		}
+	}
+
+	QList<int> changed = changedTails_.toList();
+	changedTails_.clear();
+
+	bool doReplot = autoReplot();
+	setAutoReplot(false);
+	bool fullReplot = false;
+	bool grown = false;
+	bool averaged = false;
+	for (int i = 0; i < changed.size(); i++) {
+		int id = changed[i];
+		CurveTail *tail = tails_.value(id);
+		QSharedPointer<Curve> curve = registry_.curve(id);
+		if (!tail || !curve) {
+			continue;
+		}
+
+		int from = int(tail->size());
+		try {
+			if (!tail->update()) {
+				continue;
 			}
 		}
 		catch(int e) {
-			QErrorMessage errorMessage;
-			if(e == 1003)
-				errorMessage.showMessage("Error. Unable to calculate AUC. Bad number of points.");
+			QString path = tail->getPath();
+			stopFollowing(id);
+			emit loadFailed(path, e);
+			fullReplot = true;
+			continue;
 		}
 
-		curve->setData(new FunctionData(dPoints));
+		curve->setData(new FunctionData(tail->getPoints(), tail->boundingRect(), tail->isMonotone()));
+		curve->init(tail->getAUC(), curve->getColor());
+		curve->setOperatingPoints(tail->getOperatingPoints());
+		invalidateItem(curve->plotItem());
+		if (tail->wasRestarted()) {
+			fullReplot = true;
+		}
+		else if (curve->plotItem()->isVisible() && !hullsShown_) {
+			///the new segments start at the last point the curve had
+			directPainter_->drawSeries(curve->seriesItem(), qMax(from - 1, 0), int(tail->size()) - 1);
+		}
+		hulls_.remove(id);
+		grown = true;
+		if (average_.contains(id)) {
+			average_.remove(id);
+			addFold(id);
+			averaged = true;
+		}
+		emit curveUpdated(id, tail->getAUC(), tail->getOperatingPoints());
+	}
+	if (hullsShown_ && (grown || fullReplot)) {
+		updateHulls();
+		fullReplot = true;
+	}
+	if (averaged) {
+		updateAverage();
+	}
+	setAutoReplot(doReplot);
+	if (fullReplot) {
+		replot();
+	}
 
-		///initialize curve
-		curve->init(_auc, color);
+	///a replaced file which does not exist yet is looked for again after the interval
+	if (missing && !tailTimer_->isActive()) {
+		tailTimer_->start();
+	}
+}
 
-		curves_.push_back(curve);
-		proxies_.push_back(_proxy);
+/**
+* Plot class compareCurves slot compares AUCs of all attached curves built from score files
+* with the DeLong test and emits significanceComputed signal with names of the curves and
+* the results. Error 1013 or 1014 is reported if the curves cannot be compared.
+*/
+void Plot::compareCurves()
+{
+	QStringList names;
+	QList<QSharedPointer<ScoreSet> > sets;
+	QList<QSharedPointer<Curve> > curves = registry_.curves();
+	for (int i = 0; i < curves.size(); i++) {
+		QSharedPointer<CurveData> data = curves[i]->getCurveData();
+		if (!curves[i]->isAttached() || !data || !data->getScores()) {
+			continue;
+		}
+		names.append(curves[i]->getTitle().text());
+		sets.append(data->getScores());
 	}
 
-	curve->setIndex((itemList(QwtPlotItem::Rtti_PlotCurve)).size() - 1);
-	
-	curve_counter++;
-	
-	///add curve to plot legend
-	QwtPlotItemList items = itemList(QwtPlotItem::Rtti_PlotCurve);
-	for(int i = 0; i < items.size(); i++)
-    {
-		if(i == items.size() - 1) {
-			QwtLegendItem *legendItem = (QwtLegendItem *)legend->find(items[i]);
-            if(legendItem) {
-				legendItem->setChecked(true);
-			}
-            items[i]->setVisible(true);
-        }
-    }
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	QSharedPointer<DeLong> result;
+	try {
+		result = DeLong::compare(sets);
+	}
+	catch(int e) {
+		QApplication::restoreOverrideCursor();
+		emit loadFailed(title().text(), e);
+		return;
+	}
+	QApplication::restoreOverrideCursor();
+	emit significanceComputed(names, result);
+}
 
-	emit curveAdded(name, color, _auc);
-	return 0;
+/**
+* Plot class bootstrapProgress slot is called after every round of bootstrap replicates.
+* The confidence band of the curve is drawn under it, filled with the curve color,
+* and aucIntervalChanged signal is emitted with the interval of AUC.
+*/
+void Plot::bootstrapProgress()
+{
+	Bootstrap *bootstrap = qobject_cast<Bootstrap*>(sender());
+	if (!bootstrap) {
+		return;
+	}
+	int id = bootstrap->getCurveId();
+	QSharedPointer<Curve> curve = registry_.curve(id);
+	if (!curve || !curve->isAttached()) {
+		return;
+	}
+	BootstrapResult result = bootstrap->result();
+
+	QwtPlotIntervalCurve *band = bands_.value(id);
+	if (!band) {
+		band = new QwtPlotIntervalCurve(curve->getTitle());
+		band->setItemAttribute(QwtPlotItem::Legend, false);
+		band->setStyle(QwtPlotIntervalCurve::Tube);
+		band->setPen(Qt::NoPen);
+		band->setZ(curve->plotItem()->z() - 1);
+		band->attach(this);
+		bands_.insert(id, band);
+	}
+	QColor color = curve->getColor();
+	color.setAlpha(BAND_ALPHA);
+	band->setBrush(color);
+	band->setSamples(result.band);
+	band->setVisible(curve->plotItem()->isVisible());
+	invalidateItem(band);
+	replot();
+
+	emit aucIntervalChanged(id, result.aucLow, result.aucHigh, result.replicates);
+}
+
+/**
+* Plot class bootstrapFinished slot releases a bootstrap which finished or was cancelled.
+* Its band stays on the plot.
+*/
+void Plot::bootstrapFinished()
+{
+	Bootstrap *bootstrap = qobject_cast<Bootstrap*>(sender());
+	if (!bootstrap) {
+		return;
+	}
+	if (bootstraps_.value(bootstrap->getCurveId()) == bootstrap) {
+		bootstraps_.remove(bootstrap->getCurveId());
+	}
+	bootstrap->deleteLater();
+}
+
+/**
+* Plot class dropBand method cancels the bootstrap of a curve and removes its confidence band.
+* A cancelled bootstrap is released when it reports back.
+* @param _id Curve identifier
+*/
+void Plot::dropBand(int _id)
+{
+	Bootstrap *bootstrap = bootstraps_.value(_id);
+	if (bootstrap) {
+		bootstrap->cancel();
+	}
+	QwtPlotIntervalCurve *band = bands_.take(_id);
+	if (band) {
+		forgetItem(band);
+		band->detach();
+		delete band;
+	}
+}
+
+/**
+* Plot class attachCurves method attaches curves to the plot. The legend is rebuilt
+* and the plot is replotted once for all of them.
+* It emits curveAdded signal with id, name, color, AUC, its error and operating points as parameters for every curve.
+* @param _curves curves to be attached
+*/
+void Plot::attachCurves(const QList<QSharedPointer<Curve> > &_curves)
+{
+	if (_curves.isEmpty()) {
+		return;
+	}
+
+	beginUpdate();
+	legend->setUpdatesEnabled(false);
+
+	for (int i = 0; i < _curves.size(); i++) {
+		_curves[i]->attach(this);
+		_curves[i]->setAttached(true);
+	}
+
+	///check curves in plot legend
+	for (int i = 0; i < _curves.size(); i++) {
+		QSharedPointer<Curve> curve = _curves[i];
+		curve_counter++;
+
+		QwtLegendItem *legendItem = (QwtLegendItem *)legend->find(curve->plotItem());
+		if(legendItem) {
+			legendItem->setChecked(true);
+		}
+		curve->setVisible(true);
+
+		emit curveAdded(curve->getId(), (curve->getTitle()).text(), curve->getColor(), curve->getAUC(), curve->getAUCError(), curve->getOperatingPoints());
+	}
+
+	///only hulls of the new curves are built
+	if (hullsShown_) {
+		updateHulls();
+	}
+
+	legend->setUpdatesEnabled(true);
+	endUpdate();
+}
+
+/**
+* Plot class applyStyle method gives a plot the background, axis ranges and canvas
+* of the interactive plot. Plots rendered without a window are styled by it as well.
+* @param _plot styled plot
+*/
+void Plot::applyStyle(QwtPlot *_plot)
+{
+	///Set background properties
+	_plot->setAutoFillBackground(true);
+	_plot->setPalette(QPalette(QColor(185, 213, 248)));
+
+	///Set axis ranges
+	_plot->setAxisScale(xBottom, 0.0, 1.0);
+	_plot->setAxisScale(yLeft, 0.0, 1.0);
+
+	///Set plot canvas
+	_plot->canvas()->setLineWidth(1);
+	_plot->canvas()->setFrameStyle(QFrame::Box | QFrame::Plain);
+	_plot->canvas()->setBorderRadius(15);
+
+	///Set canvas color
+	QPalette canvasPalette(Qt::white);
+	canvasPalette.setColor(QPalette::Foreground, QColor(133, 190, 232));
+	_plot->canvas()->setPalette(canvasPalette);
+}
+
+/**
+* Plot class createGrid method creates the grid of the interactive plot,
+* which is also drawn on plots rendered without a window
+* @return grid, deleted by the plot it is attached to
+*/
+QwtPlotGrid* Plot::createGrid()
+{
+	return new Grid;
+}
+
+/**
+* Plot class curveColor method gives the color of a curve added to a plot in turn,
+* the same sequence is used by plots rendered without a window
+* @param _index number of the curve
+* @return color of the curve
+*/
+QColor Plot::curveColor(int _index)
+{
+	return QColor(QtColors[_index % QtColorsCount]);
 }
 
 /**
@@ -321,9 +1557,9 @@ int Plot::addCurve(QString fileName, int _type)
 QColor Plot::generateColor()
 {
 	QColor color;
-	color.setRgb(QtColors[itColor]);
+	color = QColor(QtColors[itColor]);
 	itColor++;
-	if(itColor == sizeof(QtColors)) {
+	if(itColor == QtColorsCount) {
 		itColor = 0;
 	}
 	return color;
@@ -333,7 +1569,7 @@ QColor Plot::generateColor()
 * Plot class generateName method is used to generate name of a curve.
 */
 QString Plot::generateName(){
-	int curveNr = curves_.size() + 1;
+	int curveNr = ++name_counter;
 	QString name = QString("krzywa_%1").arg(curveNr);
 	return name;
 }
@@ -370,18 +1606,43 @@ bool Plot::eventFilter(QObject *obj, QEvent *event)
 */
 void Plot::showItem(QwtPlotItem* item, bool _state)
 {
+	///checking legend items from code, e.g. when curves are attached, shows curves already shown
+	if (item->isVisible() == _state) {
+		return;
+	}
+
+	///only the layers of the item and its band are drawn again, as their visible items change
+	bool doReplot = autoReplot();
+	setAutoReplot(false);
 	item->setVisible(_state);
+
+	///confidence band follows its curve
+	QHash<int, QwtPlotIntervalCurve*>::const_iterator it;
+	for(it = bands_.constBegin(); it != bands_.constEnd(); ++it) {
+		QSharedPointer<Curve> curve = registry_.curve(it.key());
+		if (curve && curve->plotItem() == item) {
+			it.value()->setVisible(_state);
+		}
+	}
+	setAutoReplot(doReplot);
+	if (hullsShown_) {
+		updateHulls();
+	}
+	requestReplot();
 }
 
 /**
 * Plot class changeName slot is called by PlotWindow if curve name was modified in panel
-* @param _pos Curve identifier
+* @param _id Curve identifier
 * @param _newName New curve name
 */
-void Plot::changeName(int _pos, QString _newName)
+void Plot::changeName(int _id, QString _newName)
 {
-	QwtPlotItemList items = itemList(QwtPlotItem::Rtti_PlotCurve);
-	items[_pos]->setTitle(_newName);
+	QSharedPointer<Curve> curve = registry_.curve(_id);
+	if (!curve) {
+		return;
+	}
+	curve->setTitle(_newName);
 	legend->repaint();
 }
 
@@ -392,36 +1653,25 @@ void Plot::changeName(int _pos, QString _newName)
 */
 void Plot::changeColor(int _id, QColor _newColor)
 {
-	QwtPlotItemList items = itemList(QwtPlotItem::Rtti_PlotCurve);
-	vector<QSharedPointer<Curve> >::const_iterator it;
-	for(it = curves_.begin(); it != curves_.end(); ++it) 
-	{	
-		if((*it)->getIndex() == _id) {
-			(*it)->setPen(_newColor);
-		}
+	QSharedPointer<Curve> curve = registry_.curve(_id);
+	if (!curve || !_newColor.isValid()) {
+		return;
 	}
-	legend->repaint();
-}
-
-/**
-* Plot class getColAuc slot is called by PlotWindow to display color and AUC info in panel.
-* It emits resendColorAuc signal with color and AUC as parameters
-* @param _id Curve identifier
-*/
-void Plot::getColAuc(int _id)
-{
-	QColor color;
-	double auc=-1.0;
-	QwtPlotItemList items = itemList(QwtPlotItem::Rtti_PlotCurve);
-	vector<QSharedPointer<Curve> >::const_iterator it;
-	for(it = curves_.begin(); it != curves_.end(); ++it) 
-	{	
-		if((*it)->getIndex() == _id) {
-			color = (*it)->getColor();
-			auc = (*it)->getAUC();
-		}
+	///only the recolored curve and its band are drawn again
+	bool doReplot = autoReplot();
+	setAutoReplot(false);
+	curve->setColor(_newColor);
+	invalidateItem(curve->plotItem());
+	QwtPlotIntervalCurve *band = bands_.value(_id);
+	if (band) {
+		QColor color = _newColor;
+		color.setAlpha(BAND_ALPHA);
+		band->setBrush(color);
+		invalidateItem(band);
 	}
-	emit resendColorAuc(color, auc);
+	setAutoReplot(doReplot);
+	requestReplot();
+	legend->repaint();
 }
 
 /**
@@ -430,47 +1680,61 @@ void Plot::getColAuc(int _id)
 */
 void Plot::deleteCurve(int _id)
 {
-	///detaching curve from plot
-	QwtPlotItemList items = itemList(QwtPlotItem::Rtti_PlotCurve);
-	items[_id]->detach();
-	legend->repaint();
+	QSharedPointer<Curve> curve = registry_.curve(_id);
+	if (!curve || !curve->isAttached()) {
+		return;
+	}
+
+	///detaching curve and its confidence band from plot, the average loses the fold
+	stopFollowing(_id);
+	dropBand(_id);
+	if (average_.contains(_id)) {
+		average_.remove(_id);
+		updateAverage();
+	}
+	forgetItem(curve->plotItem());
+	curve->attach(NULL);
 	curve_counter--;
-	replot();	
-	
-	///upgrade attachement settings in curve properties vector
-	int index;
-	for (int i=0; i<curves_.size(); i++){
-		index = (curves_[i])->getIndex();
-		if (index == _id){
-			curves_[i]->setAttached(false);
-		}
-		if (index > _id){
-			curves_[i]->setIndex(index - 1);
-		}
+
+	///the curve stays registered to be reattached, its data is given to the cache
+	curve->setAttached(false);
+	CurveCache::instance()->retain(curve->releaseCurveData());
+	if (hullsShown_) {
+		updateHulls();
 	}
+	legend->repaint();
+	replot();
 }
 
 /**
 * Plot class leaveOneUnhided slot is called by PlotWindow when button in panel was activated
 * It sets unvisible all curves except of the one with given id
-* @param _pos Curve identifier
+* @param _id Curve identifier
 */
 void Plot::leaveOneUnhided(int _id)
 {
-	QwtPlotItemList items = itemList(QwtPlotItem::Rtti_PlotCurve);
-	for(int i = 0; i < items.size(); i++){
-		QwtLegendItem *legendItem = (QwtLegendItem *)legend->find(items[i]);
-		if(i == _id){
-            if(legendItem)
-                legendItem->setChecked(true);
-            items[i]->setVisible(true);
-        }
-		else {
-			if(legendItem)
-                legendItem->setChecked(false);
-			items[i]->setVisible(false);
+	beginUpdate();
+
+	QList<QSharedPointer<Curve> > curves = registry_.curves();
+	for(int i = 0; i < curves.size(); i++){
+		if(!curves[i]->isAttached()) {
+			continue;
+		}
+		bool visible = curves[i]->getId() == _id;
+		curves[i]->setVisible(visible);
+		QwtLegendItem *legendItem = (QwtLegendItem *)legend->find(curves[i]->plotItem());
+		if(legendItem)
+			legendItem->setChecked(visible);
+		QwtPlotIntervalCurve *band = bands_.value(curves[i]->getId());
+		if (band) {
+			band->setVisible(visible);
 		}
     }
+	if (hullsShown_) {
+		updateHulls();
+	}
+
+	endUpdate();
 }
 
 /**
@@ -479,18 +1743,53 @@ void Plot::leaveOneUnhided(int _id)
 */
 void Plot::clearAll()
 {
+	beginUpdate();
+	legend->setUpdatesEnabled(false);
+
+	QList<int> followed = tails_.keys();
+	for(int i = 0; i < followed.size(); i++){
+		stopFollowing(followed[i]);
+	}
+	QList<int> banded = bands_.keys() + bootstraps_.keys();
+	for(int i = 0; i < banded.size(); i++){
+		dropBand(banded[i]);
+	}
+	QHash<int, QwtPlotCurve*>::const_iterator derived;
+	for (derived = derived_.constBegin(); derived != derived_.constEnd(); ++derived) {
+		forgetItem(derived.value());
+	}
+	qDeleteAll(derived_);
+	derived_.clear();
+	average_.clear();
+	updateAverage();
+
 	QwtPlotItemList items = itemList(QwtPlotItem::Rtti_PlotCurve);
 	for(int i = 0; i < items.size(); i++){
+		///the item is detached at once, so it is not hidden by showItem
 		QwtLegendItem *legendItem = (QwtLegendItem *)legend->find(items[i]);
 		if(legendItem) {
+			legendItem->blockSignals(true);
 			legendItem->setChecked(false);
+			legendItem->blockSignals(false);
 		}
 		//items[i]->setVisible(false);
-		curves_[i]->setAttached(false);
+		forgetItem(items[i]);
 		items[i]->detach();
 	}
+
+	///give data of detached curves to the cache, the curves leave the registry
+	QList<QSharedPointer<Curve> > curves = registry_.curves();
+	for (int i = 0; i < curves.size(); i++){
+		if (curves[i]->isAttached()) {
+			curves[i]->setAttached(false);
+			CurveCache::instance()->retain(curves[i]->releaseCurveData());
+		}
+	}
+	registry_.clear();
+	updateHulls();
+	legend->setUpdatesEnabled(true);
 	legend->repaint();
-	replot();
+	endUpdate();
 }
 
 /**
@@ -21,8 +21,12 @@
  */
 
 #include "../headers/PlotWindow.h"
+#include "../headers/ErrorCodes.h"
 #include "../headers/FunctionData.h"
 #include "../headers/Panel.h"
+#include "../headers/ScoreSet.h"
+#include "../headers/ScoreSketch.h"
+#include "../headers/SketchBuilder.h"
 #include <qlayout.h>
 #include <qaction.h>
 #include <qtextcodec.h>
@@ -41,6 +45,15 @@
 #include <qfiledialog.h>
 #include <qprintdialog.h>
 #include <qwt_plot_renderer.h>
+#include <qprogressbar.h>
+#include <qtoolbutton.h>
+#include <qlabel.h>
+#include <qsignalmapper.h>
+#include <qinputdialog.h>
+#include <qtimer.h>
+#include <qthreadpool.h>
+#include "../headers/BinaryCurve.h"
+#include "../headers/CurveCache.h"
 #include <QErrorMessage>
 
 /**
@@ -50,11 +63,21 @@ PlotWindow::PlotWindow()
 {
 	w = new QWidget(this);
 
+	///restore memory budget of the curve cache
+	QSettings settings("projekt-zpr", "projekt-zpr");
+	CurveCache::instance()->setBudget(qint64(settings.value("cacheBudget", 512).toInt()) * 1024 * 1024);
+	CurveData::setStorageMode(QuantizedPoints::Mode(settings.value("storageMode", 0).toInt()));
+	ScoreSet::setMemoryBudget(qint64(settings.value("scoreBudget", 1024).toInt()) * 1024 * 1024);
+
 	///create plot and panel objects for each type
 	roc_plot = new Plot(w, 0);
 	pr_plot = new Plot(w, 1);
 	roc_panel = new Panel(w, 0);
-	pr_panel = new Panel(w, 0);
+	pr_panel = new Panel(w, 1);
+
+	///PR curves can be derived from ROC curves for a prevalence chosen in the PR panel
+	pr_plot->setSourcePlot(roc_plot);
+	connect(pr_panel,	SIGNAL(prevalenceChanged(double)),	pr_plot,	SLOT(derivePrCurves(double)));
 
 	///set pr_plot as current plot
 	current_plot = pr_plot;
@@ -74,6 +97,16 @@ PlotWindow::PlotWindow()
 	createToolBars();
 	createStatusBar();
 
+	///show loading progress of both plots in the status bar
+	Plot *plots[] = { roc_plot, pr_plot };
+	for(int i = 0; i < 2; i++) {
+		connect(plots[i],	SIGNAL(loadStarted(QString)),		this,	SLOT(loadStarted(QString)));
+		connect(plots[i],	SIGNAL(loadProgress(QString, int)),	this,	SLOT(loadProgress(QString, int)));
+		connect(plots[i],	SIGNAL(loadFinished(QString)),		this,	SLOT(loadFinished(QString)));
+		connect(plots[i],	SIGNAL(loadFailed(QString, int)),	this,	SLOT(reportError(QString, int)));
+		connect(plots[i],	SIGNAL(loadReport(QString, QString)),	this,	SLOT(showReport(QString, QString)));
+	}
+
 	///call switch plot method, activate signals and slots
 	switched = 0;
 	switchPlot();
@@ -82,11 +115,16 @@ PlotWindow::PlotWindow()
 }
 
 /**
-* Plot class closeEvent method is called while QCloseEvent was captured
+* Plot class closeEvent method is called while QCloseEvent was captured.
+* Sketches which are still being built are cancelled.
 * @param event 
 */
 void PlotWindow::closeEvent(QCloseEvent *event)
 {
+	QHash<QString, SketchBuilder*>::const_iterator it;
+	for (it = sketchBuilders.constBegin(); it != sketchBuilders.constEnd(); ++it){
+		it.value()->cancel();
+	}
 	event->accept();
 }
  
@@ -112,13 +150,16 @@ void PlotWindow::switchPlot()
 	if(switched < 2) {
 		
 		///activate signals sent from Plot to Panel
-		connect(current_plot,	SIGNAL(curveAdded(QString, QColor, double)),	current_panel,	SLOT(addCurve(QString, QColor, double)));
-		connect(current_plot,	SIGNAL(resendColorAuc(QColor, double)),			current_panel,	SLOT(readColorAuc(QColor, double)));
+		connect(current_plot,	SIGNAL(curveAdded(int, QString, QColor, double, double, OperatingPoints)),	current_panel,	SLOT(addCurve(int, QString, QColor, double, double, OperatingPoints)));
+		connect(current_plot,	SIGNAL(aucIntervalChanged(int, double, double, int)),	current_panel,	SLOT(showAucInterval(int, double, double, int)));
+		connect(current_plot,	SIGNAL(averageChanged(int, double)),			current_panel,	SLOT(showAverage(int, double)));
+		connect(current_plot,	SIGNAL(curveFollowed(int, bool)),				current_panel,	SLOT(showFollowed(int, bool)));
+		connect(current_plot,	SIGNAL(curveUpdated(int, double, OperatingPoints)),	current_panel,	SLOT(updateCurve(int, double, OperatingPoints)));
+		connect(current_plot,	SIGNAL(significanceComputed(QStringList, QSharedPointer<DeLong>)),	current_panel,	SLOT(showSignificance(QStringList, QSharedPointer<DeLong>)));
 		
 		///activate signals sent from Panel to Plot
 		connect(current_panel,	SIGNAL(nameChange(int, QString)),				current_plot,	SLOT(changeName(int, QString)));
 		connect(current_panel,	SIGNAL(colorChange(int, QColor)),				current_plot,	SLOT(changeColor(int, QColor)));
-		connect(current_panel,	SIGNAL(getColorAuc(int)),						current_plot,	SLOT(getColAuc(int)));
 		connect(current_panel,	SIGNAL(curveDelete(int)),						current_plot,	SLOT(deleteCurve(int)));
 		connect(current_panel,	SIGNAL(hideAllExceptOfThis(int)),				current_plot,	SLOT(leaveOneUnhided(int)));
 		connect(current_panel,	SIGNAL(clearPlot()),							current_plot,	SLOT(clearAll()));
@@ -126,6 +167,13 @@ void PlotWindow::switchPlot()
 		connect(current_panel,	SIGNAL(plotNameChange(QString)),				current_plot,	SLOT(changePlotName(QString)));
 		connect(current_panel,	SIGNAL(labelsChange(QString, QString)),			current_plot,	SLOT(changePlotLabels(QString, QString)));
 		connect(current_panel,	SIGNAL(gridChange(int)),						current_plot,	SLOT(changeGridState(int)));
+		connect(current_panel,	SIGNAL(bootstrapRequested(int)),				current_plot,	SLOT(bootstrapCurve(int)));
+		connect(current_panel,	SIGNAL(significanceRequested()),				current_plot,	SLOT(compareCurves()));
+		connect(current_panel,	SIGNAL(followRequested(int, bool)),				current_plot,	SLOT(followCurve(int, bool)));
+		connect(current_panel,	SIGNAL(hullsChanged(bool, double)),			current_plot,	SLOT(setHullOverlay(bool, double)));
+		connect(current_panel,	SIGNAL(averageAdd(int)),						current_plot,	SLOT(addToAverage(int)));
+		connect(current_panel,	SIGNAL(averageRemove(int)),						current_plot,	SLOT(removeFromAverage(int)));
+		connect(current_panel,	SIGNAL(averageModeChange(int, int)),			current_plot,	SLOT(setAverageMode(int, int)));
 
 		///activate signal sent from PlotWindow to Plot
 		connect(clearAction,	SIGNAL(triggered()),							current_plot,	SLOT(clearAll()));
@@ -134,47 +182,308 @@ void PlotWindow::switchPlot()
 }
 
 /**
-* Plot class open slot is called when open button was clicked
+* Plot class open slot is called when open button was clicked.
+* Several files can be chosen at once, they are routed to plots by extension.
+* Score files and score sketches give a curve on both plots.
 */
 void PlotWindow::open()
 {
 	///display open file window
-	QString fileName = QFileDialog::getOpenFileName(this,
-	 	tr("Open File"), QDir::currentPath(), tr("ROC files (*.roc);;PR files (*.pr);;all files (*.*)"));
+	QStringList fileNames = QFileDialog::getOpenFileNames(this,
+	 	tr("Open Files"), QDir::currentPath(), tr("ROC files (*.roc *.rocb);;PR files (*.pr *.prb);;Score files (*.scores *.sketch *.shards);;all files (*.*)"));
 
-	if (fileName.isEmpty()){
+	if (fileNames.isEmpty()){
 		return;
 	}
 
-	QStringList field = fileName.split(".", QString::SkipEmptyParts);
-	
-	QStringList::const_iterator constIterator;
-    constIterator = --field.constEnd();
-    
-	///check file format, if roc or pr - load data
-	try {
-		if (constIterator->compare("roc",Qt::CaseInsensitive)==0){
-			roc_plot->addCurve(fileName, 0);
+	QStringList rocFiles, prFiles, unknownFiles;
+	QStringList::const_iterator it;
+	for (it = fileNames.constBegin(); it != fileNames.constEnd(); ++it){
+		QString extension = QFileInfo(*it).suffix();
+
+		///check file format, if roc or pr (text or binary) - load data
+		if (extension.compare("roc",Qt::CaseInsensitive)==0 || extension.compare("rocb",Qt::CaseInsensitive)==0){
+			rocFiles.append(*it);
+		}
+		else if (extension.compare("pr",Qt::CaseInsensitive)==0 || extension.compare("prb",Qt::CaseInsensitive)==0){ 
+			prFiles.append(*it);
+		}
+		else if (ScoreSet::isScoreFile(*it) || ScoreSketch::isSketchFile(*it)){
+			rocFiles.append(ScoreSet::curvePath(*it, ScoreSet::ROC_CURVE));
+			prFiles.append(ScoreSet::curvePath(*it, ScoreSet::PR_CURVE));
+		}
+		else {
+			unknownFiles.append(*it);
+		}
+	}
+
+	if (!rocFiles.isEmpty()){
+		roc_plot->addCurves(rocFiles);
+	}
+	if (!prFiles.isEmpty()){
+		pr_plot->addCurves(prFiles);
+	}
+	if (!unknownFiles.isEmpty()){
+		reportError(unknownFiles.join(", "), 1000);
+	}
+}
+
+/**
+* Plot class reportError slot collects a message for an error code
+* raised while opening or loading a file. Cancelled loadings are not reported.
+* Messages are shown together by showFailures once no file is loading.
+* @param _path path of the file
+* @param e error code
+*/
+void PlotWindow::reportError(QString _path, int e)
+{
+	if (e==1004)
+		return;
+
+	failures.append(_path + ": " + ErrorCodes::message(e));
+
+	///errors reported together, e.g. by a loop over files, are shown once the event loop gets back
+	if (progressWidgets.isEmpty()) {
+		QTimer::singleShot(0, this, SLOT(showFailures()));
+	}
+}
+
+/**
+* Plot class showFailures slot shows all collected error messages in one non-modal
+* dialog and their number in the status bar
+*/
+void PlotWindow::showFailures()
+{
+	if (failures.isEmpty()) {
+		return;
+	}
+	statusBar()->showMessage(tr("%1 file(s) failed").arg(failures.size()), 5000);
+	errorDialog->showMessage(failures.join("\n"));
+	failures.clear();
+}
+
+/**
+* Plot class convert slot is called when convert action was chosen.
+* Chosen text curve files are converted into the binary format, which is written
+* next to them with "b" appended to the extension (.roc to .rocb, .pr to .prb).
+*/
+void PlotWindow::convert()
+{
+	QStringList fileNames = QFileDialog::getOpenFileNames(this,
+		tr("Convert to binary"), QDir::currentPath(), tr("Curve files (*.roc *.pr);;all files (*.*)"));
+
+	if (fileNames.isEmpty()){
+		return;
+	}
+
+	QStringList precisions;
+	precisions << tr("Double precision") << tr("Single precision");
+	bool ok;
+	QString precision = QInputDialog::getItem(this, tr("Convert to binary"), tr("Sample precision:"), precisions, 0, false, &ok);
+	if (!ok){
+		return;
+	}
+	bool floatSamples = (precision == precisions[1]);
+
+	QApplication::setOverrideCursor(Qt::WaitCursor);
+	QStringList::const_iterator it;
+	for (it = fileNames.constBegin(); it != fileNames.constEnd(); ++it){
+		try {
+			BinaryCurveFile::convert(*it, *it + "b", floatSamples);
 		}
-		else if (constIterator->compare("pr",Qt::CaseInsensitive)==0){ 
-			pr_plot->addCurve(fileName, 1);
+		catch(int e){
+			QApplication::restoreOverrideCursor();
+			reportError(*it, e);
+			QApplication::setOverrideCursor(Qt::WaitCursor);
+		}
+	}
+	QApplication::restoreOverrideCursor();
+	statusBar()->showMessage(tr("Converted %1 file(s)").arg(fileNames.size()), 2000);
+}
+
+/**
+* Plot class buildSketch slot is called when sketch action was chosen.
+* Chosen score files are added to one score sketch and chosen sketches are merged into it.
+* Bins are taken from the first chosen sketch, or asked for if only score files were chosen.
+* The files are read in a worker thread, with progress and a cancel button in the status bar.
+* The sketch is saved to a chosen file and its curves are added to both plots by sketchBuilt.
+*/
+void PlotWindow::buildSketch()
+{
+	QStringList fileNames = QFileDialog::getOpenFileNames(this,
+		tr("Build sketch"), QDir::currentPath(), tr("Score files (*.scores *.sketch);;all files (*.*)"));
+
+	if (fileNames.isEmpty()){
+		return;
+	}
+
+	QStringList scoreFiles, sketchFiles;
+	QStringList::const_iterator it;
+	for (it = fileNames.constBegin(); it != fileNames.constEnd(); ++it){
+		if (ScoreSketch::isSketchFile(*it)){
+			sketchFiles.append(*it);
 		}
 		else {
-			throw 1000;
+			scoreFiles.append(*it);
+		}
+	}
+
+	ScoreSketch sketch;
+	bool ok;
+	if (sketchFiles.isEmpty()){
+		double low = QInputDialog::getDouble(this, tr("Build sketch"), tr("Lowest score:"), 0.0, -1e9, 1e9, 6, &ok);
+		if (!ok){
+			return;
 		}
+		double high = QInputDialog::getDouble(this, tr("Build sketch"), tr("Highest score:"), 1.0, low, 1e9, 6, &ok);
+		if (!ok){
+			return;
+		}
+		int bins = QInputDialog::getInt(this, tr("Build sketch"), tr("Number of bins:"),
+			ScoreSketch::DEFAULT_BINS, 1, ScoreSketch::MAX_BINS, 1024, &ok);
+		if (!ok){
+			return;
+		}
+		sketch = ScoreSketch(low, high, bins);
+	}
+
+	QString target = QFileDialog::getSaveFileName(this, tr("Save sketch"), QDir::currentPath(), tr("Sketch files (*.sketch)"));
+	if (target.isEmpty()){
+		return;
+	}
+	if (!ScoreSketch::isSketchFile(target)){
+		target += ".sketch";
 	}
-	catch(int e){
-		QErrorMessage errorMessage;
-		if (e==1000)
-			errorMessage.showMessage("error. unknown file extension");
-		else if (e==1001)
-			errorMessage.showMessage("error parsing the file. unsupported structure of file");
-		else if (e==1002)
-			errorMessage.showMessage("error parsing the file. data conversion failed");
-		else if (e==1003)
-			errorMessage.showMessage("error parsing the file. to little data points");
-		errorMessage.exec();
+	if (sketchBuilders.contains(target)){
+		return;
 	}
+
+	SketchBuilder *builder = new SketchBuilder(sketch, sketchFiles, scoreFiles, target);
+	connect(builder, SIGNAL(progressChanged(QString, int)), this, SLOT(loadProgress(QString, int)));
+	connect(builder, SIGNAL(built()), this, SLOT(sketchBuilt()));
+	connect(builder, SIGNAL(failed(QString, int)), this, SLOT(sketchFailed(QString, int)));
+	sketchBuilders.insert(target, builder);
+	loadStarted(target);
+	QThreadPool::globalInstance()->start(builder);
+}
+
+/**
+* Plot class sketchBuilt slot is called when a worker thread saved a sketch.
+* Curves of the sketch are added to both plots.
+*/
+void PlotWindow::sketchBuilt()
+{
+	SketchBuilder *builder = qobject_cast<SketchBuilder*>(sender());
+	if (!builder){
+		return;
+	}
+	QString target = builder->getTarget();
+	sketchBuilders.remove(target);
+	builder->deleteLater();
+	loadFinished(target);
+
+	const ScoreSketch &sketch = builder->getSketch();
+	statusBar()->showMessage(tr("Sketch of %1 examples, AUC error at most %2")
+		.arg(sketch.getExamples()).arg(sketch.aucErrorBound()), 5000);
+	roc_plot->addCurves(QStringList(ScoreSet::curvePath(target, ScoreSet::ROC_CURVE)));
+	pr_plot->addCurves(QStringList(ScoreSet::curvePath(target, ScoreSet::PR_CURVE)));
+}
+
+/**
+* Plot class sketchFailed slot is called when a worker thread failed to build a sketch
+* or the building was cancelled
+* @param _path path of the file which could not be processed
+* @param e error code
+*/
+void PlotWindow::sketchFailed(QString _path, int e)
+{
+	SketchBuilder *builder = qobject_cast<SketchBuilder*>(sender());
+	if (!builder){
+		return;
+	}
+	sketchBuilders.remove(builder->getTarget());
+	builder->deleteLater();
+	loadFinished(builder->getTarget());
+	reportError(_path, e);
+}
+
+/**
+* Plot class setCacheBudget slot is called when cache budget action was chosen.
+* It asks for the memory budget of the curve cache and stores it in settings.
+*/
+void PlotWindow::setCacheBudget()
+{
+	int current = int(CurveCache::instance()->getBudget() / (1024 * 1024));
+	bool ok;
+	int budget = QInputDialog::getInt(this, tr("Cache budget"),
+		tr("Memory for curve data in MB (in use: %1 MB):").arg(CurveCache::instance()->memoryUsage() / (1024 * 1024)),
+		current, 0, 1024 * 1024, 64, &ok);
+	if (!ok){
+		return;
+	}
+
+	CurveCache::instance()->setBudget(qint64(budget) * 1024 * 1024);
+	QSettings settings("projekt-zpr", "projekt-zpr");
+	settings.setValue("cacheBudget", budget);
+}
+
+/**
+* Plot class setStorageMode slot is called when storage action was chosen.
+* It asks for the precision in which points of loaded text files are kept
+* and stores it in settings. The largest error of every mode is shown
+* for curves inside the unit square, which holds all ROC and PR curves.
+*/
+void PlotWindow::setStorageMode()
+{
+	static const int bytes[] = { 16, 8, 4, 8 };
+	QStringList modes;
+	for (int m = QuantizedPoints::DoublePrecision; m <= QuantizedPoints::Fixed32; m++){
+		QuantizedPoints::Mode mode = QuantizedPoints::Mode(m);
+		modes << tr("%1 (%2 B/point, max error %3)").arg(QuantizedPoints::modeName(mode)).arg(bytes[m])
+			.arg(QuantizedPoints::errorBound(mode, QRectF(0.0, 0.0, 1.0, 1.0)));
+	}
+
+	bool ok;
+	QString chosen = QInputDialog::getItem(this, tr("Point storage"), tr("Keep points of loaded files in:"),
+		modes, int(CurveData::getStorageMode()), false, &ok);
+	if (!ok){
+		return;
+	}
+
+	int mode = modes.indexOf(chosen);
+	CurveData::setStorageMode(QuantizedPoints::Mode(mode));
+	QSettings settings("projekt-zpr", "projekt-zpr");
+	settings.setValue("storageMode", mode);
+}
+
+/**
+* Plot class setScoreBudget slot is called when score budget action was chosen.
+* It asks for the memory used when loading score files and stores it in settings.
+*/
+void PlotWindow::setScoreBudget()
+{
+	int current = int(ScoreSet::getMemoryBudget() / (1024 * 1024));
+	bool ok;
+	int budget = QInputDialog::getInt(this, tr("Score file memory"),
+		tr("Memory for loading score files in MB (larger files are sorted on disk):"),
+		current, 16, 1024 * 1024, 64, &ok);
+	if (!ok){
+		return;
+	}
+
+	ScoreSet::setMemoryBudget(qint64(budget) * 1024 * 1024);
+	QSettings settings("projekt-zpr", "projekt-zpr");
+	settings.setValue("scoreBudget", budget);
+}
+
+/**
+* Plot class showReport slot displays a message about a loaded file in the status bar
+* @param _path path of the file
+* @param _message message to be displayed
+*/
+void PlotWindow::showReport(QString _path, QString _message)
+{
+	statusBar()->showMessage(QString("%1: %2").arg(QFileInfo(_path).fileName()).arg(_message), 5000);
 }
 
 /**
@@ -183,7 +492,11 @@ void PlotWindow::open()
 void PlotWindow::about()
 {	
 	QMessageBox::about(this, tr("About program"), 
-		tr("Program enables loading curves from files with .roc and .pr extensions."));
+		tr("Program enables loading curves from files with .roc and .pr extensions "
+		   "and from their binary versions (.rocb and .prb). "
+		   "Both curves can also be computed from raw classifier scores (.scores) "
+		   "or from their mergeable histograms (.sketch). Sorted score shards and aggregates (.agg) "
+		   "listed in a manifest (.shards) are merged into one exact curve."));
 }
 
 /**
@@ -195,9 +508,19 @@ void PlotWindow::createActions()
 	///create openAction, load an icon, and connect it to slot open()
 	openAction = new QAction(QIcon("images/open.png"), tr("&Open..."), this);
 	openAction->setShortcuts(QKeySequence::Open);
-	openAction->setStatusTip(tr("Open an existing file"));
+	openAction->setStatusTip(tr("Open existing files"));
 	connect(openAction, SIGNAL(triggered()), this, SLOT(open()));
 
+	///create convertAction and connect it to slot convert()
+	convertAction = new QAction(tr("&Convert to binary..."), this);
+	convertAction->setStatusTip(tr("Convert text curve files into the binary format"));
+	connect(convertAction, SIGNAL(triggered()), this, SLOT(convert()));
+
+	///create sketchAction and connect it to slot buildSketch()
+	sketchAction = new QAction(tr("Build &sketch..."), this);
+	sketchAction->setStatusTip(tr("Summarize score files in a score sketch, or merge sketches"));
+	connect(sketchAction, SIGNAL(triggered()), this, SLOT(buildSketch()));
+
 	///create exitAction, load an icon, and connect it to slot close()
 	exitAction = new QAction(tr("E&xit"), this);
 	exitAction->setShortcuts(QKeySequence::Quit);
@@ -226,6 +549,21 @@ void PlotWindow::createActions()
 	clearAction = new QAction(QIcon("images/clear.png"), tr("Clear"), this);
 	clearAction->setStatusTip(tr("Clear plot"));
 
+	///create cacheAction and connect it to slot setCacheBudget()
+	cacheAction = new QAction(tr("Cache &budget..."), this);
+	cacheAction->setStatusTip(tr("Set memory kept for curves which are not displayed"));
+	connect(cacheAction, SIGNAL(triggered()), this, SLOT(setCacheBudget()));
+
+	///create storageAction and connect it to slot setStorageMode()
+	storageAction = new QAction(tr("Point &storage..."), this);
+	storageAction->setStatusTip(tr("Set precision in which points of loaded files are kept"));
+	connect(storageAction, SIGNAL(triggered()), this, SLOT(setStorageMode()));
+
+	///create scoreBudgetAction and connect it to slot setScoreBudget()
+	scoreBudgetAction = new QAction(tr("Score file &memory..."), this);
+	scoreBudgetAction->setStatusTip(tr("Set memory used when loading score files"));
+	connect(scoreBudgetAction, SIGNAL(triggered()), this, SLOT(setScoreBudget()));
+
 	///create aboutAction, load an icon, and connect it to slot about()
 	aboutAct = new QAction(tr("&About"), this);
 	aboutAct->setStatusTip(tr("Show the application's About box"));
@@ -240,6 +578,8 @@ void PlotWindow::createMenus()
 	///create file menu on menu bar
     fileMenu = menuBar()->addMenu(tr("&File"));
     fileMenu->addAction(openAction);
+    fileMenu->addAction(convertAction);
+    fileMenu->addAction(sketchAction);
 
 #ifndef QT_NO_PRINTER
     fileMenu->addAction(printAction);
@@ -255,6 +595,10 @@ void PlotWindow::createMenus()
     plotMenu = menuBar()->addMenu(tr("&Plot"));
 	plotMenu->addAction(switchAction);
 	plotMenu->addAction(clearAction);
+	plotMenu->addSeparator();
+	plotMenu->addAction(cacheAction);
+	plotMenu->addAction(storageAction);
+	plotMenu->addAction(scoreBudgetAction);
 
 	///create help menu on menu bar
     helpMenu = menuBar()->addMenu(tr("&Help"));
@@ -289,6 +633,94 @@ void PlotWindow::createToolBars()
 void PlotWindow::createStatusBar()
 {
 	statusBar()->showMessage(tr("Ready"));
+
+	///cancel buttons of loaded files are mapped to file paths
+	cancelMapper = new QSignalMapper(this);
+	connect(cancelMapper, SIGNAL(mapped(QString)), this, SLOT(cancelLoad(QString)));
+
+	///errors of a batch of files are reported together, without blocking the loading
+	errorDialog = new QErrorMessage(this);
+	errorDialog->setWindowModality(Qt::NonModal);
+}
+
+/**
+* Plot class loadStarted slot adds a progress indicator with a cancel button
+* for a file which started loading to the status bar.
+* @param _path path of the file
+*/
+void PlotWindow::loadStarted(QString _path)
+{
+	QWidget *indicator = new QWidget(statusBar());
+	QHBoxLayout *layout = new QHBoxLayout(indicator);
+	layout->setContentsMargins(0, 0, 0, 0);
+
+	QLabel *label = new QLabel(QFileInfo(_path).fileName(), indicator);
+	QProgressBar *bar = new QProgressBar(indicator);
+	bar->setRange(0, 100);
+	bar->setValue(0);
+	bar->setMaximumWidth(120);
+	QToolButton *cancelButton = new QToolButton(indicator);
+	cancelButton->setText("x");
+	cancelButton->setToolTip(tr("Cancel loading"));
+	cancelButton->setAutoRaise(true);
+
+	layout->addWidget(label);
+	layout->addWidget(bar);
+	layout->addWidget(cancelButton);
+
+	connect(cancelButton, SIGNAL(clicked()), cancelMapper, SLOT(map()));
+	cancelMapper->setMapping(cancelButton, _path);
+
+	statusBar()->addPermanentWidget(indicator);
+	progressWidgets.insert(_path, indicator);
+	progressBars.insert(_path, bar);
+	statusBar()->showMessage(tr("Loading..."));
+}
+
+/**
+* Plot class loadProgress slot updates the progress indicator of a file
+* @param _path path of the file
+* @param _percent loaded part of the file
+*/
+void PlotWindow::loadProgress(QString _path, int _percent)
+{
+	QProgressBar *bar = progressBars.value(_path);
+	if (bar) {
+		bar->setValue(_percent);
+	}
+}
+
+/**
+* Plot class loadFinished slot removes the progress indicator of a file
+* which was loaded, failed or was cancelled.
+* @param _path path of the file
+*/
+void PlotWindow::loadFinished(QString _path)
+{
+	QWidget *indicator = progressWidgets.take(_path);
+	progressBars.remove(_path);
+	if (indicator) {
+		statusBar()->removeWidget(indicator);
+		indicator->deleteLater();
+	}
+	if (progressWidgets.isEmpty()) {
+		statusBar()->showMessage(tr("Ready"));
+		showFailures();
+	}
+}
+
+/**
+* Plot class cancelLoad slot is called when cancel button of a loaded file was clicked
+* @param _path path of the file
+*/
+void PlotWindow::cancelLoad(QString _path)
+{
+	roc_plot->cancelLoad(_path);
+	pr_plot->cancelLoad(_path);
+	SketchBuilder *builder = sketchBuilders.value(_path);
+	if (builder){
+		builder->cancel();
+	}
 }
 
 #ifndef QT_NO_PRINTER
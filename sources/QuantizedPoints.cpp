@@ -0,0 +1,234 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/QuantizedPoints.h"
+#include <cmath>
+
+/**
+ * Scales a value into fixed point steps. Rounding to the nearest step
+ * keeps the order of values, so monotone curves stay monotone.
+ * @param _value value to be encoded
+ * @param _origin lowest value of the range
+ * @param _step size of one step, 0 for a range holding a single value
+ * @param _maximum highest code
+ * @return code of the value
+ */
+static quint32 toFixed(double _value, double _origin, double _step, double _maximum)
+{
+	if (_step <= 0.0) {
+		return 0;
+	}
+	double code = std::floor((_value - _origin) / _step + 0.5);
+	if (code < 0.0) {
+		code = 0.0;
+	}
+	if (code > _maximum) {
+		code = _maximum;
+	}
+	return quint32(code);
+}
+
+/**
+ * Constructor of QuantizedPoints class, points are kept in double precision until encoded
+ */
+QuantizedPoints::QuantizedPoints():
+	mode(DoublePrecision), count(0), xOrigin(0.0), xStep(0.0), yOrigin(0.0), yStep(0.0), maxError(0.0)
+{
+}
+
+/**
+ * Encodes points and measures the largest difference between a point and its decoded value
+ * @param _points points of a curve in full precision
+ * @param _rect bounding rect of the points, fixed point codes are spread over it
+ * @param _mode precision of the stored points, DoublePrecision stores nothing
+ */
+void QuantizedPoints::encode(const QVector<QPointF> &_points, const QRectF &_rect, Mode _mode)
+{
+	mode = _mode;
+	count = _points.size();
+	xOrigin = _rect.left();
+	yOrigin = _rect.top();
+	xStep = yStep = 0.0;
+	maxError = 0.0;
+
+	int n = _points.size();
+	if (mode == SinglePrecision) {
+		xFloats.resize(n);
+		yFloats.resize(n);
+		for (int i = 0; i < n; i++) {
+			xFloats[i] = float(_points[i].x());
+			yFloats[i] = float(_points[i].y());
+		}
+	}
+	else if (mode == Fixed16 || mode == Fixed32) {
+		double maximum = (mode == Fixed16) ? 65535.0 : 4294967295.0;
+		xStep = _rect.width() / maximum;
+		yStep = _rect.height() / maximum;
+		if (mode == Fixed16) {
+			xFixed16.resize(n);
+			yFixed16.resize(n);
+			for (int i = 0; i < n; i++) {
+				xFixed16[i] = quint16(toFixed(_points[i].x(), xOrigin, xStep, maximum));
+				yFixed16[i] = quint16(toFixed(_points[i].y(), yOrigin, yStep, maximum));
+			}
+		}
+		else {
+			xFixed32.resize(n);
+			yFixed32.resize(n);
+			for (int i = 0; i < n; i++) {
+				xFixed32[i] = toFixed(_points[i].x(), xOrigin, xStep, maximum);
+				yFixed32[i] = toFixed(_points[i].y(), yOrigin, yStep, maximum);
+			}
+		}
+	}
+
+	for (int i = 0; i < n && mode != DoublePrecision; i++) {
+		QPointF decoded = sample(i);
+		maxError = qMax(maxError, qMax(std::fabs(decoded.x() - _points[i].x()), std::fabs(decoded.y() - _points[i].y())));
+	}
+}
+
+/**
+ * Decodes i-th point
+ * @param i which point to return
+ * @return i-th point
+ */
+QPointF QuantizedPoints::sample(size_t i) const
+{
+	switch (mode) {
+	case SinglePrecision:
+		return QPointF(xFloats[i], yFloats[i]);
+	case Fixed16:
+		return QPointF(xOrigin + xFixed16[i] * xStep, yOrigin + yFixed16[i] * yStep);
+	case Fixed32:
+		return QPointF(xOrigin + xFixed32[i] * xStep, yOrigin + yFixed32[i] * yStep);
+	default:
+		return QPointF();
+	}
+}
+
+/**
+ * @return number of encoded points
+ */
+size_t QuantizedPoints::size() const
+{
+	return count;
+}
+
+/**
+ * @return precision of the stored points
+ */
+QuantizedPoints::Mode QuantizedPoints::getMode() const
+{
+	return mode;
+}
+
+/**
+ * @return largest difference between a coordinate and its decoded value
+ */
+double QuantizedPoints::getMaxError() const
+{
+	return maxError;
+}
+
+/**
+ * @return memory taken by the encoded points in bytes
+ */
+qint64 QuantizedPoints::memoryUsage() const
+{
+	return qint64(xFloats.capacity() + yFloats.capacity()) * sizeof(float)
+		+ qint64(xFixed16.capacity() + yFixed16.capacity()) * sizeof(quint16)
+		+ qint64(xFixed32.capacity() + yFixed32.capacity()) * sizeof(quint32);
+}
+
+/**
+ * Computes the largest error a mode can introduce for points inside a rect.
+ * Fixed point values are rounded to the nearest of the steps spread over the rect,
+ * floats are rounded to 24 significant bits.
+ * @param _mode precision of stored points
+ * @param _rect bounding rect of the points
+ * @return upper bound of the difference between a coordinate and its decoded value
+ */
+double QuantizedPoints::errorBound(Mode _mode, const QRectF &_rect)
+{
+	switch (_mode) {
+	case SinglePrecision: {
+		double magnitude = qMax(qMax(std::fabs(_rect.left()), std::fabs(_rect.right())),
+			qMax(std::fabs(_rect.top()), std::fabs(_rect.bottom())));
+		return magnitude * std::ldexp(1.0, -24);
+	}
+	case Fixed16:
+		return qMax(_rect.width(), _rect.height()) / 65535.0 / 2;
+	case Fixed32:
+		return qMax(_rect.width(), _rect.height()) / 4294967295.0 / 2;
+	default:
+		return 0.0;
+	}
+}
+
+/**
+ * @param _mode precision of stored points
+ * @return name of the mode displayed to the user
+ */
+QString QuantizedPoints::modeName(Mode _mode)
+{
+	switch (_mode) {
+	case SinglePrecision:
+		return "single precision";
+	case Fixed16:
+		return "16 bit fixed point";
+	case Fixed32:
+		return "32 bit fixed point";
+	default:
+		return "double precision";
+	}
+}
+
+/**
+ * Constructor of QuantizedFunctionData class
+ * @param _points encoded points, they have to outlive this object
+ * @param _rect bounding rect of the points
+ * @param _monotone true if x values of the points do not decrease
+ */
+QuantizedFunctionData::QuantizedFunctionData(const QuantizedPoints *_points, QRectF _rect, bool _monotone):
+	FunctionData(0, _rect, _monotone), points(_points)
+{
+}
+
+/**
+ * Return i-th sample decoded from the compact storage
+ * @param i which sample to return
+ * @return i-th sample
+ */
+QPointF QuantizedFunctionData::sample(size_t i) const
+{
+	return points->sample(i);
+}
+
+/**
+ * @return number of encoded samples
+ */
+size_t QuantizedFunctionData::size() const
+{
+	return points->size();
+}
@@ -0,0 +1,177 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/RadixSort.h"
+#include <QVector>
+#include <QThread>
+#include <QtConcurrentMap>
+#include <cstring>
+
+/**
+ * Part of the keys processed by one thread in one pass
+ */
+struct RadixPart {
+	const float *source;
+	const quint32 *keys;
+	const quint32 *values;
+	quint32 *keysOut;
+	quint32 *valuesOut;
+	quint32 begin;
+	quint32 end;
+	int shift;
+	QVector<quint32> counts;
+};
+
+/**
+ * Converts float keys of a part into sortable integers and numbers the values
+ * @param _part part of the keys
+ */
+static void prepareKeys(RadixPart &_part)
+{
+	for (quint32 i = _part.begin; i < _part.end; i++) {
+		_part.keysOut[i] = RadixSort::descendingKey(_part.source[i]);
+		_part.valuesOut[i] = i;
+	}
+}
+
+/**
+ * Counts digits of the current pass in a part
+ * @param _part part of the keys
+ */
+static void countDigits(RadixPart &_part)
+{
+	_part.counts.fill(0, RadixSort::BUCKETS);
+	quint32 *counts = _part.counts.data();
+	for (quint32 i = _part.begin; i < _part.end; i++) {
+		counts[(_part.keys[i] >> _part.shift) & (RadixSort::BUCKETS - 1)]++;
+	}
+}
+
+/**
+ * Moves keys and values of a part to their places. Counts of the part
+ * have to be replaced by its first output position of every digit.
+ * @param _part part of the keys
+ */
+static void scatterDigits(RadixPart &_part)
+{
+	quint32 *offsets = _part.counts.data();
+	for (quint32 i = _part.begin; i < _part.end; i++) {
+		quint32 key = _part.keys[i];
+		quint32 position = offsets[(key >> _part.shift) & (RadixSort::BUCKETS - 1)]++;
+		_part.keysOut[position] = key;
+		_part.valuesOut[position] = _part.values[i];
+	}
+}
+
+/**
+ * Maps a float to an integer, whose ascending order is the descending order of floats.
+ * Negative and positive zero are the same key.
+ * @param _key float key, must not be NaN
+ * @return sortable integer
+ */
+quint32 RadixSort::descendingKey(float _key)
+{
+	_key += 0.0f;
+	quint32 bits;
+	memcpy(&bits, &_key, sizeof(bits));
+	bits = (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+	return ~bits;
+}
+
+/**
+ * Sorts indices of keys by descending key. Keys which are equal keep their original order.
+ * Safe to call from a thread of the global thread pool, QtConcurrent lends the calling
+ * thread to the pool while it waits.
+ * @param _keys keys to be sorted, they are not modified
+ * @param _count number of keys
+ * @param _order receives _count indices of keys in sorted order
+ * @param _threads number of parts processed in parallel, 0 for the number of processor cores
+ */
+void RadixSort::sortDescending(const float *_keys, quint32 _count, quint32 *_order, int _threads)
+{
+	if (_count == 0) {
+		return;
+	}
+	if (_threads <= 0) {
+		_threads = QThread::idealThreadCount();
+	}
+	///small inputs are not worth splitting
+	quint32 minimumPart = 1 << 16;
+	int parts = int(qMin(quint32(qMax(_threads, 1)), (_count + minimumPart - 1) / minimumPart));
+
+	QVector<quint32> keys(_count), keysOut(_count), valuesOut(_count);
+	quint32 *keyBuffers[2] = { keys.data(), keysOut.data() };
+	quint32 *valueBuffers[2] = { _order, valuesOut.data() };
+
+	QVector<RadixPart> work(parts);
+	quint32 partSize = (_count + parts - 1) / parts;
+	for (int p = 0; p < parts; p++) {
+		work[p].source = _keys;
+		work[p].begin = qMin(_count, quint32(p) * partSize);
+		work[p].end = qMin(_count, work[p].begin + partSize);
+		work[p].keysOut = keyBuffers[0];
+		work[p].valuesOut = valueBuffers[0];
+	}
+	QtConcurrent::blockingMap(work, prepareKeys);
+
+	int current = 0;
+	for (int shift = 0; shift < 32; shift += DIGIT_BITS) {
+		for (int p = 0; p < parts; p++) {
+			work[p].keys = keyBuffers[current];
+			work[p].values = valueBuffers[current];
+			work[p].keysOut = keyBuffers[1 - current];
+			work[p].valuesOut = valueBuffers[1 - current];
+			work[p].shift = shift;
+		}
+		QtConcurrent::blockingMap(work, countDigits);
+
+		///a pass in which all keys share the digit does not change the order
+		bool trivial = false;
+		for (int d = 0; d < BUCKETS && !trivial; d++) {
+			quint32 total = 0;
+			for (int p = 0; p < parts; p++) {
+				total += work[p].counts[d];
+			}
+			trivial = (total == _count);
+		}
+		if (trivial) {
+			continue;
+		}
+
+		///digit d of part p goes after all smaller digits and after digit d of previous parts
+		quint32 position = 0;
+		for (int d = 0; d < BUCKETS; d++) {
+			for (int p = 0; p < parts; p++) {
+				quint32 count = work[p].counts[d];
+				work[p].counts[d] = position;
+				position += count;
+			}
+		}
+		QtConcurrent::blockingMap(work, scatterDigits);
+		current = 1 - current;
+	}
+
+	if (current != 0) {
+		memcpy(_order, valueBuffers[current], sizeof(quint32) * _count);
+	}
+}
@@ -0,0 +1,197 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+#include "../headers/RocHull.h"
+#include <queue>
+#include <vector>
+#include <algorithm>
+
+/**
+ * Next vertex of one hull in the sweep uniting hulls, ordered so that a priority queue
+ * gives the leftmost vertex first, the lower one of equal false positive rates first
+ */
+struct HullHead {
+	QPointF point;
+	int hull;
+	int index;
+
+	bool operator<(const HullHead &_other) const {
+		if (point.x() != _other.point.x()) {
+			return point.x() > _other.point.x();
+		}
+		return point.y() > _other.point.y();
+	}
+};
+
+/**
+ * Compares points by false positive rate, then by true positive rate
+ */
+static bool pointLess(const QPointF &_a, const QPointF &_b)
+{
+	return _a.x() < _b.x() || (_a.x() == _b.x() && _a.y() < _b.y());
+}
+
+/**
+ * Builds the ROC convex hull of a curve. The hull starts at (0,0) and ends at (1,1),
+ * the points of trivial classifiers. Points are expected in order of false positive rate,
+ * as curves are loaded; other curves are sorted first.
+ * @param _points points of the curve
+ * @param _count number of points
+ * @return vertices of the hull from left to right
+ */
+QVector<QPointF> RocHull::hull(const QPointF *_points, size_t _count)
+{
+	QVector<QPointF> points;
+	points.reserve(int(_count) + 2);
+	points.append(QPointF(0.0, 0.0));
+	bool sorted = true;
+	for (size_t i = 0; i < _count; i++) {
+		sorted = sorted && !pointLess(_points[i], points.last());
+		points.append(_points[i]);
+	}
+	points.append(QPointF(1.0, 1.0));
+	if (!sorted) {
+		std::sort(points.begin(), points.end(), pointLess);
+	}
+
+	QVector<QPointF> result;
+	chain(points.constData(), 0, points.size(), result, 0);
+	return result;
+}
+
+/**
+ * Unites hulls of many curves into the hull of all their points. Vertices of the hulls
+ * are merged in order of false positive rate by a sweep, which keeps the union linear
+ * in the number of vertices but for the logarithm of the number of hulls.
+ * @param _hulls hulls built by hull method
+ * @param _owners receives, for every vertex of the union, the index of the hull it comes from
+ * @return vertices of the united hull from left to right, empty if there are no hulls
+ */
+QVector<QPointF> RocHull::unite(const QList<QVector<QPointF> > &_hulls, QVector<int> *_owners)
+{
+	int total = 0;
+	std::priority_queue<HullHead> heads;
+	for (int h = 0; h < _hulls.size(); h++) {
+		total += _hulls[h].size();
+		if (!_hulls[h].isEmpty()) {
+			HullHead head = { _hulls[h][0], h, 0 };
+			heads.push(head);
+		}
+	}
+
+	QVector<QPointF> points;
+	QVector<int> owners;
+	points.reserve(total);
+	owners.reserve(total);
+	while (!heads.empty()) {
+		HullHead head = heads.top();
+		heads.pop();
+		points.append(head.point);
+		owners.append(head.hull);
+		if (++head.index < _hulls[head.hull].size()) {
+			head.point = _hulls[head.hull][head.index];
+			heads.push(head);
+		}
+	}
+
+	QVector<QPointF> result;
+	chain(points.constData(), owners.constData(), points.size(), result, _owners);
+	return result;
+}
+
+/**
+ * Finds the vertex of a hull which is optimal for iso-performance lines of the given slope,
+ * that is where the edges turn from steeper to flatter than the lines. Slopes of hull edges
+ * decrease from left to right, so the vertex is found by binary search.
+ * @param _hull vertices of a hull
+ * @param _slope slope of iso-performance lines, cost of a false positive times the number
+ * of negative examples over cost of a false negative times the number of positive examples
+ * @return index of the vertex, -1 for an empty hull
+ */
+int RocHull::optimalVertex(const QVector<QPointF> &_hull, double _slope)
+{
+	int low = 0, high = _hull.size() - 1;
+	while (low < high) {
+		int middle = (low + high) / 2;
+		QPointF edge = _hull[middle + 1] - _hull[middle];
+		///edge flatter than the line, the optimum is at its left end or before
+		if (edge.y() <= _slope * edge.x()) {
+			high = middle;
+		}
+		else {
+			low = middle + 1;
+		}
+	}
+	return _hull.isEmpty() ? -1 : low;
+}
+
+/**
+ * Clips the iso-performance line through a point to the ROC space
+ * @param _point point of the line
+ * @param _slope slope of the line, must be positive
+ * @return part of the line inside the unit square
+ */
+QLineF RocHull::isoPerformanceLine(QPointF _point, double _slope)
+{
+	double from = qMax(0.0, _point.x() - _point.y() / _slope);
+	double to = qMin(1.0, _point.x() + (1.0 - _point.y()) / _slope);
+	return QLineF(from, _point.y() + _slope * (from - _point.x()),
+		to, _point.y() + _slope * (to - _point.x()));
+}
+
+/**
+ * Monotone chain of the upper hull of points sorted by false positive rate, then by true
+ * positive rate. Vertices lying on a hull edge are left out.
+ * @param _points sorted points
+ * @param _owners hull of every point, may be NULL
+ * @param _count number of points
+ * @param _hull receives vertices of the hull
+ * @param _hullOwners receives owners of the vertices, may be NULL
+ */
+void RocHull::chain(const QPointF *_points, const int *_owners, size_t _count, QVector<QPointF> &_hull, QVector<int> *_hullOwners)
+{
+	std::vector<size_t> stack;
+	stack.reserve(_count);
+	for (size_t i = 0; i < _count; i++) {
+		///pop vertices which do not turn right on the way to the new point
+		while (stack.size() >= 2) {
+			QPointF a = _points[stack[stack.size() - 2]], b = _points[stack.back()];
+			double cross = (b.x() - a.x()) * (_points[i].y() - a.y()) - (b.y() - a.y()) * (_points[i].x() - a.x());
+			if (cross < 0.0) {
+				break;
+			}
+			stack.pop_back();
+		}
+		stack.push_back(i);
+	}
+
+	_hull.resize(int(stack.size()));
+	if (_hullOwners) {
+		_hullOwners->resize(int(stack.size()));
+	}
+	for (size_t v = 0; v < stack.size(); v++) {
+		_hull[int(v)] = _points[stack[v]];
+		if (_hullOwners) {
+			(*_hullOwners)[int(v)] = _owners ? _owners[stack[v]] : -1;
+		}
+	}
+}
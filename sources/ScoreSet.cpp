@@ -0,0 +1,645 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/ScoreSet.h"
+#include "../headers/DataParser.h"
+#include "../headers/RadixSort.h"
+#include "../headers/CurveBuilder.h"
+#include "../headers/ScoreSketch.h"
+#include "../headers/ShardMerge.h"
+#include "../headers/fileProxy.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryFile>
+#include <QDir>
+#include <QByteArray>
+#include <QList>
+#include <QThread>
+#include <QAtomicInt>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cstring>
+
+///memory budget of score files in MB, changed from the GUI thread
+static QAtomicInt memoryBudget(1024);
+
+/**
+ * Part of a score file parsed by one thread
+ */
+struct ScoreChunk {
+	const char *begin;
+	const char *end;
+	QVector<float> scores;
+	QVector<quint8> labels;
+	QVector<float> weights;
+	bool weighted;
+	int error;
+};
+
+/**
+ * Parses a part of a score file, errors are stored in the chunk
+ * as they cannot leave a thread of QtConcurrent
+ * @param _chunk part of the file
+ */
+static void parseChunk(ScoreChunk &_chunk)
+{
+	int lines = DataParser::estimateLines(_chunk.begin, _chunk.end);
+	_chunk.scores.reserve(lines);
+	_chunk.labels.reserve(lines);
+	_chunk.weights.reserve(lines);
+	try {
+		DataParser::parseScores(_chunk.begin, _chunk.end, _chunk.scores, _chunk.labels, _chunk.weights, _chunk.weighted);
+	}
+	catch(int e) {
+		_chunk.error = e;
+	}
+}
+
+/**
+ * Appends values of a chunk to a vector
+ * @param _target vector the values are appended to
+ * @param _source values of a chunk
+ */
+template <typename T>
+static void appendValues(QVector<T> &_target, const QVector<T> &_source)
+{
+	int size = _target.size();
+	_target.resize(size + _source.size());
+	if (!_source.isEmpty()) {
+		memcpy(_target.data() + size, _source.constData(), _source.size() * sizeof(T));
+	}
+}
+
+/**
+ * Example of a score file as it is stored in a sorted run
+ */
+struct ScoreRecord {
+	float score;
+	float weight;
+	quint32 label;
+};
+
+///memory taken by an example held in memory: its score, weight and label, its index
+///and the radix sort buffers, and its record when it is written to a run
+static const qint64 exampleSize = sizeof(float) * 2 + sizeof(quint8) + sizeof(quint32) * 4 + sizeof(ScoreRecord);
+
+/**
+ * Temporary files holding sorted runs, removed when the loading ends or fails
+ */
+struct TemporaryRuns {
+	~TemporaryRuns() { qDeleteAll(files); }
+	QList<QTemporaryFile*> files;
+	QList<qint64> counts;
+};
+
+/**
+ * Reads records of one sorted run through a buffer
+ */
+struct RunReader {
+	QIODevice *file;
+	QVector<ScoreRecord> buffer;
+	int next;
+	int filled;
+	qint64 remaining;
+
+	/**
+	 * @return false if the run has no more records
+	 */
+	bool refill()
+	{
+		int count = int(qMin(remaining, qint64(buffer.size())));
+		if (count == 0 || file->read(reinterpret_cast<char*>(buffer.data()), count * sizeof(ScoreRecord)) != qint64(count * sizeof(ScoreRecord))) {
+			return false;
+		}
+		remaining -= count;
+		next = 0;
+		filled = count;
+		return true;
+	}
+
+	const ScoreRecord& current() const { return buffer[next]; }
+};
+
+/**
+ * Orders runs in the merge heap, the run holding the highest score is on top.
+ * Equal scores are taken from earlier runs first, so the merge is stable.
+ */
+struct RunOrder {
+	const QVector<RunReader> *runs;
+
+	bool operator()(int _a, int _b) const
+	{
+		float a = (*runs)[_a].current().score, b = (*runs)[_b].current().score;
+		return a < b || (a == b && _a > _b);
+	}
+};
+
+/**
+ * Constructor of ScoreSet class
+ * @param _path path of the score file
+ */
+ScoreSet::ScoreSet(QString _path):
+	path(_path), positives(0.0), negatives(0.0), auc(0.0), examples(0), streamed(false)
+{
+}
+
+/**
+ * Loads a score file, sorts its examples and builds ROC and PR curves.
+ * A file whose examples would not fit in the memory budget is streamed.
+ * Shards listed in a manifest are merged, their examples are not kept.
+ * @param _path path of the score file
+ * @param _observer optional object notified about loading progress
+ * @return loaded examples with their curves
+ * @throw 1001 unsupported structure of a line
+ * @throw 1002 number conversion failed
+ * @throw 1004 loading was cancelled by the observer
+ * @throw 1007 a temporary file could not be written
+ * @throw 1008 the file does not contain both positive and negative examples
+ * @throw 1010, 1011 see ShardMerge::merge
+ * @throw 1017 the file cannot be read
+ */
+QSharedPointer<ScoreSet> ScoreSet::load(QString _path, LoadObserver *_observer)
+{
+	QSharedPointer<ScoreSet> set(new ScoreSet(_path));
+
+	if (ShardMerge::isManifest(_path)) {
+		set->auc = ShardMerge::merge(_path, _observer, set->roc, set->pr, set->positives, set->negatives, set->examples);
+		set->streamed = true;
+		return set;
+	}
+
+	QFile file(_path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		throw 1017;
+	}
+
+	///the mapped text and the examples parsed from it have to fit in the budget,
+	///the number of examples is estimated from the first block of the file
+	qint64 size = file.size();
+	QByteArray head = file.peek(64 * 1024);
+	qint64 rows = head.isEmpty() ? 0
+		: qint64(DataParser::estimateLines(head.constData(), head.constData() + head.size())) * size / head.size();
+	if (size + rows * exampleSize > getMemoryBudget()) {
+		set->loadStreamed(file, _observer);
+		return set;
+	}
+
+	QByteArray contents;
+	const char *begin = 0;
+	if (size > 0) {
+		begin = reinterpret_cast<const char*>(file.map(0, size));
+	}
+	if (!begin) {
+		contents = file.readAll();
+		begin = contents.constData();
+		size = contents.size();
+	}
+
+	///parsing is reported as two thirds of the work, sorting and building curves as the rest
+	qint64 total = size + size / 2;
+	set->parse(begin, begin + size, _observer, total);
+	file.close();
+
+	set->examples = set->scores.size();
+	if (set->scores.size() > 0) {
+		set->order.resize(set->scores.size());
+		RadixSort::sortDescending(set->scores.constData(), set->scores.size(), set->order.data());
+	}
+	if (_observer && !_observer->progress(size + size / 4, total)) {
+		throw 1004;
+	}
+
+	set->buildCurves();
+	if (_observer && !_observer->progress(total, total)) {
+		throw 1004;
+	}
+	return set;
+}
+
+/**
+ * Parses the file in rounds. Every round is split into parts parsed in parallel,
+ * progress is reported by the loading thread after every round.
+ * Parsed examples are appended to those already held.
+ * @param _begin beginning of the file contents
+ * @param _end end of the file contents
+ * @param _observer optional object notified about loading progress
+ * @param _total total amount of work reported to the observer
+ * @throw 1001, 1002, 1004 see load
+ */
+void ScoreSet::parse(const char *_begin, const char *_end, LoadObserver *_observer, qint64 _total)
+{
+	int threads = qMax(1, QThread::idealThreadCount());
+	const qint64 partSize = 16 * 1024 * 1024;
+
+	int estimate = DataParser::estimateLines(_begin, _end);
+	scores.reserve(scores.size() + estimate);
+	labels.reserve(labels.size() + estimate);
+
+	bool weighted = !weights.isEmpty();
+	const char *p = _begin;
+	while (p < _end) {
+		///split the round on line boundaries
+		QVector<ScoreChunk> chunks;
+		for (int t = 0; t < threads && p < _end; t++) {
+			const char *chunkEnd = (_end - p > partSize) ? p + partSize : _end;
+			if (chunkEnd < _end) {
+				const char *newline = static_cast<const char*>(memchr(chunkEnd, '\n', _end - chunkEnd));
+				chunkEnd = newline ? newline + 1 : _end;
+			}
+			ScoreChunk chunk;
+			chunk.begin = p;
+			chunk.end = chunkEnd;
+			chunk.weighted = false;
+			chunk.error = 0;
+			chunks.append(chunk);
+			p = chunkEnd;
+		}
+		QtConcurrent::blockingMap(chunks, parseChunk);
+
+		for (int c = 0; c < chunks.size(); c++) {
+			if (chunks[c].error != 0) {
+				throw chunks[c].error;
+			}
+			///weights are kept only if any row has one
+			if (chunks[c].weighted && !weighted) {
+				weighted = true;
+				weights.fill(1.0f, scores.size());
+			}
+			appendValues(scores, chunks[c].scores);
+			appendValues(labels, chunks[c].labels);
+			if (weighted) {
+				appendValues(weights, chunks[c].weights);
+			}
+		}
+
+		if (_observer && !_observer->progress(p - _begin, _total)) {
+			throw 1004;
+		}
+	}
+}
+
+/**
+ * Builds ROC and PR curves walking examples from the highest score,
+ * points are thinned to CURVE_RESOLUTION as in streamed files
+ * @throw 1008 there are no positive or no negative examples
+ */
+void ScoreSet::buildCurves()
+{
+	int count = scores.size();
+	const float *weight = weights.isEmpty() ? 0 : weights.constData();
+
+	positives = negatives = 0.0;
+	for (int i = 0; i < count; i++) {
+		double w = weight ? weight[i] : 1.0;
+		if (labels[i]) {
+			positives += w;
+		}
+		else {
+			negatives += w;
+		}
+	}
+	if (!(positives > 0.0) || !(negatives > 0.0)) {
+		throw 1008;
+	}
+
+	CurveBuilder builder(positives, negatives, 1.0 / CURVE_RESOLUTION);
+	for (int i = 0; i < count; i++) {
+		quint32 k = order[i];
+		builder.add(scores[k], labels[k] != 0, weight ? weight[k] : 1.0);
+	}
+	auc = builder.finish();
+	roc = builder.roc;
+	pr = builder.pr;
+}
+
+/**
+ * Loads a score file in bounded memory. The file is read in blocks, examples
+ * are collected into runs which fit in the memory budget, and every run is sorted
+ * and written to a temporary file. Runs are merged with a heap and the curves are
+ * built from the merged examples, keeping points CURVE_RESOLUTION apart.
+ * If the whole file makes a single run, it is handled in memory.
+ * @param _file opened score file
+ * @param _observer optional object notified about loading progress
+ * @throw 1001, 1002, 1004, 1007, 1008 see load
+ */
+void ScoreSet::loadStreamed(QFile &_file, LoadObserver *_observer)
+{
+	qint64 budget = getMemoryBudget();
+	qint64 size = _file.size();
+	qint64 total = size + size / 2;
+
+	///half of the budget is left for the text block and the parser
+	qint64 runLength = qMax(budget / 2 / exampleSize, qint64(1024));
+	qint64 blockSize = qBound(qint64(64 * 1024), budget / 8, qint64(16 * 1024 * 1024));
+
+	TemporaryRuns runs;
+	QByteArray block;
+	qint64 read = 0;
+	bool atEnd = false;
+	while (!atEnd) {
+		///read a block, the incomplete last line is carried to the next one
+		QByteArray data = _file.read(blockSize);
+		read += data.size();
+		atEnd = data.size() < blockSize;
+		block.append(data);
+		int end = atEnd ? block.size() : block.lastIndexOf('\n') + 1;
+		if (end > 0) {
+			parse(block.constData(), block.constData() + end, 0, 0);
+			block.remove(0, end);
+		}
+		if (_observer && !_observer->progress(read, total)) {
+			throw 1004;
+		}
+		if (qint64(scores.size()) < runLength && !atEnd) {
+			continue;
+		}
+
+		int count = scores.size();
+		order.resize(count);
+		RadixSort::sortDescending(scores.constData(), count, order.data());
+		if (atEnd && runs.files.isEmpty()) {
+			///the whole file fits in one run
+			examples = count;
+			buildCurves();
+			return;
+		}
+
+		QTemporaryFile *run = new QTemporaryFile(QDir::tempPath() + "/projekt-zpr-run");
+		runs.files.append(run);
+		runs.counts.append(count);
+		if (!run->open()) {
+			throw 1007;
+		}
+		const float *weight = weights.isEmpty() ? 0 : weights.constData();
+		QVector<ScoreRecord> records(qMin(count, 64 * 1024));
+		for (int i = 0; i < count; i += records.size()) {
+			int n = qMin(records.size(), count - i);
+			for (int j = 0; j < n; j++) {
+				quint32 k = order[i + j];
+				records[j].score = scores[k];
+				records[j].weight = weight ? weight[k] : 1.0f;
+				records[j].label = labels[k];
+				if (labels[k]) {
+					positives += records[j].weight;
+				}
+				else {
+					negatives += records[j].weight;
+				}
+			}
+			if (run->write(reinterpret_cast<const char*>(records.constData()), n * sizeof(ScoreRecord)) != qint64(n * sizeof(ScoreRecord))) {
+				throw 1007;
+			}
+		}
+		if (!run->flush()) {
+			throw 1007;
+		}
+		examples += count;
+
+		///keep the reserved capacity for the next run, records of every run carry their weights
+		scores.resize(0);
+		labels.resize(0);
+		weights.resize(0);
+		order.resize(0);
+	}
+	scores = QVector<float>();
+	labels = QVector<quint8>();
+	weights = QVector<float>();
+	order = QVector<quint32>();
+
+	if (!(positives > 0.0) || !(negatives > 0.0)) {
+		throw 1008;
+	}
+	streamed = true;
+
+	///the rest of the budget is shared by the read buffers of the runs
+	int runCount = runs.files.size();
+	int bufferLength = int(qBound(qint64(256), budget / 2 / runCount / qint64(sizeof(ScoreRecord)), qint64(1024 * 1024)));
+	QVector<RunReader> readers(runCount);
+	QVector<int> heap;
+	for (int r = 0; r < runCount; r++) {
+		readers[r].file = runs.files[r];
+		readers[r].buffer.resize(bufferLength);
+		readers[r].remaining = runs.counts[r];
+		if (!runs.files[r]->seek(0)) {
+			throw 1007;
+		}
+		if (readers[r].refill()) {
+			heap.append(r);
+		}
+	}
+	RunOrder runOrder;
+	runOrder.runs = &readers;
+	std::make_heap(heap.begin(), heap.end(), runOrder);
+
+	CurveBuilder builder(positives, negatives, 1.0 / CURVE_RESOLUTION);
+	quint64 merged = 0;
+	while (!heap.isEmpty()) {
+		std::pop_heap(heap.begin(), heap.end(), runOrder);
+		RunReader &reader = readers[heap.last()];
+		const ScoreRecord &record = reader.current();
+		builder.add(record.score, record.label != 0, record.weight);
+
+		if (++reader.next < reader.filled || reader.refill()) {
+			std::push_heap(heap.begin(), heap.end(), runOrder);
+		}
+		else {
+			heap.pop_back();
+		}
+
+		if ((++merged & 0xffff) == 0 && _observer && !_observer->progress(size + qint64(double(size / 2) * merged / examples), total)) {
+			throw 1004;
+		}
+	}
+	auc = builder.finish();
+	roc = builder.roc;
+	pr = builder.pr;
+}
+
+/**
+ * Checks if a file holds raw scores, directly or in shards listed by a manifest
+ * @param _path path of the file
+ * @return true for .scores and .shards files
+ */
+bool ScoreSet::isScoreFile(QString _path)
+{
+	QString suffix = QFileInfo(_path).suffix();
+	return suffix.compare("scores", Qt::CaseInsensitive) == 0 || ShardMerge::isManifest(_path);
+}
+
+/**
+ * Builds the path under which a curve of a score file is loaded into a plot
+ * @param _file path of the score file
+ * @param _type ROC_CURVE or PR_CURVE
+ * @return path of the curve
+ */
+QString ScoreSet::curvePath(QString _file, int _type)
+{
+	return _file + (_type == PR_CURVE ? "#pr" : "#roc");
+}
+
+/**
+ * Splits the path of a curve of a score file or a score sketch
+ * @param _path path of a curve
+ * @param _file receives path of the score file or the sketch
+ * @param _type receives ROC_CURVE or PR_CURVE
+ * @return false if the path does not refer to a curve of a score file
+ */
+bool ScoreSet::splitCurvePath(QString _path, QString &_file, int &_type)
+{
+	int hash = _path.lastIndexOf('#');
+	if (hash < 0) {
+		return false;
+	}
+	QString file = _path.left(hash);
+	QString curve = _path.mid(hash + 1);
+	if (!isScoreFile(file) && !ScoreSketch::isSketchFile(file)) {
+		return false;
+	}
+	if (curve == "roc") {
+		_type = ROC_CURVE;
+	}
+	else if (curve == "pr") {
+		_type = PR_CURVE;
+	}
+	else {
+		return false;
+	}
+	_file = file;
+	return true;
+}
+
+/**
+ * Sets memory used when loading score files. Larger files are streamed through temporary files.
+ * @param _bytes budget in bytes
+ */
+void ScoreSet::setMemoryBudget(qint64 _bytes)
+{
+	memoryBudget.fetchAndStoreOrdered(int(qMax(_bytes / (1024 * 1024), qint64(1))));
+}
+
+/**
+ * @return memory used when loading score files in bytes
+ */
+qint64 ScoreSet::getMemoryBudget()
+{
+	return qint64(int(memoryBudget)) * 1024 * 1024;
+}
+
+/**
+ * @return path of the score file
+ */
+QString ScoreSet::getPath() const
+{
+	return path;
+}
+
+/**
+ * @return number of examples
+ */
+size_t ScoreSet::size() const
+{
+	return examples;
+}
+
+/**
+ * @return true if the file was streamed or merged from shards, its examples are not kept then
+ */
+bool ScoreSet::isStreamed() const
+{
+	return streamed;
+}
+
+/**
+ * @return scores of the examples in file order, null for streamed files
+ */
+const float* ScoreSet::getScores() const
+{
+	return scores.constData();
+}
+
+/**
+ * @return labels of the examples in file order, 1 for positive examples
+ */
+const quint8* ScoreSet::getLabels() const
+{
+	return labels.constData();
+}
+
+/**
+ * @return weights of the examples in file order, null if the file has no weights
+ */
+const float* ScoreSet::getWeights() const
+{
+	return weights.isEmpty() ? 0 : weights.constData();
+}
+
+/**
+ * @return indices of the examples ordered by descending score, ties in file order
+ */
+const quint32* ScoreSet::getOrder() const
+{
+	return order.constData();
+}
+
+/**
+ * @return total weight of positive examples
+ */
+double ScoreSet::getPositives() const
+{
+	return positives;
+}
+
+/**
+ * @return total weight of negative examples
+ */
+double ScoreSet::getNegatives() const
+{
+	return negatives;
+}
+
+/**
+ * @param _type ROC_CURVE or PR_CURVE
+ * @return points of the curve
+ */
+const QVector<QPointF>& ScoreSet::getCurve(int _type) const
+{
+	return _type == PR_CURVE ? pr : roc;
+}
+
+/**
+ * @return exact area under the ROC curve
+ */
+double ScoreSet::getAUC() const
+{
+	return auc;
+}
+
+/**
+ * @return memory taken by the examples and curves in bytes
+ */
+qint64 ScoreSet::memoryUsage() const
+{
+	return qint64(scores.capacity()) * sizeof(float) + qint64(labels.capacity()) * sizeof(quint8)
+		+ qint64(weights.capacity()) * sizeof(float) + qint64(order.capacity()) * sizeof(quint32)
+		+ qint64(roc.capacity() + pr.capacity()) * sizeof(QPointF);
+}
@@ -0,0 +1,379 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ * This file contains the implementation of ScoreSketch class: building a histogram
+ * of scores from score files, merging sketches, saving and mapping sketch files,
+ * and building ROC and PR curves with the error bound of their AUC from the bins.
+ */
+
+
+#include "../headers/ScoreSketch.h"
+#include "../headers/CurveBuilder.h"
+#include "../headers/BinaryCurve.h"
+#include "../headers/DataParser.h"
+#include "../headers/fileProxy.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QByteArray>
+#include <cstring>
+
+static const char sketchMagic[4] = { 'Z', 'P', 'R', 'S' };
+
+/**
+ * Constructor of ScoreSketch class. An empty range is widened to one unit,
+ * the number of bins is limited to MAX_BINS.
+ * @param _low lowest score of the first bin
+ * @param _high highest score of the last bin
+ * @param _bins number of bins of equal width
+ */
+ScoreSketch::ScoreSketch(double _low, double _high, quint32 _bins):
+	low(_low), high(_high > _low ? _high : _low + 1.0),
+	bins(qBound(quint32(1), _bins, quint32(MAX_BINS))), examples(0),
+	positives(bins, 0.0), negatives(bins, 0.0)
+{
+}
+
+/**
+ * Adds an example to the sketch
+ * @param _score score of the example
+ * @param _positive label of the example
+ * @param _weight weight of the example
+ */
+void ScoreSketch::add(float _score, bool _positive, double _weight)
+{
+	quint32 b = bin(_score);
+	if (_positive) {
+		positives[b] += _weight;
+	}
+	else {
+		negatives[b] += _weight;
+	}
+	examples++;
+}
+
+/**
+ * Adds all examples of a score file. The file is read in blocks,
+ * so memory does not depend on its size.
+ * @param _path path of the score file
+ * @param _observer optional object notified about reading progress
+ * @throw 1001 unsupported structure of a line
+ * @throw 1002 number conversion failed
+ * @throw 1004 reading was cancelled by the observer
+ * @throw 1017 the file cannot be read
+ */
+void ScoreSketch::addScores(QString _path, LoadObserver *_observer)
+{
+	QFile file(_path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		throw 1017;
+	}
+	qint64 size = file.size();
+	const qint64 blockSize = 16 * 1024 * 1024;
+
+	QByteArray block;
+	QVector<float> scores, weights;
+	QVector<quint8> labels;
+	qint64 read = 0;
+	bool atEnd = false;
+	while (!atEnd) {
+		///the incomplete last line of a block is carried to the next one
+		QByteArray data = file.read(blockSize);
+		read += data.size();
+		atEnd = data.size() < blockSize;
+		block.append(data);
+		int end = atEnd ? block.size() : block.lastIndexOf('\n') + 1;
+		if (end > 0) {
+			bool weighted = false;
+			scores.resize(0);
+			labels.resize(0);
+			weights.resize(0);
+			DataParser::parseScores(block.constData(), block.constData() + end, scores, labels, weights, weighted);
+			for (int i = 0; i < scores.size(); i++) {
+				add(scores[i], labels[i] != 0, weights[i]);
+			}
+			block.remove(0, end);
+		}
+		if (_observer && !_observer->progress(read, size)) {
+			throw 1004;
+		}
+	}
+}
+
+/**
+ * Adds examples of another sketch. Adding histograms is associative,
+ * so shards can be merged in any grouping.
+ * @param _other sketch with the same bins
+ * @throw 1009 the sketches have different bins
+ */
+void ScoreSketch::merge(const ScoreSketch &_other)
+{
+	if (!isCompatible(_other)) {
+		throw 1009;
+	}
+	for (quint32 b = 0; b < bins; b++) {
+		positives[b] += _other.positives[b];
+		negatives[b] += _other.negatives[b];
+	}
+	examples += _other.examples;
+}
+
+/**
+ * @param _other another sketch
+ * @return true if both sketches have the same bins and can be merged
+ */
+bool ScoreSketch::isCompatible(const ScoreSketch &_other) const
+{
+	return low == _other.low && high == _other.high && bins == _other.bins;
+}
+
+/**
+ * Writes the sketch to a file, only non-empty bins are stored
+ * @param _path path of the file
+ * @throw 1007 the file cannot be written
+ */
+void ScoreSketch::save(QString _path) const
+{
+	QVector<ScoreSketchBin> records;
+	for (quint32 b = 0; b < bins; b++) {
+		if (positives[b] != 0.0 || negatives[b] != 0.0) {
+			ScoreSketchBin record;
+			record.bin = b;
+			record.reserved = 0;
+			record.positives = positives[b];
+			record.negatives = negatives[b];
+			records.append(record);
+		}
+	}
+	qint64 dataSize = qint64(records.size()) * sizeof(ScoreSketchBin);
+
+	ScoreSketchHeader h;
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, sketchMagic, sizeof(sketchMagic));
+	h.version = VERSION;
+	h.bins = bins;
+	h.used = records.size();
+	h.low = low;
+	h.high = high;
+	h.examples = examples;
+	h.checksum = BinaryCurveFile::checksum(reinterpret_cast<const uchar*>(records.constData()), dataSize);
+
+	QFile target(_path);
+	if (!target.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+		throw 1007;
+	}
+	if (target.write(reinterpret_cast<const char*>(&h), sizeof(h)) != qint64(sizeof(h))
+		|| target.write(reinterpret_cast<const char*>(records.constData()), dataSize) != dataSize) {
+		target.remove();
+		throw 1007;
+	}
+}
+
+/**
+ * Maps a sketch file and verifies its header and checksum. Bins are read straight
+ * from the mapping, the file is read into memory only if it cannot be mapped.
+ * @param _path path of the file
+ * @param _observer optional object notified when the file was read
+ * @return the sketch
+ * @throw 1004 loading was cancelled by the observer
+ * @throw 1005 the file is not a valid sketch file
+ * @throw 1006 checksum of the bins does not match
+ */
+ScoreSketch ScoreSketch::load(QString _path, LoadObserver *_observer)
+{
+	QFile file(_path);
+	if (!file.open(QIODevice::ReadOnly)) {
+		throw 1005;
+	}
+	qint64 size = file.size();
+	if (size < qint64(sizeof(ScoreSketchHeader))) {
+		throw 1005;
+	}
+	QByteArray contents;
+	const uchar *map = file.map(0, size);
+	if (!map) {
+		contents = file.readAll();
+		if (contents.size() != size) {
+			throw 1005;
+		}
+		map = reinterpret_cast<const uchar*>(contents.constData());
+	}
+
+	ScoreSketchHeader h;
+	memcpy(&h, map, sizeof(h));
+	if (memcmp(h.magic, sketchMagic, sizeof(sketchMagic)) != 0 || h.version != VERSION
+		|| h.bins == 0 || h.bins > quint32(MAX_BINS) || !(h.high > h.low) || h.used > h.bins) {
+		throw 1005;
+	}
+	qint64 dataSize = qint64(h.used) * sizeof(ScoreSketchBin);
+	if (size - qint64(sizeof(h)) != dataSize) {
+		throw 1005;
+	}
+	const uchar *data = map + sizeof(h);
+	if (BinaryCurveFile::checksum(data, dataSize) != h.checksum) {
+		throw 1006;
+	}
+
+	ScoreSketch sketch(h.low, h.high, h.bins);
+	for (quint32 i = 0; i < h.used; i++) {
+		ScoreSketchBin record;
+		memcpy(&record, data + qint64(i) * sizeof(ScoreSketchBin), sizeof(record));
+		if (record.bin >= h.bins) {
+			throw 1005;
+		}
+		sketch.positives[record.bin] = record.positives;
+		sketch.negatives[record.bin] = record.negatives;
+	}
+	sketch.examples = h.examples;
+
+	if (_observer && !_observer->progress(size, size)) {
+		throw 1004;
+	}
+	return sketch;
+}
+
+/**
+ * Checks if a file holds a score sketch
+ * @param _path path of the file
+ * @return true for .sketch files
+ */
+bool ScoreSketch::isSketchFile(QString _path)
+{
+	return QFileInfo(_path).suffix().compare("sketch", Qt::CaseInsensitive) == 0;
+}
+
+/**
+ * @return lowest score of the first bin
+ */
+double ScoreSketch::getLow() const
+{
+	return low;
+}
+
+/**
+ * @return highest score of the last bin
+ */
+double ScoreSketch::getHigh() const
+{
+	return high;
+}
+
+/**
+ * @return number of bins
+ */
+quint32 ScoreSketch::getBins() const
+{
+	return bins;
+}
+
+/**
+ * @return number of examples added to the sketch
+ */
+quint64 ScoreSketch::getExamples() const
+{
+	return examples;
+}
+
+/**
+ * @return total weight of positive examples
+ */
+double ScoreSketch::getPositives() const
+{
+	CompensatedSum sum;
+	for (quint32 b = 0; b < bins; b++) {
+		sum.add(positives[b]);
+	}
+	return sum.result();
+}
+
+/**
+ * @return total weight of negative examples
+ */
+double ScoreSketch::getNegatives() const
+{
+	CompensatedSum sum;
+	for (quint32 b = 0; b < bins; b++) {
+		sum.add(negatives[b]);
+	}
+	return sum.result();
+}
+
+/**
+ * Builds ROC and PR curves of the sketch, every bin is one threshold
+ * @param _roc receives points of the ROC curve
+ * @param _pr receives points of the PR curve
+ * @return area under the ROC curve, see aucErrorBound for its accuracy
+ * @throw 1008 the sketch does not contain both positive and negative examples
+ */
+double ScoreSketch::buildCurves(QVector<QPointF> &_roc, QVector<QPointF> &_pr) const
+{
+	double p = getPositives(), n = getNegatives();
+	if (!(p > 0.0) || !(n > 0.0)) {
+		throw 1008;
+	}
+
+	///bins are walked from the highest scores, the bin index is the score of its threshold
+	CurveBuilder builder(p, n);
+	for (quint32 b = bins; b-- > 0; ) {
+		if (positives[b] != 0.0) {
+			builder.add(float(b), true, positives[b]);
+		}
+		if (negatives[b] != 0.0) {
+			builder.add(float(b), false, negatives[b]);
+		}
+	}
+	double auc = builder.finish();
+	_roc = builder.roc;
+	_pr = builder.pr;
+	return auc;
+}
+
+/**
+ * Largest difference between the ROC AUC of the sketch and the AUC of the examples
+ * added to it, which comes from pairs of examples sharing a bin
+ * @return error bound of the AUC, 0 for an empty sketch
+ */
+double ScoreSketch::aucErrorBound() const
+{
+	double p = getPositives(), n = getNegatives();
+	if (!(p > 0.0) || !(n > 0.0)) {
+		return 0.0;
+	}
+	CompensatedSum tied;
+	for (quint32 b = 0; b < bins; b++) {
+		tied.add(positives[b] * negatives[b]);
+	}
+	return tied.result() / (2.0 * p * n);
+}
+
+/**
+ * Finds the bin of a score, scores outside the range go to the first or the last bin
+ * @param _score score
+ * @return index of the bin
+ */
+quint32 ScoreSketch::bin(float _score) const
+{
+	double position = (double(_score) - low) / (high - low) * bins;
+	if (!(position >= 0.0)) {
+		return 0;
+	}
+	if (position >= double(bins)) {
+		return bins - 1;
+	}
+	return quint32(position);
+}
@@ -0,0 +1,316 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../headers/ShardMerge.h"
+#include "../headers/ScoreSet.h"
+#include "../headers/CurveBuilder.h"
+#include "../headers/DataParser.h"
+#include "../headers/fileProxy.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QByteArray>
+#include <QList>
+#include <QtConcurrentMap>
+#include <algorithm>
+#include <cstring>
+
+/**
+ * Reads one shard in batches of rows, parsed from the mapped file
+ */
+struct ShardCursor {
+	const char *begin;
+	const char *p;
+	const char *end;
+	bool aggregate;
+	QVector<float> scores;
+	QVector<double> positives;
+	QVector<double> negatives;
+	QVector<quint8> labels;
+	QVector<float> weights;
+	int next;
+	float last;
+	bool started;
+	CompensatedSum totalPositives;
+	CompensatedSum totalNegatives;
+	quint64 rows;
+	int error;
+
+	/**
+	 * Moves the cursor to the beginning of the shard
+	 */
+	void rewind()
+	{
+		p = begin;
+		next = 0;
+		started = false;
+		scores.resize(0);
+	}
+
+	/**
+	 * Parses the next batch of rows and checks that scores do not increase
+	 * @return false if the shard has no more rows
+	 * @throw 1001, 1002 see DataParser
+	 * @throw 1010 the shard is not sorted by descending score
+	 */
+	bool refill()
+	{
+		const qint64 batchSize = 64 * 1024;
+		scores.resize(0);
+		positives.resize(0);
+		negatives.resize(0);
+		next = 0;
+		while (scores.isEmpty() && p < end) {
+			const char *batchEnd = (end - p > batchSize) ? p + batchSize : end;
+			if (batchEnd < end) {
+				const char *newline = static_cast<const char*>(memchr(batchEnd, '\n', end - batchEnd));
+				batchEnd = newline ? newline + 1 : end;
+			}
+			if (aggregate) {
+				DataParser::parseAggregates(p, batchEnd, scores, positives, negatives);
+			}
+			else {
+				bool weighted = false;
+				labels.resize(0);
+				weights.resize(0);
+				DataParser::parseScores(p, batchEnd, scores, labels, weights, weighted);
+				for (int i = 0; i < scores.size(); i++) {
+					positives.append(labels[i] ? weights[i] : 0.0);
+					negatives.append(labels[i] ? 0.0 : weights[i]);
+				}
+			}
+			p = batchEnd;
+		}
+		for (int i = 0; i < scores.size(); i++) {
+			if (started && scores[i] > last) {
+				throw 1010;
+			}
+			last = scores[i];
+			started = true;
+		}
+		return !scores.isEmpty();
+	}
+};
+
+/**
+ * Mapped shard files, closed when the merge ends or fails
+ */
+struct ShardFiles {
+	~ShardFiles() { qDeleteAll(files); }
+	QList<QFile*> files;
+	QList<QByteArray> contents;
+};
+
+/**
+ * Orders shards in the merge heap, the shard holding the highest score is on top
+ */
+struct ShardOrder {
+	const QVector<ShardCursor> *shards;
+
+	bool operator()(int _a, int _b) const
+	{
+		const ShardCursor &a = (*shards)[_a], &b = (*shards)[_b];
+		float sa = a.scores[a.next], sb = b.scores[b.next];
+		return sa < sb || (sa == sb && _a > _b);
+	}
+};
+
+/**
+ * Sums weights of a shard and checks its order, errors are stored in the cursor
+ * as they cannot leave a thread of QtConcurrent
+ * @param _shard cursor of the shard
+ */
+static void sumShard(ShardCursor &_shard)
+{
+	try {
+		while (_shard.refill()) {
+			for (int i = 0; i < _shard.scores.size(); i++) {
+				_shard.totalPositives.add(_shard.positives[i]);
+				_shard.totalNegatives.add(_shard.negatives[i]);
+			}
+			_shard.rows += _shard.scores.size();
+		}
+	}
+	catch(int e) {
+		_shard.error = e;
+	}
+}
+
+/**
+ * Checks if a file is a shard manifest
+ * @param _path path of the file
+ * @return true for .shards files
+ */
+bool ShardMerge::isManifest(QString _path)
+{
+	return QFileInfo(_path).suffix().compare("shards", Qt::CaseInsensitive) == 0;
+}
+
+/**
+ * Checks if a shard holds aggregated weights instead of examples
+ * @param _path path of the shard
+ * @return true for .agg files
+ */
+bool ShardMerge::isAggregate(QString _path)
+{
+	return QFileInfo(_path).suffix().compare("agg", Qt::CaseInsensitive) == 0;
+}
+
+/**
+ * Reads paths of shards from a manifest. Empty lines and lines starting with # are skipped,
+ * relative paths are resolved against the directory of the manifest.
+ * @param _path path of the manifest
+ * @return absolute paths of the shards
+ * @throw 1011 the manifest cannot be read
+ */
+QStringList ShardMerge::readManifest(QString _path)
+{
+	QFile file(_path);
+	if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+		throw 1011;
+	}
+	QDir dir = QFileInfo(_path).absoluteDir();
+	QStringList shards;
+	while (!file.atEnd()) {
+		QString line = QString::fromUtf8(file.readLine()).trimmed();
+		if (line.isEmpty() || line.startsWith('#')) {
+			continue;
+		}
+		shards.append(QDir::cleanPath(dir.absoluteFilePath(line)));
+	}
+	return shards;
+}
+
+/**
+ * Merges the shards of a manifest and builds the exact global curves.
+ * Points are kept ScoreSet::CURVE_RESOLUTION apart, AUC is exact.
+ * @param _manifest path of the manifest
+ * @param _observer optional object notified about progress
+ * @param _roc receives points of the ROC curve
+ * @param _pr receives points of the PR curve
+ * @param _positives receives total weight of positive examples
+ * @param _negatives receives total weight of negative examples
+ * @param _examples receives number of rows of all shards
+ * @return area under the ROC curve
+ * @throw 1001, 1002 unsupported structure or bad number in a shard
+ * @throw 1004 merging was cancelled by the observer
+ * @throw 1008 the shards do not contain both positive and negative examples
+ * @throw 1010 a shard is not sorted by descending score
+ * @throw 1011 the manifest or a shard cannot be read
+ */
+double ShardMerge::merge(QString _manifest, LoadObserver *_observer, QVector<QPointF> &_roc, QVector<QPointF> &_pr,
+	double &_positives, double &_negatives, quint64 &_examples)
+{
+	QStringList paths = readManifest(_manifest);
+
+	ShardFiles files;
+	QVector<ShardCursor> shards(paths.size());
+	for (int i = 0; i < paths.size(); i++) {
+		QFile *file = new QFile(paths[i]);
+		files.files.append(file);
+		if (!file->open(QIODevice::ReadOnly)) {
+			throw 1011;
+		}
+		qint64 size = file->size();
+		const char *data = 0;
+		if (size > 0) {
+			data = reinterpret_cast<const char*>(file->map(0, size));
+		}
+		if (!data) {
+			files.contents.append(file->readAll());
+			data = files.contents.last().constData();
+			size = files.contents.last().size();
+		}
+		ShardCursor &shard = shards[i];
+		shard.begin = data;
+		shard.end = data + size;
+		shard.aggregate = isAggregate(paths[i]);
+		shard.rows = 0;
+		shard.error = 0;
+		shard.rewind();
+	}
+
+	///first pass sums the weights, which are needed to normalize the curves
+	QtConcurrent::blockingMap(shards, sumShard);
+	CompensatedSum positives, negatives;
+	quint64 rows = 0;
+	for (int i = 0; i < shards.size(); i++) {
+		if (shards[i].error != 0) {
+			throw shards[i].error;
+		}
+		positives.add(shards[i].totalPositives.result());
+		negatives.add(shards[i].totalNegatives.result());
+		rows += shards[i].rows;
+	}
+	_positives = positives.result();
+	_negatives = negatives.result();
+	_examples = rows;
+	if (!(_positives > 0.0) || !(_negatives > 0.0)) {
+		throw 1008;
+	}
+	if (_observer && !_observer->progress(1, 2)) {
+		throw 1004;
+	}
+
+	///second pass merges the shards, rows with equal scores form one threshold across shards
+	QVector<int> heap;
+	for (int i = 0; i < shards.size(); i++) {
+		shards[i].rewind();
+		if (shards[i].refill()) {
+			heap.append(i);
+		}
+	}
+	ShardOrder order;
+	order.shards = &shards;
+	std::make_heap(heap.begin(), heap.end(), order);
+
+	CurveBuilder builder(_positives, _negatives, 1.0 / ScoreSet::CURVE_RESOLUTION);
+	quint64 merged = 0;
+	while (!heap.isEmpty()) {
+		std::pop_heap(heap.begin(), heap.end(), order);
+		ShardCursor &shard = shards[heap.last()];
+		float score = shard.scores[shard.next];
+		if (shard.positives[shard.next] > 0.0) {
+			builder.add(score, true, shard.positives[shard.next]);
+		}
+		if (shard.negatives[shard.next] > 0.0) {
+			builder.add(score, false, shard.negatives[shard.next]);
+		}
+
+		if (++shard.next < shard.scores.size() || shard.refill()) {
+			std::push_heap(heap.begin(), heap.end(), order);
+		}
+		else {
+			heap.pop_back();
+		}
+
+		if ((++merged & 0xffff) == 0 && _observer && !_observer->progress(rows + merged, 2 * rows)) {
+			throw 1004;
+		}
+	}
+
+	double auc = builder.finish();
+	_roc = builder.roc;
+	_pr = builder.pr;
+	return auc;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+
+#include "../headers/SketchBuilder.h"
+
+/**
+ * SketchBuilder class constructor. The builder is deleted by its owner,
+ * not by the thread pool.
+ * @param _sketch sketch to which the files are added, its bins are replaced by those of the first sketch file
+ * @param _sketchFiles sketch files to be merged
+ * @param _scoreFiles score files to be added
+ * @param _target path of the sketch file to be written
+ */
+SketchBuilder::SketchBuilder(const ScoreSketch &_sketch, QStringList _sketchFiles, QStringList _scoreFiles, QString _target):
+	sketch_(_sketch), sketchFiles_(_sketchFiles), scoreFiles_(_scoreFiles), target_(_target),
+	file_(0), percent_(-1), cancelled_(0)
+{
+	setAutoDelete(false);
+}
+
+/**
+ * Merges the sketch files, adds the score files and saves the sketch.
+ * Called by the thread pool, emits built or failed signal when done.
+ * The failed signal carries the path of the file which could not be processed.
+ */
+void SketchBuilder::run()
+{
+	QString current;
+	try {
+		for (int i = 0; i < sketchFiles_.size(); i++, file_++) {
+			current = sketchFiles_[i];
+			if (i == 0) {
+				sketch_ = ScoreSketch::load(current, this);
+			}
+			else {
+				sketch_.merge(ScoreSketch::load(current, this));
+			}
+		}
+		for (int i = 0; i < scoreFiles_.size(); i++, file_++) {
+			current = scoreFiles_[i];
+			sketch_.addScores(current, this);
+		}
+		current = target_;
+		sketch_.save(target_);
+	}
+	catch(int e) {
+		emit failed(current, e);
+		return;
+	}
+	emit built();
+}
+
+/**
+ * Requests cancellation of the building. Safe to call from any thread.
+ */
+void SketchBuilder::cancel()
+{
+	cancelled_.fetchAndStoreOrdered(1);
+}
+
+/**
+ * Called while a file is read. Emits progressChanged signal with the progress
+ * over all files whenever the percentage changes.
+ * @param _done number of bytes of the current file already read
+ * @param _total size of the current file
+ * @return false if the building was cancelled
+ */
+bool SketchBuilder::progress(qint64 _done, qint64 _total)
+{
+	int files = sketchFiles_.size() + scoreFiles_.size();
+	double part = _total > 0 ? double(_done) / _total : 1.0;
+	int percent = files > 0 ? int((file_ + part) * 100 / files) : 100;
+	if (percent != percent_) {
+		percent_ = percent;
+		emit progressChanged(target_, percent);
+	}
+	return !cancelled_;
+}
+
+/**
+ * @return built sketch, valid after built signal was emitted
+ */
+const ScoreSketch& SketchBuilder::getSketch() const
+{
+	return sketch_;
+}
+
+/**
+ * @return path of the sketch file
+ */
+QString SketchBuilder::getTarget() const
+{
+	return target_;
+}
@@ -25,7 +25,11 @@
 
 
 #include "../headers/fileProxy.h"
+#include "../headers/DataParser.h"
+#include "../headers/CurveCache.h"
 #include <QFile>
+#include <QByteArray>
+#include <cstring>
 
 		
 /**
@@ -34,6 +38,7 @@
  */
 RealFile::RealFile(QString _path){
 	path=_path;
+	loaded=false;
 }
 
 		
@@ -44,41 +49,63 @@ RealFile::~RealFile(){}
 
 		
 /**
- * Loads data from file which name is stored in path field of the RealFile class
+ * Loads data from file which name is stored in path field of the RealFile class.
+ * The file is memory mapped and scanned in place, if mapping is not possible
+ * its contents are read into memory at once. The file is read only once,
+ * subsequent calls return the data which was already loaded.
+ * @param _observer optional object notified after every parsed chunk of the file
  * @return	pointer to vector storing QPointF objects which represent coordinates
  *			of point
+ * @throw 1004 loading was cancelled by the observer
  */
-QVector<QPointF>* RealFile::getData(){
+QVector<QPointF>* RealFile::getData(LoadObserver *_observer){
+	if (loaded){
+		return &data_points;
+	}
+
 	//read from file
 	QFile file(path);
-	file.open(QIODevice::ReadOnly | QIODevice::Text);
-	QTextStream in(&file);
-	QString line;
-	
-	while (!in.atEnd()) {
-		line= in.readLine();
-		QStringList field = line.split("\t", QString::SkipEmptyParts);
-		if (field.size()!=2){
-			if(field.size()==0){
-				break;
-			}
-			else{
-				throw 1001;
-			}
+	if (!file.open(QIODevice::ReadOnly)){
+		return &data_points;
+	}
+
+	QByteArray contents;
+	const char *begin = 0;
+	qint64 size = file.size();
+	if (size > 0){
+		begin = reinterpret_cast<const char*>(file.map(0, size));
+	}
+	if (!begin){
+		contents = file.readAll();
+		begin = contents.constData();
+		size = contents.size();
+	}
+	const char *end = begin + size;
+
+	data_points.reserve(data_points.size() + DataParser::estimateLines(begin, end));
+
+	///parse in chunks ending on a line boundary, so that progress can be reported
+	const qint64 chunkSize = 4 * 1024 * 1024;
+	const char *p = begin;
+	bool finished = false;
+	while (p < end && !finished){
+		const char *chunkEnd = (end - p > chunkSize) ? p + chunkSize : end;
+		if (chunkEnd < end){
+			const char *newline = static_cast<const char*>(memchr(chunkEnd, '\n', end - chunkEnd));
+			chunkEnd = newline ? newline + 1 : end;
 		}
-		bool error_x, error_y;
-		double data_x=field.at(0).toDouble(&error_x);
-		double data_y=field.at(1).toDouble(&error_y);
-		
-		if (!error_x||!error_y){
-			throw 1002;
+		p = DataParser::parsePoints(p, chunkEnd, data_points, finished);
+		if (_observer && !_observer->progress(p - begin, size)){
+			throw 1004;
 		}
-		data_points.append( QPointF( data_x, data_y) );	
 	}
+	loaded=true;
 	return &data_points;
 }
 
-ProxyFile::ProxyFile(){}
+ProxyFile::ProxyFile(){
+	p_real_file=0;
+}
 		
 /**
  * Constructor of ProxyFile class
@@ -110,11 +137,22 @@ ProxyFile* ProxyFile::init_path(QString _path){
 
 /**
  * Creates new RealFile object if necessary and assign it to p_real_file pointer
+ * @param _observer optional object notified about loading progress
  */
-QVector<QPointF>* ProxyFile::getData(){
+QVector<QPointF>* ProxyFile::getData(LoadObserver *_observer){
 	if (!p_real_file){
 		p_real_file= new RealFile(real_file_path);
 	}
-	return p_real_file->getData();
+	return p_real_file->getData(_observer);
 }
 
+
+/**
+ * Returns data of the file from the curve cache, which loads it only if
+ * no copy of the same file is held in memory
+ * @param _observer optional object notified about loading progress
+ * @return shared data of the file
+ */
+QSharedPointer<CurveData> ProxyFile::getCurveData(LoadObserver *_observer){
+	return CurveCache::instance()->acquire(real_file_path, _observer);
+}
@@ -17,19 +17,54 @@
  * http://www.gnu.org/copyleft/gpl.html
  *
  * @section DESCRIPTION
- * Initialize the program and window
+ * Initialize the program and window, or render plots given on the command line
+ * to files without a window (see BatchRender), or measure curve files without a GUI
+ * (see BatchMetrics)
  */
 
 
 #include <qapplication.h>
 #include <qlibraryinfo.h>
 #include "../headers/PlotWindow.h"
+#include "../headers/BatchRender.h"
+#include "../headers/BatchMetrics.h"
+#include "../headers/ErrorCodes.h"
+#include <qcoreapplication.h>
+#include <iostream>
 
 int main(int argc, char *argv[]){	
+	///curve files are measured without any widget, so no GUI is started for them
+	if (BatchMetrics::isMetricsCommand(argc, argv)) {
+		QCoreApplication app(argc, argv);
+		try {
+			BatchMetrics metrics(app.arguments());
+			return metrics.run();
+		}
+		catch(int e) {
+			std::cerr << qPrintable(ErrorCodes::message(e)) << std::endl;
+			std::cerr << qPrintable(BatchMetrics::usage()) << std::endl;
+			return 2;
+		}
+	}
+
 	QApplication app(argc, argv);
 
 	app.setApplicationName("Porwnywanie krzywych");
 
+	///plots given on the command line are rendered to files without a window
+	QStringList arguments = app.arguments();
+	if (BatchRender::isRenderCommand(arguments)) {
+		try {
+			BatchRender render(arguments);
+			return render.run();
+		}
+		catch(int e) {
+			std::cerr << qPrintable(ErrorCodes::message(e)) << std::endl;
+			std::cerr << qPrintable(BatchRender::usage()) << std::endl;
+			return 2;
+		}
+	}
+
 	PlotWindow window;
     window.resize(800,400);
 	window.show();
@@ -0,0 +1,16 @@
+######################################################################
+# Unit tests of the AUC kernels, run with: qmake && make && ./tst_metrics
+######################################################################
+
+TEMPLATE = app
+TARGET = tst_metrics
+CONFIG += qtestlib console
+CONFIG -= app_bundle
+QT -= gui
+DEPENDPATH += . ../../headers ../../sources
+INCLUDEPATH += . ../../headers
+
+# Input
+HEADERS += ../../headers/Metrics.h
+SOURCES += tst_metrics.cpp \
+           ../../sources/Metrics.cpp
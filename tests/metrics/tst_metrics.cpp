@@ -0,0 +1,146 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../../headers/Metrics.h"
+#include <QtTest/QtTest>
+#include <QVector>
+
+/**
+ * Checks the vectorized AUC kernels against the scalar reference
+ * and the partial AUC at the borders of segments and on vertical runs.
+ */
+class TestMetrics : public QObject {
+	Q_OBJECT
+
+private slots:
+	void kernelsMatchScalar();
+	void partialAucBorders();
+	void partialAucSegmentBorders();
+	void partialAucVerticalRuns();
+};
+
+/**
+ * Builds a curve with non-decreasing x values. Some points repeat the x value
+ * of the previous one, which gives vertical runs.
+ * @param _count number of points
+ * @return curve points
+ */
+static QVector<QPointF> randomCurve(int _count)
+{
+	QVector<QPointF> points(_count);
+	double x = 0.0, y = 0.0;
+	for (int i = 0; i < _count; i++) {
+		if (qrand() % 4 != 0) {
+			x += double(qrand()) / RAND_MAX;
+		}
+		y += double(qrand()) / RAND_MAX;
+		points[i] = QPointF(x, y);
+	}
+	return points;
+}
+
+/**
+ * @param _value computed value
+ * @param _expected expected value
+ * @return true if the values differ only by rounding
+ */
+static bool isClose(double _value, double _expected)
+{
+	return qAbs(_value - _expected) <= 1e-12 * qMax(1.0, qAbs(_expected));
+}
+
+/**
+ * Every kernel the processor supports gives the scalar AUC, also for counts
+ * which are not a multiple of the vector width
+ */
+void TestMetrics::kernelsMatchScalar()
+{
+	qsrand(1);
+	const int counts[] = { 0, 1, 2, 3, 4, 5, 7, 8, 9, 16, 17, 1000, 100003 };
+	for (unsigned c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+		QVector<QPointF> points = randomCurve(counts[c]);
+		double expected = Metrics::auc(points.constData(), points.size(), Metrics::Scalar);
+		for (int k = Metrics::SSE2; k <= Metrics::bestKernel(); k++) {
+			double value = Metrics::auc(points.constData(), points.size(), Metrics::Kernel(k));
+			QVERIFY2(isClose(value, expected), qPrintable(QString("%1 kernel, %2 points: %3 instead of %4")
+				.arg(Metrics::kernelName(Metrics::Kernel(k))).arg(counts[c]).arg(value, 0, 'g', 17).arg(expected, 0, 'g', 17)));
+		}
+	}
+}
+
+/**
+ * Borders inside segments are interpolated, borders outside the curve are limited to it
+ */
+void TestMetrics::partialAucBorders()
+{
+	QVector<QPointF> points;
+	points << QPointF(0.0, 0.0) << QPointF(0.5, 0.5) << QPointF(1.0, 1.0);
+
+	QVERIFY(isClose(Metrics::partialAuc(points.constData(), points.size(), 0.0, 0.5), 0.125));
+	QVERIFY(isClose(Metrics::partialAuc(points.constData(), points.size(), 0.25, 0.75), 0.25));
+	QVERIFY(isClose(Metrics::partialAuc(points.constData(), points.size(), 0.1, 0.2), 0.015));
+	QVERIFY(isClose(Metrics::partialAuc(points.constData(), points.size(), -1.0, 2.0), 0.5));
+	QCOMPARE(Metrics::partialAuc(points.constData(), points.size(), 0.5, 0.5), 0.0);
+	QCOMPARE(Metrics::partialAuc(points.constData(), points.size(), 0.75, 0.25), 0.0);
+}
+
+/**
+ * Partial AUCs split at the x value of every point add up to the whole AUC
+ */
+void TestMetrics::partialAucSegmentBorders()
+{
+	qsrand(2);
+	QVector<QPointF> points = randomCurve(257);
+	const QPointF *data = points.constData();
+	int count = points.size();
+	double first = data[0].x(), last = data[count - 1].x();
+	double expected = Metrics::auc(data, count, Metrics::Scalar);
+
+	QVERIFY(isClose(Metrics::partialAuc(data, count, first, last), expected));
+	for (int i = 0; i < count; i++) {
+		double border = data[i].x();
+		double sum = Metrics::partialAuc(data, count, first, border) + Metrics::partialAuc(data, count, border, last);
+		QVERIFY2(isClose(sum, expected), qPrintable(QString("split at point %1").arg(i)));
+	}
+}
+
+/**
+ * On a vertical run the area left of it ends at its lowest point
+ * and the area right of it starts at its highest point
+ */
+void TestMetrics::partialAucVerticalRuns()
+{
+	QVector<QPointF> points;
+	points << QPointF(0.0, 0.0) << QPointF(0.0, 0.6) << QPointF(0.5, 0.6) << QPointF(0.5, 1.0) << QPointF(1.0, 1.0);
+	const QPointF *data = points.constData();
+	int count = points.size();
+
+	QVERIFY(isClose(Metrics::partialAuc(data, count, 0.0, 0.5), 0.3));
+	QVERIFY(isClose(Metrics::partialAuc(data, count, 0.5, 1.0), 0.5));
+	QVERIFY(isClose(Metrics::partialAuc(data, count, 0.0, 0.25), 0.15));
+	QVERIFY(isClose(Metrics::partialAuc(data, count, 0.25, 0.75), 0.4));
+	QVERIFY(isClose(Metrics::partialAuc(data, count, 0.0, 1.0), Metrics::auc(data, count, Metrics::Scalar)));
+}
+
+QTEST_APPLESS_MAIN(TestMetrics)
+#include "tst_metrics.moc"
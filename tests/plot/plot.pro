@@ -0,0 +1,65 @@
+######################################################################
+# GUI tests of the plot, run with: qmake && make && ./tst_plot
+######################################################################
+
+TEMPLATE = app
+TARGET = tst_plot
+CONFIG += qtestlib qwt
+CONFIG -= app_bundle
+DEPENDPATH += . ../../headers ../../sources
+INCLUDEPATH += . ../../headers
+
+# Input
+HEADERS += ../../headers/AverageUpdater.h \
+           ../../headers/BinaryCurve.h \
+           ../../headers/Bootstrap.h \
+           ../../headers/Curve.h \
+           ../../headers/CurveAverage.h \
+           ../../headers/CurveBuilder.h \
+           ../../headers/CurveCache.h \
+           ../../headers/CurveData.h \
+           ../../headers/CurveLoader.h \
+           ../../headers/CurvePyramid.h \
+           ../../headers/CurveRegistry.h \
+           ../../headers/CurveTail.h \
+           ../../headers/DataParser.h \
+           ../../headers/DeLong.h \
+           ../../headers/ErrorCodes.h \
+           ../../headers/fileProxy.h \
+           ../../headers/FunctionData.h \
+           ../../headers/Metrics.h \
+           ../../headers/Plot.h \
+           ../../headers/QuantizedPoints.h \
+           ../../headers/RadixSort.h \
+           ../../headers/RocHull.h \
+           ../../headers/ScoreSet.h \
+           ../../headers/ScoreSketch.h \
+           ../../headers/ShardMerge.h \
+           ../../headers/SketchBuilder.h
+SOURCES += tst_plot.cpp \
+           ../../sources/AverageUpdater.cpp \
+           ../../sources/BinaryCurve.cpp \
+           ../../sources/Bootstrap.cpp \
+           ../../sources/Curve.cpp \
+           ../../sources/CurveAverage.cpp \
+           ../../sources/CurveBuilder.cpp \
+           ../../sources/CurveCache.cpp \
+           ../../sources/CurveData.cpp \
+           ../../sources/CurveLoader.cpp \
+           ../../sources/CurvePyramid.cpp \
+           ../../sources/CurveRegistry.cpp \
+           ../../sources/CurveTail.cpp \
+           ../../sources/DataParser.cpp \
+           ../../sources/DeLong.cpp \
+           ../../sources/ErrorCodes.cpp \
+           ../../sources/fileProxy.cpp \
+           ../../sources/FunctionData.cpp \
+           ../../sources/Metrics.cpp \
+           ../../sources/Plot.cpp \
+           ../../sources/QuantizedPoints.cpp \
+           ../../sources/RadixSort.cpp \
+           ../../sources/RocHull.cpp \
+           ../../sources/ScoreSet.cpp \
+           ../../sources/ScoreSketch.cpp \
+           ../../sources/ShardMerge.cpp \
+           ../../sources/SketchBuilder.cpp
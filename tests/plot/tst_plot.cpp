@@ -0,0 +1,64 @@
+/**
+ * @file
+ * @author  Szymon Piątek, Mateusz Matuszewski
+ * @version 1.0
+ *
+ * @section LICENSE
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2 of
+ * the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details at
+ * http://www.gnu.org/copyleft/gpl.html
+ *
+ * @section DESCRIPTION
+ *
+ */
+
+
+#include "../../headers/Plot.h"
+#include <QtTest/QtTest>
+#include <qwt_legend.h>
+#include <qwt_legend_item.h>
+#include <qwt_plot_curve.h>
+
+/**
+ * Checks that check boxes of the plot legend show and hide their items.
+ */
+class TestPlot : public QObject {
+	Q_OBJECT
+
+private slots:
+	void legendTogglesItem();
+};
+
+/**
+ * Unchecking the legend item of a curve hides the curve, checking it shows the curve again.
+ * Checking the item of a curve already shown does not change it.
+ */
+void TestPlot::legendTogglesItem()
+{
+	Plot plot(NULL, Plot::ROC_CURVE);
+	QwtPlotCurve *curve = new QwtPlotCurve("curve");
+	curve->attach(&plot);
+
+	QwtLegend *legend = plot.findChild<QwtLegend*>();
+	QVERIFY(legend);
+	QwtLegendItem *item = qobject_cast<QwtLegendItem*>(legend->find(curve));
+	QVERIFY(item);
+
+	item->setChecked(true);
+	QVERIFY(curve->isVisible());
+	item->setChecked(false);
+	QVERIFY(!curve->isVisible());
+	item->setChecked(true);
+	QVERIFY(curve->isVisible());
+}
+
+QTEST_MAIN(TestPlot)
+#include "tst_plot.moc"